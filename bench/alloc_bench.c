@@ -0,0 +1,457 @@
+/*
+ * Microbenchmark de l'allocateur du heap simulé (mini_malloc / mini_free).
+ *
+ * Chaque trace d'allocation est générée une seule fois (graine fixe) puis
+ * rejouée à l'identique pour chaque stratégie de placement, ce qui rend
+ * les résultats comparables d'une stratégie et d'un commit à l'autre.
+ *
+ * Traces :
+ *  - uniform  : tailles uniformes [16, 4096], durées de vie aléatoires
+ *  - powerlaw : tailles Pareto (beaucoup de petits blocs, quelques gros)
+ *  - prodcons : producteur / consommateur, libération FIFO par rafales
+ *  - replay   : événements MEMORY ALLOC/FREE d'un trace.csv
+ *
+ * Usage :
+ *   minios_alloc_bench [--ops N] [--live N] [--seed S]
+ *                      [--trace uniform|powerlaw|prodcons|replay|all]
+ *                      [--replay trace.csv] [--csv resultats.csv]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../src/memory/memory.h"
+
+/* Taille max d'un bloc dans les traces synthétiques. */
+#define BENCH_MAX_BLOCK   (256u * 1024u)
+
+/* Fréquence d'échantillonnage de la fragmentation (memory_get_stats est O(blocs)). */
+#define BENCH_SAMPLE_EVERY 1024
+
+typedef enum { OP_ALLOC = 0, OP_FREE } op_kind_t;
+
+typedef struct bench_op {
+    uint8_t  kind;   // OP_ALLOC / OP_FREE
+    uint32_t slot;   // identifiant de l'allocation
+    uint32_t size;   // taille demandée (OP_ALLOC)
+} bench_op_t;
+
+typedef struct bench_trace {
+    const char *name;
+    bench_op_t *ops;
+    size_t      count;
+    size_t      capacity;
+    uint32_t    slots;   // nombre d'allocations distinctes
+} bench_trace_t;
+
+typedef struct bench_result {
+    double   ops_per_sec;
+    uint64_t p50, p90, p99, p999, max;  // latences en ns
+    size_t   failed;                    // mini_malloc() == NULL
+    double   peak_frag;                 // fragmentation externe max
+    double   peak_util;                 // octets demandés vivants / heap
+} bench_result_t;
+
+
+/************************************************************
+   Générateur pseudo-aléatoire (xorshift64*) — reproductible
+ ************************************************************/
+
+static uint64_t rng_state = 42;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1Dull;
+}
+
+/* Uniforme dans [0, 1). */
+static double rng_unit(void) {
+    return (double)(rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint32_t rng_range(uint32_t lo, uint32_t hi) {
+    return lo + (uint32_t)(rng_next() % (uint64_t)(hi - lo + 1));
+}
+
+
+/************************************************************
+   Construction des traces
+ ************************************************************/
+
+static void trace_push(bench_trace_t *t, op_kind_t kind, uint32_t slot, uint32_t size) {
+    if (t->count == t->capacity) {
+        size_t cap = t->capacity ? t->capacity * 2 : 4096;
+        bench_op_t *ops = realloc(t->ops, cap * sizeof(*ops));
+        if (!ops) {
+            fprintf(stderr, "Erreur : plus de memoire pour la trace %s\n", t->name);
+            exit(1);
+        }
+        t->ops      = ops;
+        t->capacity = cap;
+    }
+    bench_op_t *op = &t->ops[t->count++];
+    op->kind = (uint8_t)kind;
+    op->slot = slot;
+    op->size = size;
+}
+
+static uint32_t size_uniform(void) {
+    return rng_range(16, 4096);
+}
+
+/* Pareto (alpha = 1.3, xm = 16), tronquée à BENCH_MAX_BLOCK. */
+static uint32_t size_powerlaw(void) {
+    double u = rng_unit();
+    double x = 16.0 / pow(1.0 - u, 1.0 / 1.3);
+    if (x > BENCH_MAX_BLOCK) x = BENCH_MAX_BLOCK;
+    return (uint32_t)x;
+}
+
+/* Durées de vie aléatoires : on alloue tant qu'on est sous 'live',
+ * et on libère un bloc vivant tiré au hasard. */
+static void build_random_lifetimes(bench_trace_t *t, size_t nops, uint32_t live,
+                                   uint32_t (*size_fn)(void))
+{
+    uint32_t *alive = malloc((size_t)live * sizeof(*alive));
+    uint32_t  nalive = 0;
+    if (!alive) exit(1);
+
+    for (size_t i = 0; i < nops; ++i) {
+        int do_alloc = (nalive == 0) ||
+                       (nalive < live && rng_unit() < 0.55);
+        if (do_alloc) {
+            uint32_t slot = t->slots++;
+            alive[nalive++] = slot;
+            trace_push(t, OP_ALLOC, slot, size_fn());
+        } else {
+            uint32_t k = (uint32_t)(rng_next() % nalive);
+            trace_push(t, OP_FREE, alive[k], 0);
+            alive[k] = alive[--nalive];
+        }
+    }
+    free(alive);
+}
+
+/* Producteur / consommateur : le producteur pousse des rafales de
+ * messages, le consommateur libère les plus anciens (FIFO). */
+static void build_prodcons(bench_trace_t *t, size_t nops, uint32_t live) {
+    uint32_t *fifo = malloc((size_t)live * sizeof(*fifo));
+    uint32_t  head = 0, len = 0;
+    if (!fifo) exit(1);
+
+    while (t->count < nops) {
+        uint32_t burst = rng_range(1, 64);
+        for (uint32_t b = 0; b < burst && len < live && t->count < nops; ++b) {
+            uint32_t slot = t->slots++;
+            fifo[(head + len) % live] = slot;
+            len++;
+            trace_push(t, OP_ALLOC, slot, rng_unit() < 0.9 ? rng_range(32, 512)
+                                                          : rng_range(4096, 65536));
+        }
+
+        uint32_t drain = rng_range(1, 64);
+        for (uint32_t d = 0; d < drain && len > 0 && t->count < nops; ++d) {
+            trace_push(t, OP_FREE, fifo[head], 0);
+            head = (head + 1) % live;
+            len--;
+        }
+    }
+    free(fifo);
+}
+
+/* Rejeu des événements MEMORY d'un trace.csv. Un FREE est associé à la
+ * dernière allocation vivante de même taille (le CSV ne porte pas
+ * d'adresse). */
+#define REPLAY_BUCKETS 4096
+
+static int build_replay(bench_trace_t *t, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    int32_t  heads[REPLAY_BUCKETS];
+    uint32_t *chain = NULL;     // slot -> slot suivant de même bucket
+    uint32_t *sizes = NULL;     // slot -> taille
+    size_t    cap   = 0;
+    for (int i = 0; i < REPLAY_BUCKETS; ++i) heads[i] = -1;
+
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        /* time,pid,event,state,reason,cpu,queue */
+        char *fields[7] = {0};
+        int   nf = 0;
+        char *c = line;
+        fields[nf++] = c;
+        while (*c && nf < 7) {
+            if (*c == ',') {
+                *c = '\0';
+                fields[nf++] = c + 1;
+            }
+            c++;
+        }
+        if (nf < 5 || strcmp(fields[2], "MEMORY") != 0) continue;
+
+        uint32_t size = (uint32_t)strtoul(fields[4], NULL, 10);
+        if (size == 0) continue;
+        int b = (int)(size % REPLAY_BUCKETS);
+
+        if (strcmp(fields[3], "ALLOC") == 0) {
+            uint32_t slot = t->slots++;
+            if (slot >= cap) {
+                cap = cap ? cap * 2 : 1024;
+                uint32_t *nc = realloc(chain, cap * sizeof(*nc));
+                if (!nc) exit(1);
+                chain = nc;
+                uint32_t *ns = realloc(sizes, cap * sizeof(*ns));
+                if (!ns) exit(1);
+                sizes = ns;
+            }
+            sizes[slot] = size;
+            chain[slot] = (uint32_t)heads[b];
+            heads[b]    = (int32_t)slot;
+            trace_push(t, OP_ALLOC, slot, size);
+        } else if (strcmp(fields[3], "FREE") == 0) {
+            int32_t prev = -1, cur = heads[b];
+            while (cur >= 0 && sizes[cur] != size) {
+                prev = cur;
+                cur  = (int32_t)chain[cur];
+            }
+            if (cur < 0) continue;  // FREE sans ALLOC correspondant
+            if (prev < 0) heads[b] = (int32_t)chain[cur];
+            else          chain[prev] = chain[cur];
+            trace_push(t, OP_FREE, (uint32_t)cur, 0);
+        }
+    }
+
+    free(chain);
+    free(sizes);
+    fclose(f);
+    return 0;
+}
+
+
+/************************************************************
+   Exécution
+ ************************************************************/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t n, double p) {
+    if (n == 0) return 0;
+    size_t k = (size_t)(p * (double)(n - 1));
+    return sorted[k];
+}
+
+static void run_trace(const bench_trace_t *t, memory_strategy_t strat, bench_result_t *r) {
+    memset(r, 0, sizeof(*r));
+
+    void    **ptrs  = calloc(t->slots ? t->slots : 1, sizeof(void*));
+    uint32_t *sizes = calloc(t->slots ? t->slots : 1, sizeof(uint32_t));
+    uint64_t *lat   = malloc((t->count ? t->count : 1) * sizeof(uint64_t));
+    if (!ptrs || !sizes || !lat) exit(1);
+
+    memory_init();
+    memory_set_strategy(strat);
+
+    memory_stats_t st;
+    memory_get_stats(&st);
+    const double heap_size = (double)st.heap_size;
+
+    size_t   live_bytes = 0;
+    uint64_t total_ns   = 0;
+
+    for (size_t i = 0; i < t->count; ++i) {
+        const bench_op_t *op = &t->ops[i];
+        uint64_t t0, t1;
+
+        if (op->kind == OP_ALLOC) {
+            t0 = now_ns();
+            void *p = mini_malloc(op->size);
+            t1 = now_ns();
+            ptrs[op->slot] = p;
+            if (p) {
+                sizes[op->slot] = op->size;
+                live_bytes += op->size;
+            } else {
+                r->failed++;
+            }
+        } else {
+            void *p = ptrs[op->slot];
+            t0 = now_ns();
+            mini_free(p);
+            t1 = now_ns();
+            if (p) live_bytes -= sizes[op->slot];
+            ptrs[op->slot] = NULL;
+        }
+
+        lat[i]    = t1 - t0;
+        total_ns += lat[i];
+
+        if ((double)live_bytes / heap_size > r->peak_util) {
+            r->peak_util = (double)live_bytes / heap_size;
+        }
+        if ((i % BENCH_SAMPLE_EVERY) == 0) {
+            memory_get_stats(&st);
+            if (st.external_frag > r->peak_frag) r->peak_frag = st.external_frag;
+        }
+    }
+
+    memory_get_stats(&st);
+    if (st.external_frag > r->peak_frag) r->peak_frag = st.external_frag;
+
+    qsort(lat, t->count, sizeof(uint64_t), cmp_u64);
+    r->p50  = percentile(lat, t->count, 0.50);
+    r->p90  = percentile(lat, t->count, 0.90);
+    r->p99  = percentile(lat, t->count, 0.99);
+    r->p999 = percentile(lat, t->count, 0.999);
+    r->max  = t->count ? lat[t->count - 1] : 0;
+    r->ops_per_sec = total_ns ? (double)t->count * 1e9 / (double)total_ns : 0.0;
+
+    free(ptrs);
+    free(sizes);
+    free(lat);
+}
+
+
+/************************************************************
+   Main
+ ************************************************************/
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage : %s [--ops N] [--live N] [--seed S]\n"
+            "          [--trace uniform|powerlaw|prodcons|replay|all]\n"
+            "          [--replay trace.csv] [--csv resultats.csv]\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    size_t      nops        = 200000;
+    uint32_t    live        = 8192;
+    uint64_t    seed        = 42;
+    const char *which       = "all";
+    const char *replay_path = NULL;
+    const char *csv_path    = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            nops = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--live") == 0 && i + 1 < argc) {
+            live = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            which = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (nops == 0 || live == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    bench_trace_t traces[4];
+    int ntraces = 0;
+    memset(traces, 0, sizeof(traces));
+    int all = (strcmp(which, "all") == 0);
+
+    if (all || strcmp(which, "uniform") == 0) {
+        rng_state = seed ? seed : 42;
+        traces[ntraces].name = "uniform";
+        build_random_lifetimes(&traces[ntraces++], nops, live, size_uniform);
+    }
+    if (all || strcmp(which, "powerlaw") == 0) {
+        rng_state = seed ? seed : 42;
+        traces[ntraces].name = "powerlaw";
+        build_random_lifetimes(&traces[ntraces++], nops, live, size_powerlaw);
+    }
+    if (all || strcmp(which, "prodcons") == 0) {
+        rng_state = seed ? seed : 42;
+        traces[ntraces].name = "prodcons";
+        build_prodcons(&traces[ntraces++], nops, live);
+    }
+    if ((all && replay_path) || strcmp(which, "replay") == 0) {
+        if (!replay_path) {
+            fprintf(stderr, "--trace replay demande --replay <trace.csv>\n");
+            return 1;
+        }
+        traces[ntraces].name = "replay";
+        if (build_replay(&traces[ntraces], replay_path) != 0) return 1;
+        ntraces++;
+    }
+    if (ntraces == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return 1;
+        }
+        fprintf(csv, "trace,strategy,ops,ops_per_sec,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,"
+                     "failed,peak_frag,peak_util\n");
+    }
+
+    printf("=== miniOS allocator benchmark (seed=%llu, live<=%u) ===\n",
+           (unsigned long long)seed, live);
+    printf("%-9s %-10s %9s %12s %7s %7s %7s %8s %9s %7s %9s %9s\n",
+           "trace", "strategy", "ops", "ops/s", "p50ns", "p90ns", "p99ns",
+           "p99.9ns", "max_ns", "failed", "peak_frag", "peak_util");
+
+    for (int t = 0; t < ntraces; ++t) {
+        for (int s = 0; s < MEM_FIT_COUNT; ++s) {
+            bench_result_t r;
+            run_trace(&traces[t], (memory_strategy_t)s, &r);
+
+            printf("%-9s %-10s %9zu %12.0f %7llu %7llu %7llu %8llu %9llu %7zu %8.1f%% %8.1f%%\n",
+                   traces[t].name, memory_strategy_to_str((memory_strategy_t)s),
+                   traces[t].count, r.ops_per_sec,
+                   (unsigned long long)r.p50, (unsigned long long)r.p90,
+                   (unsigned long long)r.p99, (unsigned long long)r.p999,
+                   (unsigned long long)r.max, r.failed,
+                   r.peak_frag * 100.0, r.peak_util * 100.0);
+
+            if (csv) {
+                fprintf(csv, "%s,%s,%zu,%.0f,%llu,%llu,%llu,%llu,%llu,%zu,%.4f,%.4f\n",
+                        traces[t].name, memory_strategy_to_str((memory_strategy_t)s),
+                        traces[t].count, r.ops_per_sec,
+                        (unsigned long long)r.p50, (unsigned long long)r.p90,
+                        (unsigned long long)r.p99, (unsigned long long)r.p999,
+                        (unsigned long long)r.max, r.failed,
+                        r.peak_frag, r.peak_util);
+            }
+        }
+        free(traces[t].ops);
+    }
+
+    if (csv) fclose(csv);
+    return 0;
+}
@@ -0,0 +1,328 @@
+/*
+ * Stress + passage à l'échelle du heap simulé en mode concurrent.
+ *
+ * Pour 1, 2, 4, ... N threads hôtes, et pour chaque mode :
+ *  - lock  : verrou central seul (memory_set_concurrent(1, 0))
+ *  - cache : caches par thread + dépôts par classe (memory_set_concurrent(1, 1))
+ *
+ * Chaque thread alloue / libère au hasard (80 % de petits blocs), écrit un
+ * motif dans chaque bloc et le vérifie avant de le libérer. Une partie des
+ * blocs est confiée au thread voisin qui les libère ("free distant").
+ * En fin de passe, le heap doit être revenu à zéro bloc utilisé.
+ *
+ * Usage :
+ *   minios_heap_mt_bench [--threads N] [--ops N] [--seed S]
+ *                        [--mode lock|cache|all] [--csv resultats.csv]
+ *
+ * Code de retour non nul en cas de corruption ou de fuite.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../src/memory/memory.h"
+
+#define MT_MAX_THREADS   64
+#define MT_LIVE_SLOTS    512    // blocs vivants max par thread
+#define MT_MAILBOX_SIZE  1024   // blocs en transit vers le voisin
+
+typedef struct mailbox {
+    pthread_mutex_t lock;
+    void*           items[MT_MAILBOX_SIZE];
+    int             count;
+} mailbox_t;
+
+typedef struct worker {
+    pthread_t  thread;
+    int        id;
+    int        nthreads;
+    size_t     ops;
+    uint64_t   rng;
+    size_t     errors;       // motifs corrompus détectés
+    size_t     failed;       // allocations refusées
+} worker_t;
+
+static mailbox_t mailboxes[MT_MAX_THREADS];
+
+/* Barrière de départ simple (les threads partent ensemble). */
+static pthread_mutex_t start_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  start_cond = PTHREAD_COND_INITIALIZER;
+static int             start_flag = 0;
+
+
+/************************************************************
+   Utilitaires
+ ************************************************************/
+
+static uint64_t rng_next(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1Dull;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Motif : premier mot = adresse ^ clé, dernier octet = taille. */
+static void stamp(void *p, size_t size) {
+    uintptr_t v = (uintptr_t)p ^ (uintptr_t)0xA5A5A5A5u;
+    memcpy(p, &v, sizeof(v));
+    ((uint8_t*)p)[size - 1] = (uint8_t)size;
+}
+
+static int check(const void *p, size_t size) {
+    uintptr_t v;
+    memcpy(&v, p, sizeof(v));
+    return v == ((uintptr_t)p ^ (uintptr_t)0xA5A5A5A5u) &&
+           ((const uint8_t*)p)[size - 1] == (uint8_t)size;
+}
+
+/* Bloc vivant d'un thread : pointeur + taille demandée. */
+typedef struct live {
+    void*  ptr;
+    size_t size;
+} live_t;
+
+static void drain_mailbox(worker_t *w) {
+    mailbox_t *mb = &mailboxes[w->id];
+    void *items[MT_MAILBOX_SIZE];
+    int n;
+
+    pthread_mutex_lock(&mb->lock);
+    n = mb->count;
+    memcpy(items, mb->items, (size_t)n * sizeof(void*));
+    mb->count = 0;
+    pthread_mutex_unlock(&mb->lock);
+
+    for (int i = 0; i < n; ++i) {
+        /* Les blocs distants portent leur taille dans le 2e mot. */
+        size_t size;
+        memcpy(&size, (uint8_t*)items[i] + sizeof(uintptr_t), sizeof(size));
+        if (!check(items[i], size)) w->errors++;
+        mini_free(items[i]);
+    }
+}
+
+static void *worker_main(void *arg) {
+    worker_t *w = arg;
+    live_t live[MT_LIVE_SLOTS];
+    memset(live, 0, sizeof(live));
+
+    pthread_mutex_lock(&start_lock);
+    while (!start_flag) pthread_cond_wait(&start_cond, &start_lock);
+    pthread_mutex_unlock(&start_lock);
+
+    for (size_t i = 0; i < w->ops; ++i) {
+        uint64_t r    = rng_next(&w->rng);
+        int      slot = (int)(r % MT_LIVE_SLOTS);
+
+        if (live[slot].ptr) {
+            if (!check(live[slot].ptr, live[slot].size)) w->errors++;
+            mini_free(live[slot].ptr);
+            live[slot].ptr = NULL;
+            continue;
+        }
+
+        size_t size = ((r >> 20) % 10 < 8) ? 16 + (r >> 32) % 241
+                                            : 257 + (r >> 32) % 3840;
+        void *p = mini_malloc(size);
+        if (!p) {
+            w->failed++;
+            continue;
+        }
+        stamp(p, size);
+
+        /* ~1 bloc sur 16 part chez le voisin, qui le libérera. */
+        if (w->nthreads > 1 && size >= 24 && ((r >> 40) & 15) == 0) {
+            memcpy((uint8_t*)p + sizeof(uintptr_t), &size, sizeof(size));
+            ((uint8_t*)p)[size - 1] = (uint8_t)size;
+            mailbox_t *mb = &mailboxes[(w->id + 1) % w->nthreads];
+            pthread_mutex_lock(&mb->lock);
+            if (mb->count < MT_MAILBOX_SIZE) {
+                mb->items[mb->count++] = p;
+                p = NULL;
+            }
+            pthread_mutex_unlock(&mb->lock);
+            if (!p) continue;
+        }
+
+        live[slot].ptr  = p;
+        live[slot].size = size;
+
+        if ((i & 63) == 0) drain_mailbox(w);
+    }
+
+    for (int s = 0; s < MT_LIVE_SLOTS; ++s) {
+        if (live[s].ptr) {
+            if (!check(live[s].ptr, live[s].size)) w->errors++;
+            mini_free(live[s].ptr);
+        }
+    }
+    drain_mailbox(w);
+    return NULL;
+}
+
+
+/************************************************************
+   Une passe : N threads, un mode
+ ************************************************************/
+
+typedef struct pass_result {
+    double ops_per_sec;
+    size_t errors;
+    size_t failed;
+    int    leaked_blocks;
+} pass_result_t;
+
+static void run_pass(int nthreads, int use_cache, size_t ops, uint64_t seed,
+                     pass_result_t *res)
+{
+    worker_t workers[MT_MAX_THREADS];
+    memset(res, 0, sizeof(*res));
+
+    memory_init();
+    memory_set_concurrent(1, use_cache);
+
+    for (int t = 0; t < nthreads; ++t) {
+        pthread_mutex_init(&mailboxes[t].lock, NULL);
+        mailboxes[t].count = 0;
+    }
+
+    start_flag = 0;
+    for (int t = 0; t < nthreads; ++t) {
+        workers[t].id       = t;
+        workers[t].nthreads = nthreads;
+        workers[t].ops      = ops;
+        workers[t].rng      = (seed ? seed : 42) * 0x9E3779B97F4A7C15ull + (uint64_t)t + 1;
+        workers[t].errors   = 0;
+        workers[t].failed   = 0;
+        pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]);
+    }
+
+    uint64_t t0 = now_ns();
+    pthread_mutex_lock(&start_lock);
+    start_flag = 1;
+    pthread_cond_broadcast(&start_cond);
+    pthread_mutex_unlock(&start_lock);
+
+    for (int t = 0; t < nthreads; ++t) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    uint64_t t1 = now_ns();
+
+    /* Un voisin a pu déposer des blocs après le dernier vidage. */
+    for (int t = 0; t < nthreads; ++t) {
+        drain_mailbox(&workers[t]);
+        res->errors += workers[t].errors;
+        res->failed += workers[t].failed;
+        pthread_mutex_destroy(&mailboxes[t].lock);
+    }
+
+    memory_set_concurrent(0, 0);   // rend caches et dépôts au heap
+
+    memory_stats_t st;
+    memory_get_stats(&st);
+    res->leaked_blocks = st.used_blocks;
+    res->ops_per_sec   = (double)ops * nthreads * 1e9 / (double)(t1 - t0);
+}
+
+
+/************************************************************
+   Main
+ ************************************************************/
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage : %s [--threads N] [--ops N] [--seed S]\n"
+            "          [--mode lock|cache|all] [--csv resultats.csv]\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    int         max_threads = 8;
+    size_t      ops         = 200000;
+    uint64_t    seed        = 42;
+    const char *mode        = "all";
+    const char *csv_path    = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            mode = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (max_threads < 1 || max_threads > MT_MAX_THREADS || ops == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int modes[2], nmodes = 0;
+    if (strcmp(mode, "lock") == 0 || strcmp(mode, "all") == 0)  modes[nmodes++] = 0;
+    if (strcmp(mode, "cache") == 0 || strcmp(mode, "all") == 0) modes[nmodes++] = 1;
+    if (nmodes == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return 1;
+        }
+        fprintf(csv, "mode,threads,ops_per_sec,speedup,errors,failed,leaked_blocks\n");
+    }
+
+    printf("=== miniOS concurrent heap benchmark (%zu ops/thread, seed=%llu) ===\n",
+           ops, (unsigned long long)seed);
+    printf("%-6s %7s %14s %8s %7s %7s %7s\n",
+           "mode", "threads", "ops/s", "speedup", "errors", "failed", "leaked");
+
+    int status = 0;
+    for (int m = 0; m < nmodes; ++m) {
+        double base = 0.0;
+        for (int n = 1; n <= max_threads; n *= 2) {
+            pass_result_t r;
+            run_pass(n, modes[m], ops, seed, &r);
+            if (n == 1) base = r.ops_per_sec;
+            double speedup = base > 0.0 ? r.ops_per_sec / base : 0.0;
+
+            printf("%-6s %7d %14.0f %7.2fx %7zu %7zu %7d\n",
+                   modes[m] ? "cache" : "lock", n, r.ops_per_sec, speedup,
+                   r.errors, r.failed, r.leaked_blocks);
+            if (csv) {
+                fprintf(csv, "%s,%d,%.0f,%.3f,%zu,%zu,%d\n",
+                        modes[m] ? "cache" : "lock", n, r.ops_per_sec, speedup,
+                        r.errors, r.failed, r.leaked_blocks);
+            }
+            if (r.errors || r.leaked_blocks) status = 2;
+
+            /* Termine sur max_threads même si ce n'est pas une puissance de 2. */
+            if (n < max_threads && n * 2 > max_threads) n = max_threads / 2;
+        }
+    }
+
+    if (csv) fclose(csv);
+    return status;
+}
@@ -0,0 +1,195 @@
+/*
+ * Coût de trace_event() vu de la simulation.
+ *
+ * Pour chaque format (csv, mtrace, ctrace, ctrace + zlib) et chaque mode
+ * (sync, async), puis en flight recorder (anneau en mémoire, sans
+ * déclencheur : rien n'est écrit), émet N
+ * événements représentatifs (changements d'état + MEMORY avec la taille en
+ * payload) et mesure :
+ *  - emit  : temps passé dans les appels trace_event (ce que paie la simulation)
+ *  - total : emit + trace_close (écriture complète du fichier)
+ *  - taille du fichier et ratio par rapport au CSV
+ *
+ * Avec --mask, les catégories filtrées ne coûtent qu'un test de bit.
+ *
+ * Usage :
+ *   minios_trace_bench [--events N] [--dir /tmp] [--capacity N]
+ *                      [--policy block|drop] [--mask sched,mem,...]
+ *                      [--csv resultats.csv]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/trace/logger.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+typedef struct bench_result {
+    double        emit_s;
+    double        total_s;
+    unsigned long dropped;
+    size_t        high_water;
+    long          bytes;        // taille du fichier produit
+} bench_result_t;
+
+enum { MODE_SYNC, MODE_ASYNC, MODE_FLIGHT };
+
+static const char *const mode_names[] = { "sync", "async", "flight" };
+
+static void run(const char *path, int mode, size_t capacity,
+                trace_full_policy_t policy, long events, bench_result_t *res)
+{
+    static const trace_state_t states[] = { ST_READY, ST_RUNNING, ST_BLOCKED };
+    static const trace_queue_t queues[] = { Q_READY, Q_CPU, Q_BLOCKED };
+
+    memset(res, 0, sizeof(*res));
+
+    uint64_t t0 = now_ns();
+    if (mode == MODE_FLIGHT) {
+        trace_flight_config_t cfg;
+        trace_flight_default_config(&cfg);
+        cfg.capacity = capacity;
+        trace_init_flight(path, &cfg);
+    } else {
+        trace_init(path);
+        if (mode == MODE_ASYNC) trace_start_async(capacity, policy);
+    }
+
+    for (long i = 0; i < events; ++i) {
+        int pid = (int)(i % 97);
+        if ((i & 3) == 3) {
+            TRACE_EVENT(TRACE_CAT_MEM, (int)(i / 4), pid, EV_MEMORY, ST_ALLOC,
+                        RS_VALUE, -1, Q_MEM, 16 + (i * 37) % 4096);
+        } else {
+            TRACE_EVENT(TRACE_CAT_SCHED, (int)(i / 4), pid, EV_STATE_CHANGE, states[i % 3],
+                        RS_NONE, (i % 3 == 1) ? 0 : -1, queues[i % 3], 0);
+        }
+    }
+    uint64_t t1 = now_ns();
+
+    if (mode == MODE_ASYNC) {
+        trace_async_stats_t st;
+        trace_get_async_stats(&st);
+        res->dropped    = st.dropped;
+        res->high_water = st.high_water;
+    }
+    trace_close();
+    uint64_t t2 = now_ns();
+
+    FILE *f = (mode == MODE_FLIGHT) ? NULL : fopen(path, "rb");
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        res->bytes = ftell(f);
+        fclose(f);
+    }
+
+    res->emit_s  = (double)(t1 - t0) / 1e9;
+    res->total_s = (double)(t2 - t0) / 1e9;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage : %s [--events N] [--dir /tmp] [--capacity N]\n"
+            "          [--policy block|drop] [--mask sched,mem,...]\n"
+            "          [--csv resultats.csv]\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    long                events   = 2000000;
+    const char         *dir      = "/tmp";
+    size_t              capacity = TRACE_ASYNC_DEFAULT_CAPACITY;
+    trace_full_policy_t policy   = TRACE_FULL_BLOCK;
+    const char         *csv_path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            events = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            const char *p = argv[++i];
+            if (strcmp(p, "block") == 0)     policy = TRACE_FULL_BLOCK;
+            else if (strcmp(p, "drop") == 0) policy = TRACE_FULL_DROP;
+            else { usage(argv[0]); return 1; }
+        } else if (strcmp(argv[i], "--mask") == 0 && i + 1 < argc) {
+            int mask = trace_parse_mask(argv[++i]);
+            if (mask < 0) { usage(argv[0]); return 1; }
+            trace_set_mask((unsigned)mask);
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (events <= 0 || capacity == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return 1;
+        }
+        fprintf(csv, "format,mode,events,emit_s,total_s,emit_ns_per_event,dropped,high_water,bytes,ratio\n");
+    }
+
+    printf("=== miniOS trace benchmark (%ld events, policy=%s, mask=0x%X) ===\n",
+           events, policy == TRACE_FULL_DROP ? "drop" : "block", trace_get_mask());
+    printf("%-8s %-6s %10s %10s %12s %10s %10s %12s %7s\n",
+           "format", "mode", "emit (s)", "total (s)", "ns/event", "dropped",
+           "high_water", "bytes", "ratio");
+
+    /* ctrace.z : même extension, compression zlib activée */
+    static const struct { const char *name, *ext; int zlib; } formats[] = {
+        { "csv", "csv", 0 }, { "mtrace", "mtrace", 0 },
+        { "ctrace", "ctrace", 0 }, { "ctrace.z", "ctrace", 6 },
+    };
+    long csv_bytes = 0;
+
+    for (int f = 0; f < 4; ++f) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/minios_trace_bench.%s", dir, formats[f].ext);
+        trace_set_compression(formats[f].zlib);
+
+        // Le flight recorder ne dépend pas du format : mesuré une fois (mtrace)
+        int last_mode = (f == 1) ? MODE_FLIGHT : MODE_ASYNC;
+        for (int mode = MODE_SYNC; mode <= last_mode; ++mode) {
+            bench_result_t r;
+            run(path, mode, capacity, policy, events, &r);
+            double ns = r.emit_s * 1e9 / (double)events;
+            if (f == 0 && mode == MODE_SYNC) csv_bytes = r.bytes;
+            double ratio = r.bytes > 0 ? (double)csv_bytes / (double)r.bytes : 0.0;
+
+            printf("%-8s %-6s %10.3f %10.3f %12.1f %10lu %10zu %12ld %6.1fx\n",
+                   formats[f].name, mode_names[mode],
+                   r.emit_s, r.total_s, ns, r.dropped, r.high_water, r.bytes, ratio);
+            if (csv) {
+                fprintf(csv, "%s,%s,%ld,%.6f,%.6f,%.1f,%lu,%zu,%ld,%.2f\n",
+                        formats[f].name, mode_names[mode], events,
+                        r.emit_s, r.total_s, ns, r.dropped, r.high_water, r.bytes, ratio);
+            }
+        }
+        remove(path);
+    }
+    trace_set_compression(0);
+
+    if (csv) fclose(csv);
+    return 0;
+}
@@ -1,18 +1,163 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <ctype.h>
 
 #include "src/process/process.h"
 #include "src/process/scenario.h"
 #include "src/scheduler/scheduler.h"
+#include "src/scheduler/admission.h"
 #include "src/trace/logger.h"
 #include "src/menu/menu.h"
+#include "src/menu/cli.h"
 #include "src/memory/memory.h"
 #include "src/io/io.h"
+#include "src/io/disk.h"
+#include "src/io/nic.h"
+#include "src/workload/workload.h"
+#include "src/workload/replay.h"
+#include "src/workload/workload_file.h"
+#include "src/workload/synth.h"
 
 #define MAX_TASKS 32
 
-int main(void) {
+// Visualisation (Gantt) de la trace : venv du projet sous Windows
+#ifdef _WIN32
+#define GANTT_COMMAND ".\\venv\\Scripts\\python.exe tools/gantt_plotly.py"
+#else
+#define GANTT_COMMAND "python3 tools/gantt_plotly.py"
+#endif
+
+static const char *policy_to_str(SchedulingPolicy p) {
+    switch (p) {
+        case SCHED_ROUND_ROBIN: return "rr";
+        case SCHED_PRIORITY:    return "priority";
+        case SCHED_P_RR:        return "prr";
+        default:                return "?";
+    }
+}
+
+static void launch_gantt(const char *trace) {
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "%s %s", GANTT_COMMAND, trace);
+    if (system(cmd) != 0) {
+        fprintf(stderr, "[System] visualisation indisponible (%s)\n", cmd);
+    }
+}
+
+/* Part du temps où les canaux du périphérique ont servi */
+static double io_utilisation(const io_device_stats_t *io, int ticks) {
+    return ticks > 0 ? (double)io->busy_ticks / ((double)ticks * io->channels) : 0.0;
+}
+
+/* Champ CSV entre guillemets, guillemets internes doublés (RFC 4180) :
+ * un chemin peut contenir des virgules. */
+static void csv_write_quoted(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"') fputc('"', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+/* Bilan du run en CSV : en-tête si le fichier est vide, puis une ligne
+ * (une campagne de runs accumule ses résultats dans un même fichier) */
+static int write_stats(const cli_options_t *opt, const char *source, long processes) {
+    bool  to_stdout = strcmp(opt->stats_path, "-") == 0;
+    FILE *f = to_stdout ? stdout : fopen(opt->stats_path, "a");
+    if (!f) {
+        perror(opt->stats_path);
+        return -1;
+    }
+
+    admission_stats_t adm;
+    admission_get_stats(&adm);
+    const Scheduler *s = &global_scheduler;
+    int ticks = s->current_time;
+
+    if (to_stdout || ftell(f) == 0) {
+        fprintf(f, "source,policy,quantum,cpus,heap,ticks,processes,finished,"
+                   "context_switches,cpu_util,avg_turnaround,avg_response,"
+                   "alloc_failures,mem_waits,oom_kills,rejected");
+        for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+            char name[16];
+            snprintf(name, sizeof(name), "%s", io_device_to_str((io_device_t)d));
+            for (char *c = name; *c; ++c) *c = (char)tolower((unsigned char)*c);
+            fprintf(f, ",%s_util,%s_wait", name, name);
+        }
+        fputs(",disk_sched,disk_avg_seek,disk_merged,aio,aio_submitted,aio_per_reap,"
+              "irq,irq_cpu,irq_interrupts,irq_avg_delay,"
+              "nic,nic_p50,nic_p99,nic_drops,nic_interrupts,nic_polls\n", f);
+    }
+    csv_write_quoted(f, source);
+    fprintf(f, ",%s,%d,%d,%zu,%d,%ld,%d,%d,%.4f,%.2f,%.2f,%d,%d,%d,%d",
+            policy_to_str(opt->policy), opt->quantum, s->cpu_count,
+            memory_heap_size(), ticks, processes, s->finished, s->context_switches,
+            ticks > 0 ? (double)s->busy_ticks / ((double)ticks * s->cpu_count) : 0.0,
+            s->completed ? (double)s->turnaround_total / s->completed : 0.0,
+            s->responded ? (double)s->response_total / s->responded : 0.0,
+            s->alloc_failures, adm.parked, adm.oom_kills, adm.rejected);
+    for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+        io_device_stats_t io;
+        io_get_stats((io_device_t)d, &io);
+        fprintf(f, ",%.4f,%.2f", io_utilisation(&io, ticks),
+                io.requests ? (double)io.wait_ticks / io.requests : 0.0);
+    }
+    disk_stats_t disk;
+    disk_get_stats(&disk);
+    io_aio_stats_t aio;
+    io_get_aio_stats(&aio);
+    io_irq_stats_t irq;
+    io_get_irq_stats(&irq);
+    nic_stats_t nic;
+    nic_get_stats(&nic);
+    fprintf(f, ",%s,%.1f,%ld,%d,%ld,%.2f,%d,%.4f,%ld,%.2f,%s,%d,%d,%ld,%ld,%ld\n",
+            disk_enabled() ? disk_sched_to_str((disk_sched_t)opt->disk_sched) : "fixed",
+            disk.dispatches ? (double)disk.seek_cylinders / disk.dispatches : 0.0,
+            disk.merged, opt->aio ? 1 : 0, aio.submitted,
+            aio.reaps ? (double)aio.reaped / aio.reaps : 0.0,
+            io_irq_enabled() ? 1 : 0,
+            ticks > 0 ? (double)s->irq_ticks / ((double)ticks * s->cpu_count) : 0.0,
+            irq.interrupts,
+            irq.completions ? (double)irq.delay_ticks / irq.completions : 0.0,
+            nic_enabled() ? nic_rx_mode_to_str(opt->nic_config.rx_mode) : "fixed",
+            nic.latency_p50, nic.latency_p99, nic.tx_drops + nic.rx_drops,
+            nic.interrupts, nic.polls);
+
+    if (!to_stdout) fclose(f);
+    return 0;
+}
+
+/* État du heap en CSV : <prefix>.blocks.csv et <prefix>.owners.csv */
+static int write_heap_dump(const char *prefix) {
+    char path[600];
+
+    snprintf(path, sizeof(path), "%s.blocks.csv", prefix);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "miniOS: impossible d'ecrire %s\n", path);
+        return -1;
+    }
+    memory_dump_csv(f);
+    fclose(f);
+
+    snprintf(path, sizeof(path), "%s.owners.csv", prefix);
+    if (!(f = fopen(path, "w"))) {
+        fprintf(stderr, "miniOS: impossible d'ecrire %s\n", path);
+        return -1;
+    }
+    memory_usage_dump_csv(f);
+    fclose(f);
+    return 0;
+}
+
+/* Menu : remplit opt comme le ferait la ligne de commande.
+ * Retourne 0 pour simuler, 1 si la démo a été affichée. */
+static int interactive_options(cli_options_t *opt, char *path, int path_size) {
+    cli_default_options(opt);
+    opt->viz = true;   // sans ligne de commande, l'utilisateur est devant l'écran
 
     /* 0) Menu Principal : Simu ou Démo ? */
     int start_mode = menu_start_choice();
@@ -21,90 +166,268 @@ int main(void) {
         printf("\n[System] Lancement de la visualisation DEMO...\n");
         // On passe le chemin du fichier demo.csv en argument au script python
         // Attention : assure-toi que tools/trace/demo.csv existe bien !
-        system(".\\venv\\Scripts\\python.exe tools/gantt_plotly.py tools/trace/demo.csv");
+        launch_gantt("tools/trace/demo.csv");
 
         // On quitte le programme C proprement ici, on ne fait pas de simulation
-        return 0;
+        return 1;
     }
 
     /* =========================================
        SI ON ARRIVE ICI, C'EST LE MODE SIMULATION
+       (scénario interactif, trace rejouée ou fichier de charge)
        ========================================= */
+    if (start_mode == 3) {
+        menu_choose_trace(path, path_size);
+        opt->workload      = CLI_WORKLOAD_REPLAY;
+        opt->workload_path = path;
+    } else if (start_mode == 4) {
+        menu_choose_workload(path, path_size);
+        opt->workload      = CLI_WORKLOAD_FILE;
+        opt->workload_path = path;
+    } else if (start_mode == 5) {
+        menu_choose_synth(&opt->synth);
+        opt->workload = CLI_WORKLOAD_SYNTH;
+    }
 
     /* 1) Choix de la politique d'ordonnancement */
-    SchedulingPolicy policy = menu_choose_policy();
+    opt->policy  = menu_choose_policy();
+    opt->quantum = 0;
+    if (opt->policy == SCHED_ROUND_ROBIN || opt->policy == SCHED_P_RR) {
+        opt->quantum = menu_choose_quantum();
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    cli_options_t opt;
+    char          menu_path[256] = "";
 
-    int quantum = 0;
-    if (policy == SCHED_ROUND_ROBIN || policy == SCHED_P_RR) {
-        quantum = menu_choose_quantum();
+    if (argc > 1) {
+        int r = cli_parse(argc, argv, &opt);   // mode sans menu
+        if (r != 0) return (r > 0) ? 0 : 1;
+        if (opt.policy == SCHED_PRIORITY) opt.quantum = 0;
+    } else if (interactive_options(&opt, menu_path, (int)sizeof(menu_path)) != 0) {
+        return 0;
+    }
+
+    char source[300];
+    if (opt.workload == CLI_WORKLOAD_SYNTH) {
+        snprintf(source, sizeof(source), "synth (graine %llu)",
+                 (unsigned long long)opt.synth.seed);
+    } else {
+        snprintf(source, sizeof(source), "%s",
+                 opt.workload_path ? opt.workload_path : "scenario");
     }
 
     /* 2) Initialisations globales */
-    memory_init();                                      // heap simulé 64 MiB
+    if (opt.heap_size > 0 && memory_set_heap_size(opt.heap_size) < 0) {
+        fprintf(stderr, "miniOS: heap de %zu octets impossible\n", opt.heap_size);
+        return 1;
+    }
+    if (scheduler_set_cpu_count(opt.cpus) < 0) {
+        fprintf(stderr, "miniOS: nombre de CPU invalide (%d)\n", opt.cpus);
+        return 1;
+    }
+    for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+        if (opt.io_channels[d] > 0) io_set_channels((io_device_t)d, opt.io_channels[d]);
+    }
+    if (opt.disk_sched >= 0) {
+        disk_config_t disk;
+        disk_default_config(&disk);
+        disk.sched = (disk_sched_t)opt.disk_sched;
+        if (opt.disk_merge > 0) disk.max_merge_blocks = opt.disk_merge;
+        disk_set_model(&disk);
+    }
+    nic_set_model(opt.nic ? &opt.nic_config : NULL);
+    io_set_irq_model(opt.irq ? &opt.irq_config : NULL);
+    workload_set_async_io(opt.aio);
+    memory_init();                                      // heap simulé (64 MiB par défaut)
+    io_set_verbose(!opt.quiet);
     io_init();                                          // module I/O
 
-    // On écrit dans le fichier standard trace.csv pour la simulation
-    trace_init("tools/trace/trace.csv");
+    // La trace rejouée est lue en entier avant d'écraser la trace de sortie
+    workload_source_t *workload = NULL;
+    if (opt.workload == CLI_WORKLOAD_REPLAY) {
+        workload = workload_replay_open(opt.workload_path, PRIORITY_MEDIUM);
+    } else if (opt.workload == CLI_WORKLOAD_FILE) {
+        workload = workload_file_open(opt.workload_path);
+    } else if (opt.workload == CLI_WORKLOAD_SYNTH) {
+        workload = workload_synth_open(&opt.synth);
+    }
+    if (opt.workload != CLI_WORKLOAD_SCENARIO && !workload) {
+        return 1;
+    }
+
+    if (opt.flight_path[0]) {
+        trace_set_mask(opt.trace_mask);
+        if (trace_init_flight(opt.flight_path, &opt.flight) < 0) return 1;
+    } else if (opt.trace_path) {
+        trace_set_mask(opt.trace_mask);
+        trace_set_compression(opt.trace_compression);
+        if (opt.trace_format >= 0) {
+            trace_init_format(opt.trace_path, (trace_format_t)opt.trace_format);
+        } else {
+            trace_init(opt.trace_path);
+        }
+        // Encodage + écriture sur un thread dédié (aucun événement perdu)
+        trace_start_async(TRACE_ASYNC_DEFAULT_CAPACITY, TRACE_FULL_BLOCK);
+    }
 
-    scheduler_init(policy, quantum);                    // scheduler
+    scheduler_init(opt.policy, opt.quantum);            // scheduler
+    admission_init(ADMIT_FIFO, OOM_KILL_LARGEST_RSS);   // attente mémoire + OOM
 
     /* 3) Construction du scénario interactif (processus utilisateur) */
     PCB *tasks[MAX_TASKS];
-    int nb_tasks = scenario_build_interactive(tasks, MAX_TASKS, policy);
+    int nb_tasks = 0;
 
-    /* 3 bis) Affichage du heap AVANT l'exécution (avant les free) */
-    memory_dump_with_processes(tasks, nb_tasks);
+    if (!workload) {
+        nb_tasks = scenario_build_interactive(tasks, MAX_TASKS, opt.policy);
+
+        /* 3 bis) Affichage du heap AVANT l'exécution (avant les free) */
+        memory_dump_with_processes();
+    }
 
     /* 4) Boucle de simulation */
-    while (!scheduler_is_finished()) {
+    bool heap_dumped = !opt.heap_dump[0];
+    bool dump_failed = false;
+    while (!scheduler_is_finished() || (workload && workload_pending(workload))) {
+        if (!heap_dumped && global_scheduler.current_time == opt.heap_dump_tick) {
+            dump_failed = write_heap_dump(opt.heap_dump) < 0;
+            heap_dumped = true;
+        }
 
-        // 1) Admission des processus
+        // 1) Admission des processus (charge : créés à leur arrivée)
+        if (workload) {
+            workload_poll(workload, global_scheduler.current_time);
+        }
         for (int i = 0; i < nb_tasks; ++i) {
             PCB *p = tasks[i];
             if (p->state == NEW &&
                 p->arrival_time <= global_scheduler.current_time) {
-                scheduler_add_ready(p);
+                admission_submit(p);
             }
         }
 
-        // 2) Processus courant
-        PCB *cur = global_scheduler.current;
-
-        // 3) Déclenchement éventuel d'une I/O
-        if (cur &&
-            cur->io_device   != -1 &&
-            cur->io_duration > 0 &&
-            !cur->waiting_for_io &&
-            global_scheduler.current_time >= cur->io_start_time)
-        {
-            io_request(cur,
-                       (io_device_t)cur->io_device,
-                       (uint32_t)cur->io_duration,
-                       (uint32_t)global_scheduler.current_time);
-        }
-
-        // 4) Avance d'un tick
+        // 2) Avance d'un tick (les I/O sont lancées par les programmes)
         scheduler_tick();
     }
 
     /* 6) Fin de simulation */
     trace_close();
-    printf("Simulation terminee au temps = %d\n",
-           global_scheduler.current_time);
+    if (!opt.quiet && opt.flight_path[0]) {
+        trace_flight_stats_t fl;
+        trace_get_flight_stats(&fl);
+        printf("[TRACE] flight recorder : %lu evenements, %lu declencheurs, %lu dumps\n",
+               fl.recorded, fl.triggers, fl.dumps);
+    }
+    if (!opt.quiet) {
+        printf("Simulation terminee au temps = %d\n",
+               global_scheduler.current_time);
+    }
+
+    admission_stats_t adm;
+    admission_get_stats(&adm);
+    if (!opt.quiet && (adm.parked > 0 || adm.rejected > 0)) {
+        printf("[Admission] en attente memoire : %d (admis ensuite : %d, "
+               "attente moyenne : %.1f ticks, max simultanes : %d)\n",
+               adm.parked, adm.admitted_late,
+               adm.admitted_late ? (double)adm.wait_ticks / adm.admitted_late : 0.0,
+               adm.max_waiting);
+        printf("[Admission] compactions : %d, OOM kills : %d, rejets : %d\n",
+               adm.compactions, adm.oom_kills, adm.rejected);
+    }
+    if (!opt.quiet) {
+        bool header = false;
+        for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+            io_device_stats_t io;
+            io_get_stats((io_device_t)d, &io);
+            if (io.requests == 0) continue;
+            if (!header) {
+                printf("[IO] peripherique canaux requetes en_file attente_moy attente_max util\n");
+                header = true;
+            }
+            printf("[IO] %-12s %6d %8d %8d %11.2f %11d %5.1f %%\n",
+                   io_device_to_str((io_device_t)d), io.channels, io.requests,
+                   io.queued, (double)io.wait_ticks / io.requests, io.max_wait,
+                   100.0 * io_utilisation(&io, global_scheduler.current_time));
+        }
+    }
+    disk_stats_t disk;
+    disk_get_stats(&disk);
+    if (!opt.quiet && disk_enabled() && disk.dispatches > 0) {
+        double n = (double)disk.dispatches;
+        printf("[Disque] %s : %ld requetes en %ld services (%ld fusionnees, %ld expirees)\n",
+               disk_sched_to_str((disk_sched_t)opt.disk_sched), disk.requests,
+               disk.dispatches, disk.merged, disk.expired);
+        printf("[Disque] par service : seek %.1f cylindres / %.2f ticks, "
+               "rotation %.2f, transfert %.2f\n",
+               disk.seek_cylinders / n, disk.seek_ticks / n,
+               disk.rotation_ticks / n, disk.transfer_ticks / n);
+    }
+    io_aio_stats_t aio;
+    io_get_aio_stats(&aio);
+    if (!opt.quiet && aio.submitted > 0) {
+        printf("[AIO] %ld soumises, %ld terminees ; %ld WAIT dont %ld bloquants, "
+               "%ld anneaux pleins ; %.2f completions par recolte\n",
+               aio.submitted, aio.completed, aio.waits, aio.waits_blocked, aio.ring_full,
+               aio.reaps ? (double)aio.reaped / aio.reaps : 0.0);
+    }
+    nic_stats_t nic;
+    nic_get_stats(&nic);
+    if (!opt.quiet && nic_enabled() && nic.requests > 0) {
+        printf("[Reseau] %s : %ld requetes, %ld reponses (%ld Ko emis, %ld Ko recus)\n",
+               nic_rx_mode_to_str(opt.nic_config.rx_mode), nic.requests, nic.responses,
+               nic.tx_kb, nic.rx_kb);
+        printf("[Reseau] latence moy %.2f, p50 %d, p99 %d, max %d ticks\n",
+               nic.latency_avg, nic.latency_p50, nic.latency_p99, nic.latency_max);
+        printf("[Reseau] pertes TX %ld / RX %ld ; contre-pression TX %ld / RX %ld ; "
+               "%ld interruptions, %ld polls, %ld ticks CPU\n",
+               nic.tx_drops, nic.rx_drops, nic.tx_stalls, nic.rx_stalls,
+               nic.interrupts, nic.polls, nic.cpu_ticks);
+    }
+    io_irq_stats_t irq;
+    io_get_irq_stats(&irq);
+    if (!opt.quiet && irq.interrupts > 0) {
+        printf("[IRQ] %ld interruptions pour %ld completions (%.2f par interruption) ; "
+               "%ld ticks CPU ; delai moyen %.2f ticks (max %d)\n",
+               irq.interrupts, irq.completions, (double)irq.completions / irq.interrupts,
+               global_scheduler.irq_ticks,
+               irq.completions ? (double)irq.delay_ticks / irq.completions : 0.0,
+               irq.max_delay);
+    }
+    if (!opt.quiet && global_scheduler.alloc_failures > 0) {
+        printf("[Memoire] etapes ALLOC en echec : %d\n", global_scheduler.alloc_failures);
+    }
+
+    long processes = workload ? workload->created : nb_tasks;
+    int  status    = (workload && workload->failed) ? 2 : 0;
+    if (opt.stats_path && write_stats(&opt, source, processes) < 0) {
+        status = 1;
+    }
+    /* Dump du heap en fin de simulation (TICK absent ou jamais atteint),
+     * avant que la libération des PCB ne vide le heap */
+    if (!heap_dumped) dump_failed = write_heap_dump(opt.heap_dump) < 0;
+    if (dump_failed) status = 1;
 
     /* Optionnel : état final de la mémoire simulée */
-    memory_dump_with_processes(tasks, nb_tasks);
+    if (workload) {
+        if (!opt.quiet) printf("[Charge] %ld processus crees depuis %s\n", processes, source);
+        workload_close(workload);                       // libère aussi les PCB
+        if (!opt.quiet) memory_dump_with_processes();
+    } else if (!opt.quiet) {
+        memory_dump_with_processes();
+    }
 
     /* Libération des PCB */
     for (int i = 0; i < nb_tasks; ++i) {
-        free(tasks[i]);
+        process_destroy(tasks[i]);
     }
 
     // --- LANCEMENT DU GRAPHIQUE (RESULTAT SIMULATION) ---
-    printf("\n[System] Lancement de l'analyse graphique (Resultats Simulation)...\n");
-
-    // Ici, on passe le fichier trace.csv standard généré par le code C
-    system(".\\venv\\Scripts\\python.exe tools/gantt_plotly.py tools/trace/trace.csv");
+    if (opt.viz && opt.trace_path) {
+        printf("\n[System] Lancement de l'analyse graphique (Resultats Simulation)...\n");
+        launch_gantt(opt.trace_path);
+    }
 
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
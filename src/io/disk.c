@@ -0,0 +1,308 @@
+#include "disk.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/* Requête en file (ordre d'arrivée : la tête de liste est la plus vieille) */
+typedef struct disk_req {
+    void            *cookie;
+    int              lba;
+    int              blocks;
+    int              cyl;
+    int              submitted;
+    struct disk_req *next;
+} disk_req_t;
+
+static bool          enabled;
+static disk_config_t cfg;
+
+static disk_req_t *queue_head, *queue_tail;
+static disk_req_t *free_reqs;
+
+static int head_cyl;        // cylindre sous la tête
+static int head_lba;        // bloc qui suit le dernier transfert
+static int scan_dir = 1;    // SCAN : +1 vers les grands cylindres
+static int batch_left;      // DEADLINE : requêtes restantes du lot
+
+static disk_stats_t stats;
+
+static const char *const sched_names[DISK_SCHED_COUNT] = {
+    "fcfs", "sstf", "scan", "clook", "deadline"
+};
+
+void disk_default_config(disk_config_t *c) {
+    c->sched               = DISK_SCHED_CLOOK;
+    c->cylinders           = 10000;
+    c->tracks_per_cylinder = 4;
+    c->sectors_per_track   = 128;
+    c->rotation_ticks      = 8.0;
+    c->seek_settle         = 1.0;
+    c->seek_full           = 12.0;
+    c->max_merge_blocks    = 256;
+    c->deadline_expire     = 100;
+    c->deadline_batch      = 16;
+}
+
+int disk_set_model(const disk_config_t *c) {
+    if (!c) {
+        enabled = false;
+        return 0;
+    }
+    if (c->sched < 0 || c->sched >= DISK_SCHED_COUNT ||
+        c->cylinders < 1 || c->tracks_per_cylinder < 1 || c->sectors_per_track < 1 ||
+        (int64_t)c->cylinders * c->tracks_per_cylinder * c->sectors_per_track > INT32_MAX ||
+        !(c->rotation_ticks > 0) || c->seek_settle < 0 || c->seek_full < c->seek_settle ||
+        c->max_merge_blocks < 1 || c->deadline_expire < 0 || c->deadline_batch < 1) {
+        return -1;
+    }
+    cfg     = *c;
+    enabled = true;
+    return 0;
+}
+
+bool disk_enabled(void) {
+    return enabled;
+}
+
+int disk_capacity(void) {
+    return cfg.cylinders * cfg.tracks_per_cylinder * cfg.sectors_per_track;
+}
+
+static int cylinder_of(int lba) {
+    return lba / (cfg.tracks_per_cylinder * cfg.sectors_per_track);
+}
+
+void disk_init(void) {
+    while (queue_head) {
+        disk_req_t *r = queue_head;
+        queue_head = r->next;
+        r->next    = free_reqs;
+        free_reqs  = r;
+    }
+    queue_tail = NULL;
+    head_cyl   = 0;
+    head_lba   = 0;
+    scan_dir   = 1;
+    batch_left = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+int disk_zone_of(int pid) {
+    uint32_t h = (uint32_t)pid * 2654435761u;      // hachage de Knuth
+    int      z = (int)(h % (uint32_t)disk_capacity());
+    return z - z % cfg.sectors_per_track;
+}
+
+void disk_enqueue(void *cookie, int lba, int blocks, int now) {
+    disk_req_t *r = free_reqs;
+    if (r) {
+        free_reqs = r->next;
+    } else if (!(r = malloc(sizeof(*r)))) {
+        fprintf(stderr, "[Disque] plus de memoire pour les requetes\n");
+        exit(EXIT_FAILURE);
+    }
+    // Adresse ramenée sur le disque, transfert arrêté au dernier bloc
+    int cap = disk_capacity();
+    lba %= cap;
+    if (lba < 0) lba += cap;
+    if (blocks > cap - lba) blocks = cap - lba;
+    if (blocks < 1) blocks = 1;
+
+    r->cookie    = cookie;
+    r->lba       = lba;
+    r->blocks    = blocks;
+    r->cyl       = cylinder_of(lba);
+    r->submitted = now;
+    r->next      = NULL;
+
+    if (queue_tail) queue_tail->next = r;
+    else            queue_head       = r;
+    queue_tail = r;
+    stats.requests++;
+}
+
+static void unlink_req(disk_req_t *r) {
+    disk_req_t *prev = NULL;
+    for (disk_req_t *q = queue_head; q; prev = q, q = q->next) {
+        if (q != r) continue;
+        if (prev) prev->next = r->next;
+        else      queue_head = r->next;
+        if (queue_tail == r) queue_tail = prev;
+        r->next   = free_reqs;
+        free_reqs = r;
+        return;
+    }
+}
+
+/* ===================================================================== */
+/* ORDONNANCEURS                                                         */
+/* ===================================================================== */
+
+/* Cylindre le plus proche dans la direction dir (0 = les deux) ; à distance
+ * égale, la plus vieille */
+static disk_req_t *nearest(int from, int dir) {
+    disk_req_t *best = NULL;
+    int         bestd = 0;
+    for (disk_req_t *q = queue_head; q; q = q->next) {
+        int d = q->cyl - from;
+        if (dir == 0) d = abs(d);
+        else          d *= dir;
+        if (d < 0) continue;
+        if (!best || d < bestd) {
+            best  = q;
+            bestd = d;
+        }
+    }
+    return best;
+}
+
+/* Requête de plus petit LBA >= from (NULL si aucune) */
+static disk_req_t *next_lba(int from) {
+    disk_req_t *best = NULL;
+    for (disk_req_t *q = queue_head; q; q = q->next) {
+        if (q->lba >= from && (!best || q->lba < best->lba)) best = q;
+    }
+    return best;
+}
+
+/* Choix de la requête ; *dist = cylindres parcourus pour l'atteindre */
+static disk_req_t *pick(int now, long *dist) {
+    disk_req_t *r = NULL;
+
+    switch (cfg.sched) {
+        case DISK_SCHED_FCFS:
+            r = queue_head;
+            break;
+        case DISK_SCHED_SSTF:
+            r = nearest(head_cyl, 0);
+            break;
+        case DISK_SCHED_SCAN:
+            r = nearest(head_cyl, scan_dir);
+            if (!r) {
+                /* Rien devant : le bras va jusqu'au bord puis repart */
+                int edge = scan_dir > 0 ? cfg.cylinders - 1 : 0;
+                scan_dir = -scan_dir;
+                r        = nearest(head_cyl, scan_dir);
+                *dist    = labs((long)edge - head_cyl) + labs((long)edge - r->cyl);
+                return r;
+            }
+            break;
+        case DISK_SCHED_CLOOK:
+            r = nearest(head_cyl, 1);
+            if (!r) r = nearest(0, 1);         // retour à la plus basse demande
+            break;
+        case DISK_SCHED_DEADLINE:
+            if (batch_left <= 0) {
+                batch_left = cfg.deadline_batch;
+                if (now - queue_head->submitted >= cfg.deadline_expire) {
+                    r = queue_head;            // la plus vieille a expiré
+                    stats.expired++;
+                }
+            }
+            if (!r) r = next_lba(head_lba);
+            if (!r) r = next_lba(0);
+            batch_left--;
+            break;
+        default:
+            r = queue_head;
+            break;
+    }
+    *dist = labs((long)r->cyl - head_cyl);
+    return r;
+}
+
+/* ===================================================================== */
+/* SERVICE                                                               */
+/* ===================================================================== */
+
+static double seek_time(long dist) {
+    if (dist == 0) return 0.0;
+    // Accélération puis croisière : croissance en racine de la distance
+    double span = cfg.cylinders > 1 ? (double)(cfg.cylinders - 1) : 1.0;
+    return cfg.seek_settle + (cfg.seek_full - cfg.seek_settle) * sqrt((double)dist / span);
+}
+
+/* Attente du secteur sous la tête, le bras arrivé à l'instant t */
+static double rotation_time(double t, int lba) {
+    double spt    = (double)cfg.sectors_per_track;
+    double angle  = fmod(t, cfg.rotation_ticks) / cfg.rotation_ticks * spt;
+    double sector = (double)(lba % cfg.sectors_per_track);
+    double wait   = sector - angle;
+    if (wait < 0) wait += spt;
+    return wait * cfg.rotation_ticks / spt;
+}
+
+int disk_dispatch(int now, void **cookies, int max, int *count) {
+    *count = 0;
+    if (!queue_head || max < 1) return -1;
+
+    long        dist;
+    disk_req_t *r     = pick(now, &dist);
+    int         start = r->lba;
+    int         end   = r->lba + r->blocks;
+
+    cookies[(*count)++] = r->cookie;
+    unlink_req(r);
+
+    /* Fusion des requêtes contiguës (avant ou après le groupe) */
+    bool grown = true;
+    while (grown && *count < max) {
+        grown = false;
+        for (disk_req_t *q = queue_head; q; q = q->next) {
+            if (end - start + q->blocks > cfg.max_merge_blocks) continue;
+            if (q->lba == end)                  end   += q->blocks;
+            else if (q->lba + q->blocks == start) start  = q->lba;
+            else continue;
+
+            cookies[(*count)++] = q->cookie;
+            stats.merged++;
+            unlink_req(q);
+            grown = true;
+            break;
+        }
+    }
+
+    double seek     = seek_time(dist);
+    double rot      = rotation_time(now + seek, start);
+    double transfer = (double)(end - start) * cfg.rotation_ticks / cfg.sectors_per_track;
+
+    stats.dispatches++;
+    stats.seek_cylinders += dist;
+    stats.seek_ticks     += seek;
+    stats.rotation_ticks += rot;
+    stats.transfer_ticks += transfer;
+
+    head_cyl = cylinder_of(end - 1);
+    head_lba = end;
+
+    int ticks = (int)ceil(seek + rot + transfer - 1e-9);
+    return ticks < 1 ? 1 : ticks;
+}
+
+bool disk_cancel(void *cookie) {
+    for (disk_req_t *q = queue_head; q; q = q->next) {
+        if (q->cookie == cookie) {
+            unlink_req(q);
+            return true;
+        }
+    }
+    return false;
+}
+
+void disk_get_stats(disk_stats_t *out) {
+    *out = stats;
+}
+
+const char *disk_sched_to_str(disk_sched_t s) {
+    return (s >= 0 && s < DISK_SCHED_COUNT) ? sched_names[s] : "?";
+}
+
+int disk_sched_from_str(const char *name) {
+    for (int s = 0; s < DISK_SCHED_COUNT; ++s) {
+        if (strcmp(name, sched_names[s]) == 0) return s;
+    }
+    return -1;
+}
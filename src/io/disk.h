@@ -0,0 +1,98 @@
+#ifndef MINIOS_DISK_H
+#define MINIOS_DISK_H
+
+#include <stdbool.h>
+
+/*
+ * Modèle de disque (IO_DEVICE_DISK) : un bras unique, des requêtes
+ * adressées en blocs (LBA), servies une à la fois dans l'ordre choisi par
+ * un ordonnanceur d'E/S. Le temps de service d'une requête est
+ *
+ *     seek (distance en cylindres) + latence de rotation + transfert
+ *
+ * arrondi au tick supérieur. Sans modèle (défaut), une I/O disque dure
+ * simplement sa durée, comme les autres périphériques.
+ *
+ * Avec le modèle, la durée d'une étape IO(DISK, n) est un nombre de blocs.
+ * Géométrie : lba -> cylindre = lba / (secteurs par piste * pistes par
+ * cylindre), secteur = lba % secteurs par piste.
+ */
+
+typedef enum {
+    DISK_SCHED_FCFS = 0,    // ordre d'arrivée
+    DISK_SCHED_SSTF,        // cylindre le plus proche de la tête
+    DISK_SCHED_SCAN,        // ascenseur : va jusqu'au bord avant de repartir
+    DISK_SCHED_CLOOK,       // montée seule, retour direct à la plus basse demande
+    DISK_SCHED_DEADLINE,    // lots triés par LBA, la plus vieille si elle a expiré
+    DISK_SCHED_COUNT
+} disk_sched_t;
+
+typedef struct disk_config {
+    disk_sched_t sched;
+    int    cylinders;
+    int    tracks_per_cylinder;   // surfaces
+    int    sectors_per_track;     // blocs par piste
+    double rotation_ticks;        // durée d'un tour
+    double seek_settle;           // seek d'un cylindre (ticks)
+    double seek_full;             // seek d'un bord à l'autre (ticks)
+    int    max_merge_blocks;      // taille max d'un groupe fusionné (1 = pas de fusion)
+    int    deadline_expire;       // DEADLINE : âge (ticks) au-delà duquel une requête passe devant
+    int    deadline_batch;        // DEADLINE : requêtes servies par lot avant de revoir les expirations
+} disk_config_t;
+
+typedef struct disk_stats {
+    long   requests;
+    long   dispatches;       // services (un groupe fusionné compte pour un)
+    long   merged;           // requêtes servies dans le groupe d'une autre
+    long   expired;          // DEADLINE : requêtes servies parce qu'expirées
+    long   seek_cylinders;   // distance parcourue par le bras
+    double seek_ticks;
+    double rotation_ticks;
+    double transfer_ticks;
+} disk_stats_t;
+
+/* Un tick ~ 1 ms : 10000 cylindres x 4 pistes x 128 blocs, 7500 tr/min
+ * (8 ticks par tour), seek 1 à 12 ticks, fusion jusqu'à 256 blocs,
+ * DEADLINE 100 ticks / lots de 16, ordonnanceur C-LOOK. */
+void disk_default_config(disk_config_t *cfg);
+
+/**
+ * Active le modèle (cfg copiée) ou le coupe (NULL : durées fixes), à
+ * appeler avant io_init. -1 si la configuration est invalide.
+ */
+int disk_set_model(const disk_config_t *cfg);
+
+bool disk_enabled(void);
+
+/* Tête au cylindre 0, file vide, bilan à zéro (appelé par io_init). */
+void disk_init(void);
+
+/* Nombre de blocs adressables. */
+int disk_capacity(void);
+
+/* Bloc de départ de la zone d'un processus (I/O sans adresse explicite). */
+int disk_zone_of(int pid);
+
+/* Met en file une requête de blocks blocs à partir de lba ; cookie identifie
+ * la requête pour l'appelant. */
+void disk_enqueue(void *cookie, int lba, int blocks, int now);
+
+/**
+ * Choisit la prochaine requête, y fusionne les requêtes contiguës en file
+ * et déplace le bras. Remplit cookies (au plus max, la requête choisie en
+ * premier) et retourne le temps de service du groupe en ticks (>= 1),
+ * ou -1 si la file est vide.
+ */
+int disk_dispatch(int now, void **cookies, int max, int *count);
+
+/* Retire une requête encore en file. true si trouvée. */
+bool disk_cancel(void *cookie);
+
+void disk_get_stats(disk_stats_t *out);
+
+const char *disk_sched_to_str(disk_sched_t s);
+
+/* Inverse de disk_sched_to_str (fcfs, sstf, scan, clook, deadline). -1 si inconnu. */
+int disk_sched_from_str(const char *name);
+
+#endif // MINIOS_DISK_H
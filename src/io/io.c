@@ -1,44 +1,185 @@
 #include "io.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
 
+#include "disk.h"
+#include "nic.h"
 #include "../scheduler/scheduler.h"
-#include "../sync/mutex.h"
-#include "../sync/semaphore.h"
+#include "../trace/logger.h"
 
-/* 2 mutex + 4 sémaphores :
+/* Chaque périphérique a un nombre de canaux (requêtes servies en même
+ * temps) et une file FIFO des requêtes qui attendent un canal libre :
  *
- * - Mutex :
- *     PRINTER -> g_mutex_printer
- *     SCREEN  -> g_mutex_screen
+ *     PRINTER 1, KEYBOARD 1, MOUSE 2, DISK 2, SCREEN 1, NETWORK 3
  *
- * - Sémaphores :
- *     KEYBOARD -> g_sem_keyboard (binaire, value = 1)
- *     MOUSE    -> g_sem_mouse    (value = 2)
- *     DISK     -> g_sem_disk     (value = 2)
- *     NETWORK  -> g_sem_network  (value = 3)
+ * Les requêtes en service sont chaînées dans l'ordre où elles ont démarré,
+ * tous périphériques confondus : c'est l'ordre des réveils d'un même tick.
+ *
+ * Avec le modèle de disque (disk.h), le DISK a un seul canal (le bras) :
+ * disk.c choisit la requête servie, éventuellement fusionnée avec des
+ * requêtes contiguës (un groupe occupe le canal, son chef le rend), et en
+ * calcule la durée. La file du périphérique garde les mêmes requêtes dans
+ * l'ordre d'arrivée (bilan, abandon).
+ *
+ * Avec le modèle de carte réseau (nic.h), une requête NETWORK est en
+ * service du moment où elle entre dans l'anneau TX à celui où sa réponse
+ * est livrée par nic.c ; sa fin n'est pas connue d'avance. La file du
+ * périphérique garde les requêtes refusées par l'anneau (contre-pression)
+ * et le NETWORK affiche la taille de l'anneau comme nombre de canaux.
+ *
+ * Avec le modèle d'interruptions, une requête terminée rend son canal
+ * tout de suite mais passe dans la liste des complétions en attente de
+ * son périphérique ; quand il interrompt, le lot entier passe dans la
+ * liste des traitements, avec la date de fin du traitement sur son CPU.
  */
 
-static Mutex     g_mutex_printer;
-static Mutex     g_mutex_screen;
+typedef struct io_req {
+    PCB           *proc;
+    io_device_t    dev;
+    int            duration;
+    int            submitted;   // io_request
+    int            started;     // prise d'un canal
+    int            done;        // fin de service (started + duration)
+    int            lba;         // DISK avec modèle : bloc de départ
+    bool           holds_channel; // rend le canal à la fin (faux : fusionnée dans un groupe)
+    bool           async;       // SUBMIT : le processus n'est pas bloqué
+    int            deliver_at;  // modèle d'interruptions : fin du traitement
+    struct io_req *next;
+} io_req_t;
+
+typedef struct io_device_state {
+    int       channels;
+    int       busy;
+    io_req_t *head, *tail;      // file d'attente
+    int       queued;           // longueur de la file
+    io_req_t *irq_head, *irq_tail; // terminées, en attente de l'interruption
+    int       irq_count;
+    io_device_stats_t stats;
+} io_device_state_t;
+
+static int channel_config[IO_DEVICE_COUNT] = { 1, 1, 2, 2, 1, 3 };
 
-static Semaphore g_sem_keyboard;   // binaire
-static Semaphore g_sem_mouse;
-static Semaphore g_sem_disk;
-static Semaphore g_sem_network;
+static io_device_state_t devices[IO_DEVICE_COUNT];
+static io_req_t *in_service_head, *in_service_tail;
+static io_req_t *free_reqs;     // recyclage (mémoire hôte, pas le heap simulé)
+static io_aio_stats_t aio_stats;
+
+static bool            irq_enabled;
+static io_irq_config_t irq_cfg;
+static io_irq_stats_t  irq_stats;
+static io_req_t       *handler_head, *handler_tail;  // interruptions en traitement
+
+/* Messages [IO] sur la sortie standard */
+static bool io_verbose = true;
+
+static io_req_t *req_new(void) {
+    io_req_t *r = free_reqs;
+    if (r) {
+        free_reqs = r->next;
+    } else {
+        r = malloc(sizeof(*r));
+        if (!r) {
+            fprintf(stderr, "[IO] plus de memoire pour les requetes\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    memset(r, 0, sizeof(*r));
+    r->started       = -1;
+    r->holds_channel = true;
+    return r;
+}
+
+static void req_release(io_req_t *r) {
+    r->next   = free_reqs;
+    free_reqs = r;
+}
+
+static void release_list(io_req_t *r) {
+    while (r) {
+        io_req_t *next = r->next;
+        req_release(r);
+        r = next;
+    }
+}
 
 void io_init(void) {
-    /* Init des mutex */
-    mutex_init(&g_mutex_printer);
-    mutex_init(&g_mutex_screen);
+    /* Requêtes d'une simulation précédente : recyclées */
+    for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+        release_list(devices[d].head);
+        release_list(devices[d].irq_head);
+    }
+    release_list(in_service_head);
+    release_list(handler_head);
+    in_service_head = in_service_tail = NULL;
+    handler_head    = handler_tail    = NULL;
+    memset(&aio_stats, 0, sizeof(aio_stats));
+    memset(&irq_stats, 0, sizeof(irq_stats));
+
+    memset(devices, 0, sizeof(devices));
+    for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+        devices[d].channels       = channel_config[d];
+        devices[d].stats.channels = channel_config[d];
+    }
+    disk_init();
+    if (disk_enabled()) {
+        devices[IO_DEVICE_DISK].channels       = 1;
+        devices[IO_DEVICE_DISK].stats.channels = 1;
+    }
+    nic_init();
+    if (nic_enabled()) {
+        devices[IO_DEVICE_NETWORK].channels       = nic_tx_ring();
+        devices[IO_DEVICE_NETWORK].stats.channels = nic_tx_ring();
+    }
+
+    if (io_verbose) {
+        printf("[IO] Init : canaux PRINTER %d, KEYBOARD %d, MOUSE %d, "
+               "DISK %d, SCREEN %d, NETWORK %d.\n",
+               devices[IO_DEVICE_PRINTER].channels, devices[IO_DEVICE_KEYBOARD].channels,
+               devices[IO_DEVICE_MOUSE].channels,   devices[IO_DEVICE_DISK].channels,
+               devices[IO_DEVICE_SCREEN].channels,  devices[IO_DEVICE_NETWORK].channels);
+    }
+}
+
+void io_set_verbose(bool on) {
+    io_verbose = on;
+}
 
-    /* Init des sémaphores */
-    semaphore_init(&g_sem_keyboard, 1); // binaire
-    semaphore_init(&g_sem_mouse,   2);
-    semaphore_init(&g_sem_disk,    2);
-    semaphore_init(&g_sem_network, 3);
+int io_set_channels(io_device_t dev, int channels) {
+    if (dev < 0 || dev >= IO_DEVICE_COUNT) return -1;
+    if (channels < 1 || channels > IO_MAX_CHANNELS) return -1;
+    channel_config[dev] = channels;
+    return 0;
+}
 
-    printf("[IO] Init : PRINTER/SCREEN avec mutex, "
-           "KEYBOARD(binaire)/MOUSE/DISK/NETWORK avec semaphores.\n");
+void io_irq_default_config(io_irq_config_t *c) {
+    c->top_half       = 1;
+    c->bottom_half    = 1;
+    c->coalesce_count = 1;
+    c->coalesce_ticks = 0;
+}
+
+int io_set_irq_model(const io_irq_config_t *c) {
+    if (!c) {
+        irq_enabled = false;
+        return 0;
+    }
+    if (c->top_half < 0 || c->bottom_half < 0 ||
+        c->coalesce_count < 1 || c->coalesce_ticks < 0) {
+        return -1;
+    }
+    irq_cfg     = *c;
+    irq_enabled = true;
+    return 0;
+}
+
+bool io_irq_enabled(void) {
+    return irq_enabled;
+}
+
+void io_get_irq_stats(io_irq_stats_t *out) {
+    *out = irq_stats;
 }
 
 const char* io_device_to_str(io_device_t dev) {
@@ -53,107 +194,529 @@ const char* io_device_to_str(io_device_t dev) {
     }
 }
 
-/* Petite fonction interne : "prendre" logiquement la ressource
- * associée au périphérique.
- *
- * On utilise les mutex / sémaphores en mode "anonyme" (current == NULL)
- * pour ne pas interférer avec le scheduler (blocage / FILE BLOCKED).
- */
-static void io_acquire_device(io_device_t dev) {
-    switch (dev) {
-        case IO_DEVICE_PRINTER:
-            mutex_lock(&g_mutex_printer, NULL);
-            break;
-        case IO_DEVICE_SCREEN:
-            mutex_lock(&g_mutex_screen, NULL);
-            break;
-        case IO_DEVICE_KEYBOARD:
-            semaphore_wait(&g_sem_keyboard, NULL);
-            break;
-        case IO_DEVICE_MOUSE:
-            semaphore_wait(&g_sem_mouse, NULL);
-            break;
-        case IO_DEVICE_DISK:
-            semaphore_wait(&g_sem_disk, NULL);
-            break;
-        case IO_DEVICE_NETWORK:
-            semaphore_wait(&g_sem_network, NULL);
-            break;
-        default:
-            break;
-    }
-}
-
-/* Et réciproquement, libérer la ressource à la fin de l'I/O */
-static void io_release_device(io_device_t dev) {
-    switch (dev) {
-        case IO_DEVICE_PRINTER:
-            mutex_unlock(&g_mutex_printer, NULL);
-            break;
-        case IO_DEVICE_SCREEN:
-            mutex_unlock(&g_mutex_screen, NULL);
-            break;
-        case IO_DEVICE_KEYBOARD:
-            semaphore_signal(&g_sem_keyboard);
-            break;
-        case IO_DEVICE_MOUSE:
-            semaphore_signal(&g_sem_mouse);
-            break;
-        case IO_DEVICE_DISK:
-            semaphore_signal(&g_sem_disk);
-            break;
-        case IO_DEVICE_NETWORK:
-            semaphore_signal(&g_sem_network);
-            break;
-        default:
-            break;
+int io_device_from_str(const char *name) {
+    for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+        const char *ref = io_device_to_str((io_device_t)d);
+        const char *s   = name;
+
+        while (*s && *ref && toupper((unsigned char)*s) == *ref) {
+            s++;
+            ref++;
+        }
+        if (*s == '\0' && *ref == '\0') return d;
+    }
+    return -1;
+}
+
+/* Prise d'un canal : le processus est servi à partir de now */
+static void start_service(io_req_t *r, int now) {
+    io_device_state_t *d    = &devices[r->dev];
+    int                wait = now - r->submitted;
+
+    r->started = now;
+    r->done    = now + r->duration;
+    r->proc->blocked_until = r->done;
+
+    d->stats.wait_ticks += wait;
+    if (wait > d->stats.max_wait) d->stats.max_wait = wait;
+
+    r->next = NULL;
+    if (in_service_tail) in_service_tail->next = r;
+    else                 in_service_head       = r;
+    in_service_tail = r;
+}
+
+static void queue_push(io_device_state_t *d, io_req_t *r) {
+    r->next = NULL;
+    if (d->tail) d->tail->next = r;
+    else         d->head       = r;
+    d->tail = r;
+    d->queued++;
+}
+
+static void queue_unlink(io_device_state_t *d, io_req_t *r) {
+    io_req_t *prev = NULL;
+    for (io_req_t *q = d->head; q; prev = q, q = q->next) {
+        if (q != r) continue;
+        if (prev) prev->next = r->next;
+        else      d->head    = r->next;
+        if (d->tail == r) d->tail = prev;
+        d->queued--;
+        return;
+    }
+}
+
+/* Début de service d'une requête qui attendait en file (une requête
+ * asynchrone ne change pas l'état du processus) */
+static void traced_start(io_req_t *r, int now) {
+    if (r->async) return;
+    if (io_verbose && r->done == PCB_BLOCKED_FOREVER) {
+        printf("[IO] P%d -> envoi de %d Ko sur %s apres %d ticks de file\n",
+               r->proc->pid, r->duration, io_device_to_str(r->dev), now - r->submitted);
+    } else if (io_verbose) {
+        printf("[IO] P%d -> I/O sur %s apres %d ticks de file (reveil @ %d)\n",
+               r->proc->pid, io_device_to_str(r->dev), now - r->submitted, r->done);
+    }
+    TRACE_EVENT(TRACE_CAT_SCHED, now, r->proc->pid,
+                EV_STATE_CHANGE, ST_BLOCKED, RS_IO,
+                -1, Q_IO_FIRST + r->dev, 0);
+}
+
+/* Modèle de disque : le bras libre prend le groupe choisi par disk.c.
+ * La requête fresh (celle qu'on soumet) n'était pas encore en file. */
+static void disk_serve(int now, io_req_t *fresh) {
+    io_device_state_t *d = &devices[IO_DEVICE_DISK];
+    void              *group[64];
+    int                n;
+
+    while (d->busy < d->channels) {
+        int ticks = disk_dispatch(now, group, (int)(sizeof(group) / sizeof(group[0])), &n);
+        if (ticks < 0) return;
+
+        d->busy++;
+        for (int k = 0; k < n; ++k) {
+            io_req_t *r = group[k];
+            if (r != fresh) queue_unlink(d, r);
+            r->duration      = ticks;
+            r->holds_channel = (k == 0);
+            start_service(r, now);
+            if (r != fresh) traced_start(r, now);
+        }
     }
 }
 
+/* Modèle de carte réseau : requête acceptée par l'anneau TX (nic_send) ;
+ * sa fin sera fixée à la livraison de la réponse. */
+static void nic_started(io_req_t *r, int now) {
+    start_service(r, now);
+    r->done                = PCB_BLOCKED_FOREVER;
+    r->proc->blocked_until = PCB_BLOCKED_FOREVER;
+    r->holds_channel       = false;         // l'anneau est géré par nic.c
+}
+
+/* Requête de proc sur dev : servie tout de suite si un canal est libre
+ * (disque modélisé : si l'ordonnanceur du disque la choisit ; réseau
+ * modélisé : si l'anneau TX a de la place), sinon mise en file. Retourne la requête ; r->started < 0 si elle attend. */
+static io_req_t *submit(PCB *proc, io_device_t dev, uint32_t duration, int lba,
+                        uint32_t now, bool async) {
+    io_device_state_t *d = &devices[dev];
+    io_req_t          *r = req_new();
+
+    r->proc      = proc;
+    r->dev       = dev;
+    r->duration  = (int)duration;
+    r->submitted = (int)now;
+    r->async     = async;
+    d->stats.requests++;
+
+    if (dev == IO_DEVICE_DISK && disk_enabled()) {
+        if (lba < 0) {
+            if (proc->disk_lba < 0) proc->disk_lba = disk_zone_of(proc->pid);
+            lba = proc->disk_lba;
+        }
+        proc->disk_lba = (int)(((long long)lba + duration) % disk_capacity());
+        r->lba = lba;
+        disk_enqueue(r, lba, (int)duration, (int)now);
+        disk_serve((int)now, r);
+    } else if (dev == IO_DEVICE_NETWORK && nic_enabled()) {
+        // derrière celles déjà en file
+        if (!d->head && nic_send(r, r->duration, r->submitted, (int)now)) {
+            nic_started(r, (int)now);
+        }
+    } else if (d->busy < d->channels) {
+        d->busy++;
+        start_service(r, (int)now);
+    }
+
+    if (r->started < 0) {
+        queue_push(d, r);
+        d->stats.queued++;
+        if (d->queued > d->stats.max_queue) d->stats.max_queue = d->queued;
+    }
+    return r;
+}
+
 void io_request(PCB *proc, io_device_t dev,
-                uint32_t duration, uint32_t now)
+                uint32_t duration, int lba, uint32_t now)
 {
     if (!proc) return;
+    if (dev < 0 || dev >= IO_DEVICE_COUNT) return;
 
-    int wake_time = (int)(now + duration);
-
-    /* 1) On "prend" logiquement la ressource associée */
-    io_acquire_device(dev);
-
-    /* 2) On marque l'état I/O dans le PCB */
+    /* 1) On marque l'état I/O dans le PCB */
     proc->waiting_for_io = true;
-    proc->blocked_until  = wake_time;
     proc->io_device      = (int)dev;
 
-    printf("[IO] P%d -> I/O sur %s pour %u ticks (reveil @ %d)\n",
-           proc->pid, io_device_to_str(dev), duration, wake_time);
+    /* 2) Canal libre : service immédiat, sinon file du périphérique */
+    io_req_t *r = submit(proc, dev, duration, lba, now, false);
 
-    /* 3) On bloque le processus via le scheduler */
-    scheduler_block(proc, "io", "IO");
+    if (r->started >= 0) {
+        if (io_verbose && r->done == PCB_BLOCKED_FOREVER) {
+            printf("[IO] P%d -> envoi de %d Ko sur %s\n",
+                   proc->pid, r->duration, io_device_to_str(dev));
+        } else if (io_verbose) {
+            printf("[IO] P%d -> I/O sur %s pour %d ticks (reveil @ %d)\n",
+                   proc->pid, io_device_to_str(dev), r->duration, r->done);
+        }
+        scheduler_block(proc, RS_IO, (trace_queue_t)(Q_IO_FIRST + dev));
+        return;
+    }
+
+    proc->blocked_until = PCB_BLOCKED_FOREVER;
+    if (io_verbose) {
+        printf("[IO] P%d -> %s occupe, en file (position %d)\n",
+               proc->pid, io_device_to_str(dev), devices[dev].queued);
+    }
+    scheduler_block(proc, RS_IO_QUEUE, (trace_queue_t)(Q_IO_FIRST + dev));
 }
 
-void io_update(uint32_t now) {
-    (void)now;
-    // Tu peux laisser vide : les réveils sont gérés par scheduler_tick()
+/* ===================================================================== */
+/* I/O ASYNCHRONES                                                       */
+/* ===================================================================== */
+
+/* Complétions disponibles consommées par proc */
+static int reap(PCB *proc) {
+    int n = proc->aio_ready;
+    if (n > 0) {
+        proc->aio_ready = 0;
+        aio_stats.reaps++;
+        aio_stats.reaped += n;
+    }
+    return n;
 }
 
-/* Appelé par le scheduler lorsque l'I/O est terminée
- * (au moment où on passe de BLOCKED à READY).
- */
-void io_release_resource_for(PCB *proc) {
-    if (!proc) return;
-    if (!proc->waiting_for_io) return;
-    if (proc->io_device < 0 || proc->io_device >= IO_DEVICE_COUNT) return;
+/* proc s'endort jusqu'à avoir want complétions disponibles */
+static void aio_sleep(PCB *proc, int want) {
+    proc->aio_wait_for  = want;
+    proc->blocked_until = PCB_BLOCKED_FOREVER;
+    aio_stats.waits_blocked++;
+    scheduler_block(proc, RS_AIO_WAIT, Q_BLOCKED);
+}
+
+bool io_submit_async(PCB *proc, io_device_t dev,
+                     uint32_t duration, int lba, uint32_t now)
+{
+    if (!proc || dev < 0 || dev >= IO_DEVICE_COUNT) return true;
+
+    /* Anneau plein : les complétions en attente libèrent des entrées,
+     * sinon il faut attendre la prochaine */
+    if (proc->aio_inflight + proc->aio_ready >= IO_AIO_RING_ENTRIES && reap(proc) == 0) {
+        aio_stats.ring_full++;
+        aio_sleep(proc, 1);
+        return false;
+    }
+
+    io_req_t *r = submit(proc, dev, duration, lba, now, true);
+    proc->aio_inflight++;
+    aio_stats.submitted++;
+
+    if (io_verbose) {
+        if (r->started >= 0 && r->done == PCB_BLOCKED_FOREVER) {
+            printf("[IO] P%d -> envoi asynchrone de %d Ko sur %s\n",
+                   proc->pid, r->duration, io_device_to_str(dev));
+        } else if (r->started >= 0) {
+            printf("[IO] P%d -> I/O asynchrone sur %s (fin @ %d)\n",
+                   proc->pid, io_device_to_str(dev), r->done);
+        } else {
+            printf("[IO] P%d -> I/O asynchrone sur %s en file\n",
+                   proc->pid, io_device_to_str(dev));
+        }
+    }
+    return true;
+}
+
+bool io_wait_async(PCB *proc, int min_complete) {
+    if (!proc) return false;
+
+    int outstanding = proc->aio_inflight + proc->aio_ready;
+    int want = (min_complete <= 0 || min_complete > outstanding) ? outstanding : min_complete;
+
+    aio_stats.waits++;
+    if (proc->aio_ready >= want) {
+        reap(proc);
+        return false;
+    }
+    aio_sleep(proc, want);
+    return true;
+}
+
+int io_reap_async(PCB *proc) {
+    return proc ? reap(proc) : 0;
+}
+
+/* Complétion d'une requête asynchrone : file de complétion de proc, réveil
+ * s'il attendait (une seule fois par tick, les complétions suivantes du
+ * même tick sont récoltées avec) */
+static void complete_async(PCB *p, int now) {
+    p->aio_inflight--;
+    p->aio_ready++;
+    aio_stats.completed++;
+
+    if (p->aio_wait_for <= 0 || p->aio_ready < p->aio_wait_for) return;
+
+    p->aio_wait_for  = 0;
+    p->blocked_until = -1;
+    pcb_queue_remove(&global_scheduler.blocked_queue, p);
+    reap(p);
+
+    // WAIT final : plus rien à calculer, le processus se termine
+    if (p->remaining_time <= 0) {
+        scheduler_terminate(p);
+        return;
+    }
+    p->state = READY;
+    TRACE_EVENT(TRACE_CAT_IO, now, p->pid,
+                EV_UNBLOCKED, ST_READY, RS_AIO_WAIT,
+                -1, Q_READY, 0);
+    scheduler_add_ready(p);
+}
+
+void io_get_aio_stats(io_aio_stats_t *out) {
+    *out = aio_stats;
+}
+
+bool io_pending(void) {
+    if (in_service_head || handler_head) return true;  // une file non vide a des canaux occupés
+    for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+        if (devices[d].irq_head) return true;
+    }
+    return false;
+}
+
+/* Les canaux libérés servent la file du périphérique, dans l'ordre */
+static void serve_queue(io_device_t dev, int now) {
+    io_device_state_t *d = &devices[dev];
+
+    if (dev == IO_DEVICE_DISK && disk_enabled()) {
+        disk_serve(now, NULL);
+        return;
+    }
+    if (dev == IO_DEVICE_NETWORK && nic_enabled()) {
+        while (d->head && nic_send(d->head, d->head->duration, d->head->submitted, now)) {
+            io_req_t *r = d->head;
+            queue_unlink(d, r);
+            nic_started(r, now);
+            traced_start(r, now);
+        }
+        return;
+    }
+    while (d->head && d->busy < d->channels) {
+        io_req_t *r = d->head;
+        queue_unlink(d, r);
+        d->busy++;
+        start_service(r, now);
+        traced_start(r, now);
+    }
+}
+
+/* Fin d'I/O rendue à son processus : réveil, ou complétion dans son
+ * anneau pour une requête asynchrone */
+static void deliver(io_req_t *r, int now) {
+    PCB *p = r->proc;
+    if (!p) return;                      // processus tué entre-temps
+
+    if (r->async) {
+        complete_async(p, now);
+        return;
+    }
 
-    io_device_t dev = (io_device_t)proc->io_device;
+    /* On nettoie les champs I/O du PCB, puis réveil */
+    p->waiting_for_io = false;
+    p->blocked_until  = -1;
+    p->io_device      = -1;
+    pcb_queue_remove(&global_scheduler.blocked_queue, p);
+    p->state = READY;
 
-    printf("[IO] P%d -> fin d'I/O sur %s, liberation de la ressource.\n",
-           proc->pid, io_device_to_str(dev));
+    TRACE_EVENT(TRACE_CAT_IO, now, p->pid,
+                EV_UNBLOCKED, ST_READY, RS_IO,
+                -1, Q_READY, 0);
 
-    io_release_device(dev);
+    scheduler_add_ready(p);
+}
+
+/* Interruptions des périphériques dont le lot est complet (ou le plus
+ * ancien trop vieux), puis livraison des traitements finis à now */
+static void irq_update(int now) {
+    for (int dev = 0; dev < IO_DEVICE_COUNT; ++dev) {
+        io_device_state_t *d = &devices[dev];
+        if (!d->irq_head) continue;
+        if (d->irq_count < irq_cfg.coalesce_count &&
+            now - d->irq_head->done < irq_cfg.coalesce_ticks) {
+            continue;
+        }
+
+        int cost = irq_cfg.top_half + irq_cfg.bottom_half * d->irq_count;
+        int at   = cost > 0 ? scheduler_irq(cost) : now;
+
+        for (io_req_t *r = d->irq_head; r; r = r->next) r->deliver_at = at;
+        if (handler_tail) handler_tail->next = d->irq_head;
+        else              handler_head       = d->irq_head;
+        handler_tail = d->irq_tail;
+
+        if (io_verbose) {
+            printf("[IO] Interruption %s : %d completion(s), traitement de %d ticks "
+                   "(reveils @ %d)\n", io_device_to_str((io_device_t)dev),
+                   d->irq_count, cost, at);
+        }
+        irq_stats.interrupts++;
+        irq_stats.cpu_ticks += cost;
+        d->irq_head  = d->irq_tail = NULL;
+        d->irq_count = 0;
+    }
+
+    /* Les traitements ne finissent pas dans l'ordre (CPU plus ou moins
+     * chargés) : la liste est parcourue en entier */
+    io_req_t **link = &handler_head;
+    io_req_t  *prev = NULL;
+    while (*link) {
+        io_req_t *r = *link;
+        if (r->deliver_at > now) {
+            prev = r;
+            link = &r->next;
+            continue;
+        }
+        *link = r->next;
+        if (handler_tail == r) handler_tail = prev;
+
+        int delay = now - r->done;
+        irq_stats.completions++;
+        irq_stats.delay_ticks += delay;
+        if (delay > irq_stats.max_delay) irq_stats.max_delay = delay;
+
+        deliver(r, now);
+        req_release(r);
+    }
+}
+
+/* Réponses réseau livrées par nic.c : la carte a déjà compté le coût de
+ * la réception, le processus est réveillé sans passer par irq_update */
+static void nic_collect(int now) {
+    io_device_state_t *d = &devices[IO_DEVICE_NETWORK];
+    io_req_t          *r;
+
+    nic_update(now);
+    while ((r = nic_pop_delivered()) != NULL) {
+        io_req_t *prev = NULL;
+        for (io_req_t *q = in_service_head; q != r; q = q->next) prev = q;
+        if (prev) prev->next      = r->next;
+        else      in_service_head = r->next;
+        if (in_service_tail == r) in_service_tail = prev;
+
+        r->done = now;
+        if (r->proc) {
+            d->stats.completed++;
+            if (io_verbose) {
+                printf("[IO] P%d -> reponse recue sur NETWORK apres %d ticks.\n",
+                       r->proc->pid, now - r->submitted);
+            }
+        }
+        deliver(r, now);
+        req_release(r);
+    }
+    serve_queue(IO_DEVICE_NETWORK, now);   // entrées TX libérées
+}
+
+void io_update(uint32_t now) {
+    io_req_t **link = &in_service_head;
+    io_req_t  *prev = NULL;
+
+    while (*link) {
+        io_req_t *r = *link;
+        if (r->done > (int)now) {
+            prev = r;
+            link = &r->next;
+            continue;
+        }
+
+        /* Fin de service : on décroche la requête */
+        *link = r->next;
+        if (in_service_tail == r) in_service_tail = prev;
+
+        io_device_state_t *d = &devices[r->dev];
+        PCB               *p = r->proc;
+        if (r->holds_channel) {
+            d->busy--;
+            d->stats.busy_ticks += r->duration;
+        }
+        if (!p) {                        // processus tué pendant le service
+            if (r->holds_channel) serve_queue(r->dev, (int)now);
+            req_release(r);
+            continue;
+        }
+        d->stats.completed++;
+
+        if (io_verbose) {
+            printf("[IO] P%d -> fin d'I/O%s sur %s, liberation du canal.\n",
+                   p->pid, r->async ? " asynchrone" : "", io_device_to_str(r->dev));
+        }
+        if (irq_enabled) {
+            /* Le processus attend l'interruption de son périphérique */
+            r->next = NULL;
+            if (d->irq_tail) d->irq_tail->next = r;
+            else             d->irq_head       = r;
+            d->irq_tail = r;
+            d->irq_count++;
+            if (r->holds_channel) serve_queue(r->dev, (int)now);
+            continue;
+        }
+        deliver(r, (int)now);
+
+        /* Canal libre : la file du périphérique avance (les requêtes
+         * démarrées ici sont ajoutées en fin de liste, pas revues ce tick,
+         * leur durée étant > 0) */
+        if (r->holds_channel) serve_queue(r->dev, (int)now);
+        req_release(r);
+    }
+
+    if (nic_enabled()) nic_collect((int)now);
+    if (irq_enabled) irq_update((int)now);
+}
+
+void io_cancel(PCB *proc) {
+    if (!proc) return;
 
-    /* On nettoie les champs I/O du PCB */
     proc->waiting_for_io = false;
     proc->blocked_until  = -1;
     proc->io_device      = -1;
+    proc->aio_inflight   = 0;
+    proc->aio_ready      = 0;
+    proc->aio_wait_for   = 0;
+
+    /* En file : retirées sans avoir occupé de canal */
+    for (int dev = 0; dev < IO_DEVICE_COUNT; ++dev) {
+        io_device_state_t *d = &devices[dev];
+        io_req_t          *r = d->head;
+        while (r) {
+            io_req_t *next = r->next;
+            if (r->proc == proc) {
+                queue_unlink(d, r);
+                if (dev == IO_DEVICE_DISK && disk_enabled()) disk_cancel(r);
+                req_release(r);
+            }
+            r = next;
+        }
+    }
+
+    /* En service : le périphérique va au bout, personne n'est réveillé */
+    for (io_req_t *r = in_service_head; r; r = r->next) {
+        if (r->proc == proc) r->proc = NULL;
+    }
+    for (int dev = 0; dev < IO_DEVICE_COUNT; ++dev) {
+        for (io_req_t *r = devices[dev].irq_head; r; r = r->next) {
+            if (r->proc == proc) r->proc = NULL;
+        }
+    }
+    for (io_req_t *r = handler_head; r; r = r->next) {
+        if (r->proc == proc) r->proc = NULL;
+    }
+}
+
+int io_get_stats(io_device_t dev, io_device_stats_t *out) {
+    if (dev < 0 || dev >= IO_DEVICE_COUNT || !out) return -1;
+    *out = devices[dev].stats;
+    if (dev == IO_DEVICE_NETWORK && nic_enabled()) {
+        nic_stats_t nic;
+        nic_get_stats(&nic);
+        out->busy_ticks = nic.tx_ring_ticks;    // canaux = entrées de l'anneau TX
+    }
+    return 0;
 }
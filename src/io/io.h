@@ -2,6 +2,7 @@
 #define MINIOS_IO_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "../process/process.h"
 
 /* Types de périphériques I/O simulés */
@@ -15,41 +16,179 @@ typedef enum {
     IO_DEVICE_COUNT
 } io_device_t;
 
+/* Canaux par périphérique : borne de io_set_channels */
+#define IO_MAX_CHANNELS 64
+
+/* Entrées de l'anneau d'I/O asynchrones d'un processus (en vol + terminées
+ * non récoltées) */
+#define IO_AIO_RING_ENTRIES 32
+
+/* Bilan d'un périphérique (cf. io_get_stats) */
+typedef struct io_device_stats {
+    int  channels;      // requêtes servies en parallèle
+    int  requests;      // requêtes reçues
+    int  completed;     // requêtes terminées (hors processus tués)
+    int  queued;        // requêtes passées par la file (aucun canal libre)
+    long wait_ticks;    // somme des attentes en file
+    int  max_wait;      // plus longue attente en file
+    int  max_queue;     // plus longue file observée
+    long busy_ticks;    // ticks de service cumulés sur tous les canaux
+} io_device_stats_t;
+
+/* Bilan des I/O asynchrones (cf. io_get_aio_stats) */
+typedef struct io_aio_stats {
+    long submitted;      // SUBMIT acceptés
+    long completed;      // complétions déposées dans les anneaux
+    long reaps;          // récoltes non vides (WAIT, REAP, anneau plein)
+    long reaped;         // complétions récoltées
+    long waits;          // WAIT exécutés
+    long waits_blocked;  // WAIT (ou SUBMIT sur anneau plein) qui ont endormi le processus
+    long ring_full;      // SUBMIT sur anneau plein
+} io_aio_stats_t;
+
+/*
+ * Modèle d'interruptions (coupé par défaut : une fin d'I/O réveille son
+ * processus gratuitement, au tick même). Avec le modèle, une fin d'I/O
+ * est signalée au CPU par une interruption, qui peut en regrouper
+ * plusieurs d'un même périphérique (coalescence) :
+ *
+ * - le périphérique interrompt dès coalesce_count complétions en attente,
+ *   ou quand la plus ancienne attend depuis coalesce_ticks ticks ;
+ * - le traitement coûte top_half + bottom_half x complétions ticks CPU,
+ *   pris sur un CPU (le processus qui y tourne n'avance pas) ;
+ * - les processus ne sont réveillés qu'à la fin du traitement.
+ */
+typedef struct io_irq_config {
+    int top_half;        // ticks par interruption (prise en compte, acquittement)
+    int bottom_half;     // ticks par complétion (réveil, recopie)
+    int coalesce_count;  // complétions par interruption (1 = aucune coalescence)
+    int coalesce_ticks;  // attente max d'une complétion avant l'interruption
+} io_irq_config_t;
+
+/* Bilan des interruptions (cf. io_get_irq_stats) */
+typedef struct io_irq_stats {
+    long interrupts;
+    long completions;    // complétions livrées
+    long cpu_ticks;      // ticks CPU de traitement
+    long delay_ticks;    // somme des délais fin de service -> réveil
+    int  max_delay;
+} io_irq_stats_t;
+
+/* Une interruption par complétion, 1 tick + 1 tick par complétion. */
+void io_irq_default_config(io_irq_config_t *cfg);
+
 /**
- * Initialise le module I/O et les primitives de synchro associées
- * (2 mutex + 4 sémaphores, dont un binaire).
+ * Active le modèle d'interruptions (cfg copiée) ou le coupe (NULL), à
+ * appeler avant io_init. -1 si la configuration est invalide.
+ */
+int io_set_irq_model(const io_irq_config_t *cfg);
+
+bool io_irq_enabled(void);
+
+void io_get_irq_stats(io_irq_stats_t *out);
+
+/**
+ * Initialise le module I/O : canaux libres, files vides, bilans à zéro.
  */
 void io_init(void);
 
+/**
+ * Nombre de canaux d'un périphérique (1 à IO_MAX_CHANNELS), à appeler
+ * avant io_init ; conservé d'une simulation à l'autre. Défauts : PRINTER 1,
+ * KEYBOARD 1, MOUSE 2, DISK 2, SCREEN 1, NETWORK 3. -1 si invalide.
+ * Avec le modèle de disque, le DISK n'a qu'un canal (un bras).
+ */
+int io_set_channels(io_device_t dev, int channels);
+
+/**
+ * Active / coupe les messages [IO] sur la sortie standard (actifs par
+ * défaut ; coupés par --quiet).
+ */
+void io_set_verbose(bool on);
+
 /**
  * Lance une I/O bloquante pour un processus.
  *
- * - waiting_for_io = true
- * - blocked_until  = now + duration
- * - io_device      = dev
- * - scheduler_block(proc, "io", "IO")
+ * lba : bloc de départ d'une I/O disque avec le modèle de disque (disk.h),
+ * -1 = à la suite de la précédente I/O disque du processus ; duration est
+ * alors un nombre de blocs, la durée étant calculée par le modèle. Avec
+ * le modèle de carte réseau (nic.h), duration d'une I/O NETWORK est la
+ * taille de la requête en Ko et le processus attend la réponse.
  *
- * En plus, on met à jour le mutex / sémaphore associé au périphérique.
+ * - waiting_for_io = true, io_device = dev
+ * - canal libre : blocked_until = now + duration,
+ *   scheduler_block(proc, RS_IO, Q_IO_<dev>)
+ * - sinon la requête attend en file (FIFO) : blocked_until =
+ *   PCB_BLOCKED_FOREVER, scheduler_block(proc, RS_IO_QUEUE, Q_IO_<dev>) ;
+ *   le début du service est tracé (BLOCKED, RS_IO, Q_IO_<dev>)
  */
 void io_request(PCB *proc, io_device_t dev,
-                uint32_t duration, uint32_t now);
+                uint32_t duration, int lba, uint32_t now);
 
 /**
- * Hook de mise à jour I/O (optionnel, pour compat).
- * Avec ton scheduler actuel, les réveils se font via blocked_until,
- * donc io_update ne fait rien.
+ * Fins d'I/O (appelé à chaque tick par le scheduler) : les requêtes dont
+ * le service se termine à now réveillent leur processus (READY), dans
+ * l'ordre où elles ont démarré, et les canaux libérés servent la file
+ * de leur périphérique. Avec le modèle d'interruptions, le réveil attend
+ * la fin du traitement de l'interruption.
  */
 void io_update(uint32_t now);
 
+/*
+ * I/O asynchrones, sur le modèle des anneaux de soumission / complétion :
+ * SUBMIT dépose une requête sans bloquer (mêmes périphériques, canaux et
+ * files que io_request), le processus continue de calculer ; chaque
+ * requête terminée dépose une complétion dans son anneau (aio_ready).
+ * WAIT endort le processus jusqu'à ce que assez de complétions soient
+ * disponibles, puis les récolte toutes ; REAP récolte sans bloquer. Les
+ * complétions d'un même tick réveillent le processus une seule fois.
+ */
+
+/**
+ * Soumet une I/O asynchrone (lba comme io_request). false si l'anneau est
+ * plein de requêtes en vol : proc est bloqué jusqu'à la prochaine
+ * complétion et doit resoumettre.
+ */
+bool io_submit_async(PCB *proc, io_device_t dev,
+                     uint32_t duration, int lba, uint32_t now);
+
+/**
+ * Attend min_complete complétions (<= 0 ou plus que les requêtes en
+ * cours : toutes), puis les récolte. true si proc a été bloqué
+ * (BLOCKED, RS_AIO_WAIT) ; au réveil, la récolte est faite. Un processus
+ * qui n'a plus de calcul se termine à son réveil.
+ */
+bool io_wait_async(PCB *proc, int min_complete);
+
+/* Récolte sans bloquer ; retourne le nombre de complétions consommées. */
+int io_reap_async(PCB *proc);
+
+void io_get_aio_stats(io_aio_stats_t *out);
+
+/* true si une requête est en service ou en file sur un périphérique, ou
+ * si une complétion attend son interruption. */
+bool io_pending(void);
+
 /**
- * Appelé lorsque le scheduler réveille un processus pour fin d'I/O.
- * Ça permet de libérer le mutex / sémaphore associé au device.
+ * Abandon des I/O d'un processus tué (OOM) ou terminé : ses requêtes en
+ * file sont retirées ; celles en service (ou dont l'interruption est en
+ * attente) vont au bout sans réveiller personne. Le PCB doit déjà être sorti de la file BLOCKED.
  */
-void io_release_resource_for(PCB *proc);
+void io_cancel(PCB *proc);
+
+/**
+ * Bilan du périphérique dev depuis io_init. -1 si dev invalide.
+ */
+int io_get_stats(io_device_t dev, io_device_stats_t *out);
 
 /**
  * Helper pour debug / logs.
  */
 const char* io_device_to_str(io_device_t dev);
 
+/**
+ * Inverse de io_device_to_str (casse ignorée). -1 si nom inconnu.
+ */
+int io_device_from_str(const char *name);
+
 #endif // MINIOS_IO_H
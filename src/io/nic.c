@@ -0,0 +1,380 @@
+#include "nic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../scheduler/scheduler.h"
+
+/* Paquet : une requête puis sa réponse (même enregistrement d'un bout à
+ * l'autre du chemin) */
+typedef struct nic_pkt {
+    void           *cookie;
+    int             size;        // Ko de la requête
+    int             resp;        // Ko de la réponse
+    int             since;       // demande de l'appelant (mesure de latence)
+    int             at;          // fin de l'étape en cours
+    int             tx_since;    // entrée dans l'anneau TX
+    int             deliver_at;  // anneau RX : fin du traitement (-1 : pas encore pris)
+    struct nic_pkt *next;
+} nic_pkt_t;
+
+typedef struct pkt_list {
+    nic_pkt_t *head, *tail;
+} pkt_list_t;
+
+static bool         enabled;
+static nic_config_t cfg;
+
+static pkt_list_t retry;       // perdus à l'émission, par date de réémission
+static pkt_list_t tx;          // anneau TX (en émission sur le lien montant)
+static pkt_list_t peer;        // chez l'interlocuteur, par date de réponse
+static pkt_list_t flight;      // réponses sur le lien descendant
+static pkt_list_t rx;          // anneau RX
+static pkt_list_t delivered;   // livrées à now, en attente de nic_pop_delivered
+static nic_pkt_t *free_pkts;
+
+static int  tx_count, rx_count;
+static int  uplink_free;       // fin de la dernière émission montante
+static int  downlink_free;
+static bool polling;           // NAPI : interruptions coupées, poll en cours
+static int  poll_at;
+
+static nic_stats_t stats;
+static int        *latencies;  // une par réponse livrée (centiles)
+static long        lat_count, lat_capacity;
+
+static const char *const mode_names[NIC_RX_COUNT] = { "irq", "napi" };
+
+void nic_default_config(nic_config_t *c) {
+    c->rx_mode          = NIC_RX_IRQ;
+    c->drop             = false;
+    c->bandwidth        = 4;
+    c->latency          = 2;
+    c->response_size    = 0;
+    c->peer_ticks       = 1;
+    c->tx_ring          = 64;
+    c->rx_ring          = 64;
+    c->retransmit_ticks = 20;
+    c->irq_ticks        = 1;
+    c->poll_ticks       = 1;
+    c->napi_budget      = 16;
+}
+
+int nic_set_model(const nic_config_t *c) {
+    if (!c) {
+        enabled = false;
+        return 0;
+    }
+    if (c->rx_mode < 0 || c->rx_mode >= NIC_RX_COUNT ||
+        c->bandwidth < 1 || c->latency < 0 || c->response_size < 0 || c->peer_ticks < 0 ||
+        c->tx_ring < 1 || c->rx_ring < 1 || c->retransmit_ticks < 1 ||
+        c->irq_ticks < 0 || c->poll_ticks < 0 || c->napi_budget < 1) {
+        return -1;
+    }
+    cfg     = *c;
+    enabled = true;
+    return 0;
+}
+
+bool nic_enabled(void) {
+    return enabled;
+}
+
+int nic_tx_ring(void) {
+    return cfg.tx_ring;
+}
+
+/* ===================================================================== */
+/* LISTES                                                                */
+/* ===================================================================== */
+
+static void list_push(pkt_list_t *l, nic_pkt_t *p) {
+    p->next = NULL;
+    if (l->tail) l->tail->next = p;
+    else         l->head       = p;
+    l->tail = p;
+}
+
+/* Insertion par date (après les paquets de même date) */
+static void list_insert(pkt_list_t *l, nic_pkt_t *p) {
+    nic_pkt_t *prev = NULL;
+    for (nic_pkt_t *q = l->head; q && q->at <= p->at; q = q->next) prev = q;
+    if (!prev) {
+        p->next = l->head;
+        l->head = p;
+    } else {
+        p->next    = prev->next;
+        prev->next = p;
+    }
+    if (!p->next) l->tail = p;
+}
+
+static nic_pkt_t *list_pop(pkt_list_t *l) {
+    nic_pkt_t *p = l->head;
+    l->head = p->next;
+    if (!l->head) l->tail = NULL;
+    return p;
+}
+
+static void list_release(pkt_list_t *l) {
+    while (l->head) {
+        nic_pkt_t *p = list_pop(l);
+        p->next   = free_pkts;
+        free_pkts = p;
+    }
+}
+
+void nic_init(void) {
+    list_release(&retry);
+    list_release(&tx);
+    list_release(&peer);
+    list_release(&flight);
+    list_release(&rx);
+    list_release(&delivered);
+    tx_count      = rx_count = 0;
+    uplink_free   = downlink_free = 0;
+    polling       = false;
+    poll_at       = 0;
+    lat_count     = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+/* ===================================================================== */
+/* CHEMIN DES PAQUETS                                                    */
+/* ===================================================================== */
+
+/* Durée de passage de kb Ko sur le lien */
+static int xfer_ticks(int kb) {
+    int t = (kb + cfg.bandwidth - 1) / cfg.bandwidth;
+    return t < 1 ? 1 : t;
+}
+
+/* Entrée dans l'anneau TX : émise après celles qui la précèdent */
+static void tx_push(nic_pkt_t *p, int now) {
+    int start = uplink_free > now ? uplink_free : now;
+    uplink_free = start + xfer_ticks(p->size);
+    p->at       = uplink_free;
+    p->tx_since = now;
+    list_push(&tx, p);
+    tx_count++;
+    stats.tx_kb += p->size;
+}
+
+/* Travail noyau de ticks ticks sur un CPU ; retourne sa date de fin */
+static int cpu_work(int ticks, int now) {
+    if (ticks <= 0) return now;
+    stats.cpu_ticks += ticks;
+    return scheduler_irq(ticks);
+}
+
+bool nic_send(void *cookie, int size, int since, int now) {
+    if (tx_count >= cfg.tx_ring && !cfg.drop) {
+        stats.tx_stalls++;
+        return false;
+    }
+
+    nic_pkt_t *p = free_pkts;
+    if (p) {
+        free_pkts = p->next;
+    } else if (!(p = malloc(sizeof(*p)))) {
+        fprintf(stderr, "[Reseau] plus de memoire pour les paquets\n");
+        exit(EXIT_FAILURE);
+    }
+    p->cookie     = cookie;
+    p->size       = size > 0 ? size : 1;
+    p->resp       = cfg.response_size > 0 ? cfg.response_size : p->size;
+    p->since      = since;
+    p->deliver_at = -1;
+    stats.requests++;
+
+    if (tx_count >= cfg.tx_ring) {          // perte : réémis plus tard
+        stats.tx_drops++;
+        p->at = now + cfg.retransmit_ticks;
+        list_insert(&retry, p);
+    } else {
+        tx_push(p, now);
+    }
+    return true;
+}
+
+static void record_latency(int ticks) {
+    if (lat_count == lat_capacity) {
+        long cap = lat_capacity ? lat_capacity * 2 : 1024;
+        int *tab = realloc(latencies, (size_t)cap * sizeof(int));
+        if (!tab) {
+            fprintf(stderr, "[Reseau] plus de memoire pour les latences\n");
+            exit(EXIT_FAILURE);
+        }
+        latencies    = tab;
+        lat_capacity = cap;
+    }
+    latencies[lat_count++] = ticks;
+}
+
+/* NAPI : une interruption lance le poll ; chaque passage prend au plus
+ * napi_budget paquets, un passage incomplet a vidé l'anneau et réactive
+ * les interruptions */
+static void napi_update(int now) {
+    int waiting = 0;
+    for (nic_pkt_t *p = rx.head; p; p = p->next) {
+        if (p->deliver_at < 0) waiting++;
+    }
+
+    if (!polling) {
+        if (waiting == 0) return;
+        polling = true;
+        stats.interrupts++;
+        poll_at = cpu_work(cfg.irq_ticks, now);
+    }
+    if (poll_at > now) return;
+
+    int k  = waiting < cfg.napi_budget ? waiting : cfg.napi_budget;
+    int at = cpu_work(cfg.poll_ticks, now);
+    stats.polls++;
+
+    int n = 0;
+    for (nic_pkt_t *p = rx.head; p && n < k; p = p->next) {
+        if (p->deliver_at >= 0) continue;
+        p->deliver_at = at;
+        n++;
+    }
+    if (k < cfg.napi_budget) polling = false;
+    else                     poll_at = at > now ? at : now + 1;
+}
+
+void nic_update(int now) {
+    nic_pkt_t *p;
+
+    /* 1) Réémissions des paquets perdus à l'émission */
+    while (retry.head && retry.head->at <= now) {
+        p = list_pop(&retry);
+        if (tx_count >= cfg.tx_ring) {
+            stats.tx_drops++;
+            p->at = now + cfg.retransmit_ticks;
+            list_insert(&retry, p);
+        } else {
+            tx_push(p, now);
+        }
+    }
+
+    /* 2) Fin d'émission : l'entrée TX se libère, la requête traverse le
+     *    lien puis est traitée par l'interlocuteur */
+    while (tx.head && tx.head->at <= now) {
+        p = list_pop(&tx);
+        tx_count--;
+        stats.tx_ring_ticks += p->at - p->tx_since;
+        p->at += cfg.latency + cfg.peer_ticks;
+        list_insert(&peer, p);
+    }
+
+    /* 3) Réponses prêtes : lien descendant, dans l'ordre */
+    while (peer.head && peer.head->at <= now) {
+        p = list_pop(&peer);
+        int start = downlink_free > p->at ? downlink_free : p->at;
+        downlink_free = start + xfer_ticks(p->resp);
+        p->at         = downlink_free + cfg.latency;
+        stats.rx_kb  += p->resp;
+        list_push(&flight, p);
+    }
+
+    /* 4) Arrivées dans l'anneau RX ; plein : pause du lien ou perte */
+    while (flight.head && flight.head->at <= now) {
+        if (rx_count >= cfg.rx_ring) {
+            if (!cfg.drop) {
+                stats.rx_stalls++;
+                break;
+            }
+            p = list_pop(&flight);
+            stats.rx_drops++;
+            p->at = now + cfg.retransmit_ticks;
+            list_insert(&peer, p);
+            continue;
+        }
+        p = list_pop(&flight);
+        p->deliver_at = -1;
+        list_push(&rx, p);
+        rx_count++;
+        if (cfg.rx_mode == NIC_RX_IRQ) {
+            stats.interrupts++;
+            p->deliver_at = cpu_work(cfg.irq_ticks, now);
+        }
+    }
+
+    /* 5) NAPI : poll des paquets pas encore pris */
+    if (cfg.rx_mode == NIC_RX_NAPI) napi_update(now);
+
+    /* 6) Traitement fini : l'entrée RX se libère, la réponse est livrée
+     *    (les CPU n'ont pas la même charge : l'anneau est parcouru en entier) */
+    nic_pkt_t *prev = NULL;
+    p = rx.head;
+    while (p) {
+        nic_pkt_t *next = p->next;
+        if (p->deliver_at >= 0 && p->deliver_at <= now) {
+            if (prev) prev->next = next;
+            else      rx.head    = next;
+            if (rx.tail == p) rx.tail = prev;
+            rx_count--;
+
+            stats.responses++;
+            record_latency(now - p->since);
+            list_push(&delivered, p);
+        } else {
+            prev = p;
+        }
+        p = next;
+    }
+}
+
+void *nic_pop_delivered(void) {
+    if (!delivered.head) return NULL;
+    nic_pkt_t *p      = list_pop(&delivered);
+    void      *cookie = p->cookie;
+    p->next   = free_pkts;
+    free_pkts = p;
+    return cookie;
+}
+
+/* ===================================================================== */
+/* BILAN                                                                 */
+/* ===================================================================== */
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Centile q (rang le plus proche) d'un tableau trié */
+static int percentile(const int *v, long n, int q) {
+    long rank = (n * q + 99) / 100;
+    return v[rank > 0 ? rank - 1 : 0];
+}
+
+void nic_get_stats(nic_stats_t *out) {
+    *out = stats;
+    if (lat_count == 0) return;
+
+    int *v = malloc((size_t)lat_count * sizeof(int));
+    if (!v) return;
+    memcpy(v, latencies, (size_t)lat_count * sizeof(int));
+    qsort(v, (size_t)lat_count, sizeof(int), cmp_int);
+
+    long long sum = 0;
+    for (long i = 0; i < lat_count; ++i) sum += v[i];
+    out->latency_avg = (double)sum / lat_count;
+    out->latency_p50 = percentile(v, lat_count, 50);
+    out->latency_p99 = percentile(v, lat_count, 99);
+    out->latency_max = v[lat_count - 1];
+    free(v);
+}
+
+const char *nic_rx_mode_to_str(nic_rx_mode_t m) {
+    return (m >= 0 && m < NIC_RX_COUNT) ? mode_names[m] : "?";
+}
+
+int nic_rx_mode_from_str(const char *name) {
+    for (int m = 0; m < NIC_RX_COUNT; ++m) {
+        if (strcmp(name, mode_names[m]) == 0) return m;
+    }
+    return -1;
+}
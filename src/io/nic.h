@@ -0,0 +1,109 @@
+#ifndef MINIOS_NIC_H
+#define MINIOS_NIC_H
+
+#include <stdbool.h>
+
+/*
+ * Modèle de carte réseau (IO_DEVICE_NETWORK), sans réseau réel : une
+ * requête IO(NETWORK, n) envoie n Ko à un interlocuteur local simulé qui
+ * répond, et le processus attend la réponse. Le chemin d'un paquet :
+ *
+ *   anneau TX -> lien montant (n / débit) -> propagation -> interlocuteur
+ *   (peer_ticks) -> lien descendant (réponse / débit) -> propagation ->
+ *   anneau RX -> traitement par le noyau (interruption ou NAPI) -> réveil
+ *
+ * Le lien est full-duplex, chaque sens sert ses paquets dans l'ordre.
+ * Les anneaux sont bornés. Quand un anneau est plein, deux politiques :
+ * - contre-pression : l'émetteur attend (la requête reste dans la file du
+ *   périphérique, le lien descendant est suspendu) ;
+ * - perte : le paquet est perdu et réémis après retransmit_ticks.
+ *
+ * Réception : en mode IRQ, chaque paquet arrivé coûte une interruption ;
+ * en mode NAPI, une interruption lance des passages de poll qui traitent
+ * jusqu'à napi_budget paquets chacun, et les interruptions ne reviennent
+ * qu'une fois l'anneau vidé. Ces coûts sont pris sur un CPU (scheduler_irq).
+ * Sans modèle (défaut), une I/O réseau dure simplement sa durée.
+ */
+
+typedef enum {
+    NIC_RX_IRQ = 0,     // une interruption par paquet reçu
+    NIC_RX_NAPI,        // interruption puis poll par lots
+    NIC_RX_COUNT
+} nic_rx_mode_t;
+
+typedef struct nic_config {
+    nic_rx_mode_t rx_mode;
+    bool drop;              // anneau plein : perte (sinon contre-pression)
+    int  bandwidth;         // Ko par tick, dans chaque sens
+    int  latency;           // propagation, en ticks, dans chaque sens
+    int  response_size;     // Ko de la réponse (0 = taille de la requête)
+    int  peer_ticks;        // traitement d'une requête par l'interlocuteur
+    int  tx_ring;           // entrées de l'anneau d'émission
+    int  rx_ring;           // entrées de l'anneau de réception
+    int  retransmit_ticks;  // perte : délai avant réémission
+    int  irq_ticks;         // coût CPU d'une interruption de réception
+    int  poll_ticks;        // NAPI : coût CPU d'un passage de poll
+    int  napi_budget;       // NAPI : paquets traités au plus par passage
+} nic_config_t;
+
+typedef struct nic_stats {
+    long   requests;        // requêtes acceptées par nic_send
+    long   responses;       // réponses livrées
+    long   tx_kb, rx_kb;
+    long   tx_ring_ticks;   // occupation de l'anneau TX (entrées x ticks)
+    long   tx_drops;        // perte : anneau TX plein
+    long   rx_drops;        // perte : anneau RX plein
+    long   tx_stalls;       // contre-pression : requêtes refusées par l'anneau TX
+    long   rx_stalls;       // contre-pression : ticks de lien descendant suspendu
+    long   interrupts;
+    long   polls;           // NAPI : passages de poll
+    long   cpu_ticks;       // interruptions + polls
+    double latency_avg;     // envoi -> réveil, en ticks
+    int    latency_p50;
+    int    latency_p99;
+    int    latency_max;
+} nic_stats_t;
+
+/* Un tick ~ 1 ms : lien 4 Ko par tick (~32 Mbit/s), 2 ticks de propagation,
+ * réponse de la taille de la requête, interlocuteur 1 tick, anneaux de 64,
+ * contre-pression, réémission après 20 ticks ; IRQ 1 tick, poll 1 tick,
+ * budget NAPI 16. */
+void nic_default_config(nic_config_t *cfg);
+
+/**
+ * Active le modèle (cfg copiée) ou le coupe (NULL : durées fixes), à
+ * appeler avant io_init. -1 si la configuration est invalide.
+ */
+int nic_set_model(const nic_config_t *cfg);
+
+bool nic_enabled(void);
+
+/* Taille de l'anneau TX du modèle (canaux affichés pour NETWORK). */
+int nic_tx_ring(void);
+
+/* Anneaux et lien vides, bilan à zéro (appelé par io_init). */
+void nic_init(void);
+
+/**
+ * Dépose une requête de size Ko dans l'anneau TX ; cookie identifie la
+ * requête pour l'appelant, since est l'instant où elle a été faite (la
+ * latence mesurée compte l'attente avant l'anneau). false si l'anneau
+ * est plein en contre-pression : l'appelant la garde et réessaiera.
+ */
+bool nic_send(void *cookie, int size, int since, int now);
+
+/* Fait avancer lien, interlocuteur et réception jusqu'à now (une fois par
+ * tick, avant nic_pop_delivered). */
+void nic_update(int now);
+
+/* Prochaine réponse livrée à now (NULL quand il n'y en a plus). */
+void *nic_pop_delivered(void);
+
+void nic_get_stats(nic_stats_t *out);
+
+const char *nic_rx_mode_to_str(nic_rx_mode_t m);
+
+/* Inverse de nic_rx_mode_to_str (irq, napi). -1 si inconnu. */
+int nic_rx_mode_from_str(const char *name);
+
+#endif // MINIOS_NIC_H
@@ -2,6 +2,9 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 #include "../process/process.h"
 // --- AJOUTS POUR LE LOGGING ---
 #include "../trace/logger.h"
@@ -11,27 +14,134 @@
    Paramètres du heap simulé
  ************************************************************/
 
-// 64 MiB = 64 * 1024 * 1024 octets
-#define HEAP_SIZE   (64u * 1024u * 1024u)
+// 64 MiB = 64 * 1024 * 1024 octets par défaut (cf. memory_set_heap_size)
+#define HEAP_DEFAULT_SIZE   (64u * 1024u * 1024u)
+#define HEAP_MIN_SIZE       (64u * 1024u)
 
-/* Zone de mémoire simulée (heap utilisateur). */
-static uint8_t heap[HEAP_SIZE];
+/* Zone de mémoire simulée (heap utilisateur) : le tableau statique tant
+ * que la taille demandée y tient, une zone malloc au-delà. */
+static uint8_t  heap_default[HEAP_DEFAULT_SIZE];
+static uint8_t* heap      = heap_default;
+static size_t   heap_size = HEAP_DEFAULT_SIZE;
+
+/* Valeur sentinelle d'un en-tête valide (effacée quand le bloc est fusionné). */
+#define BLOCK_MAGIC 0x4D494E49u  // "MINI"
 
 /* Description d’un bloc dans la free list. */
 typedef struct block {
     size_t size;           // taille utile du bloc (données utilisateur)
     int    free;           // 1 = libre, 0 = occupé
+    unsigned magic;        // BLOCK_MAGIC si l'en-tête est vivant
+    int    owner;          // PID propriétaire (-1 = système), si USED
+    short  tag;            // mem_tag_t : nature de l'allocation, si USED
+    short  cached;         // 1 = bloc des caches par thread (mode concurrent)
     struct block* next;    // bloc suivant dans la free list
+    struct block* prev;    // bloc précédent (fusion en O(1) dans mini_free)
 } block_t;
 
 /* Premier bloc du heap. */
 static block_t* first_block = NULL;
 
+/* Stratégie de placement + curseur du next-fit (toujours un en-tête vivant). */
+static memory_strategy_t strategy = MEM_FIT_FIRST;
+static block_t* rover = NULL;
+
+/* Incrémenté à chaque libération (cf. memory_release_epoch). */
+static unsigned long release_epoch = 0;
+
+/* Compaction automatique sur échec d'allocation (désactivée par défaut). */
+static int auto_compact = 0;
+
+/* Cumuls de compaction (remis à zéro par memory_init). */
+static int    compact_count       = 0;
+static size_t compact_moved_total = 0;
+static int    compact_ticks_total = 0;
+
+/* Index d'usage par processus : hash (adressage ouvert) pid -> octets/blocs.
+ * Une entrée disparaît quand le processus n'a plus aucun bloc, la taille
+ * reste donc proportionnelle au nombre de propriétaires vivants. */
+typedef struct usage_entry {
+    int    pid;
+    int    blocks;          // 0 = case vide
+    size_t bytes;
+} usage_entry_t;
+
+static usage_entry_t *usage_tab      = NULL;
+static size_t         usage_capacity = 0;   // puissance de 2
+static size_t         usage_count    = 0;
+
+/* Table des handles : ensemble (hash, adressage ouvert) des adresses
+ * de pointeurs qui référencent un bloc du heap. */
+#define HANDLE_EMPTY     ((void**)0)
+#define HANDLE_TOMBSTONE ((void**)1)
+
+static void ***handle_slots    = NULL;
+static size_t  handle_capacity = 0;   // puissance de 2
+static size_t  handle_count    = 0;   // entrées vivantes
+static size_t  handle_used     = 0;   // vivantes + tombstones
+
+/* Mode concurrent : verrou central + caches par thread (cf. memory_set_concurrent). */
+#if defined(_MSC_VER)
+#define MINIOS_THREAD_LOCAL __declspec(thread)
+#else
+#define MINIOS_THREAD_LOCAL __thread
+#endif
+
+static int concurrent     = 0;
+static int tcache_enabled = 1;
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define HEAP_LOCK()   do { if (concurrent) pthread_mutex_lock(&heap_lock); } while (0)
+#define HEAP_UNLOCK() do { if (concurrent) pthread_mutex_unlock(&heap_lock); } while (0)
+
+/* L'index d'usage a son propre verrou (pris après celui du heap) : le
+ * chemin rapide des caches par thread y reporte le propriétaire sans
+ * prendre le verrou du heap. */
+static pthread_mutex_t usage_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define USAGE_LOCK()   do { if (concurrent) pthread_mutex_lock(&usage_lock); } while (0)
+#define USAGE_UNLOCK() do { if (concurrent) pthread_mutex_unlock(&usage_lock); } while (0)
+
+/* Classes de petites tailles servies par les caches par thread. */
+#define TCACHE_CLASSES   8
+#define TCACHE_MAX_SIZE  256u
+#define TCACHE_BATCH     32     // blocs échangés par aller-retour avec le dépôt / le heap
+#define TCACHE_BIN_MAX   64     // au-delà, le thread rend un lot
+#define DEPOT_MAX        1024   // blocs gardés par classe dans le dépôt central
+
+static const size_t tcache_sizes[TCACHE_CLASSES] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+/* Cache d'un thread : une pile de blocs libres par classe, chaînés par
+ * le premier mot de leur zone utile. */
+typedef struct tcache {
+    void* head[TCACHE_CLASSES];
+    int   count[TCACHE_CLASSES];
+    int   registered;           // destructeur de fin de thread installé
+} tcache_t;
+
+/* Dépôt central par classe : verrou propre à la classe, le verrou du heap
+ * n'est pris que quand le dépôt est vide (remplissage) ou plein. */
+typedef struct tc_depot {
+    pthread_mutex_t lock;
+    void* head;
+    int   count;
+} tc_depot_t;
+
+static MINIOS_THREAD_LOCAL tcache_t tcache;
+static tc_depot_t depots[TCACHE_CLASSES];
+static pthread_once_t tcache_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  tcache_key;
+
 
 /************************************************************
    Fonctions internes
  ************************************************************/
 
+static void  heap_stats(memory_stats_t *out);
+static int   heap_compact(memory_compact_report_t *out);
+static void* tcache_alloc(size_t size, int owner, mem_tag_t tag);
+static int   tcache_free(void* ptr);
+
 /* Alignement (optionnel) pour éviter des problèmes sur certaines archis). */
 static size_t align_size(size_t size) {
     const size_t align = sizeof(void*);
@@ -56,139 +166,433 @@ static void print_human_size(size_t bytes) {
 }
 
 
+/* Classe d'histogramme d'un bloc libre : floor(log2(size)) - 4, bornée. */
+static int frag_bucket(size_t size) {
+    int b = -4;
+    while (size > 1) {
+        size >>= 1;
+        b++;
+    }
+    if (b < 0) b = 0;
+    if (b >= MEMORY_FRAG_BUCKETS) b = MEMORY_FRAG_BUCKETS - 1;
+    return b;
+}
+
+/* Hash d'une adresse de slot (les slots sont alignés sur un pointeur). */
+static size_t handle_hash(void **slot) {
+    uintptr_t h = (uintptr_t)slot / sizeof(void*);
+    h ^= h >> 17;
+    h *= (uintptr_t)0x9E3779B97F4A7C15ull;
+    h ^= h >> 29;
+    return (size_t)h;
+}
+
+static int handle_rehash(size_t new_capacity) {
+    void ***old     = handle_slots;
+    size_t  old_cap = handle_capacity;
+
+    void ***tab = calloc(new_capacity, sizeof(void**));
+    if (!tab) return -1;
+
+    handle_slots    = tab;
+    handle_capacity = new_capacity;
+    handle_used     = handle_count;
+
+    for (size_t i = 0; i < old_cap; ++i) {
+        void **slot = old[i];
+        if (slot == HANDLE_EMPTY || slot == HANDLE_TOMBSTONE) continue;
+
+        size_t j = handle_hash(slot) & (new_capacity - 1);
+        while (tab[j] != HANDLE_EMPTY) {
+            j = (j + 1) & (new_capacity - 1);
+        }
+        tab[j] = slot;
+    }
+
+    free(old);
+    return 0;
+}
+
+/* Recherche binaire du bloc (parmi n, triés par adresse) contenant addr. */
+static long find_block_index(uint8_t **payloads, size_t *sizes, long n, const uint8_t *addr) {
+    long lo = 0, hi = n - 1;
+    while (lo <= hi) {
+        long mid = lo + (hi - lo) / 2;
+        if (addr < payloads[mid]) {
+            hi = mid - 1;
+        } else if (addr >= payloads[mid] + sizes[mid]) {
+            lo = mid + 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+
+static size_t usage_slot(int pid) {
+    uint32_t h = (uint32_t)pid * 2654435761u;
+    return (size_t)(h ^ (h >> 16)) & (usage_capacity - 1);
+}
+
+/* Retrouve l'entrée de pid (NULL si absente). */
+static usage_entry_t* usage_find(int pid) {
+    if (usage_capacity == 0) return NULL;
+    size_t j = usage_slot(pid);
+    while (usage_tab[j].blocks != 0) {
+        if (usage_tab[j].pid == pid) return &usage_tab[j];
+        j = (j + 1) & (usage_capacity - 1);
+    }
+    return NULL;
+}
+
+static int usage_grow(void) {
+    usage_entry_t *old     = usage_tab;
+    size_t         old_cap = usage_capacity;
+    size_t         cap     = old_cap ? old_cap * 2 : 64;
+
+    usage_entry_t *tab = calloc(cap, sizeof(*tab));
+    if (!tab) return -1;
+
+    usage_tab      = tab;
+    usage_capacity = cap;
+    for (size_t i = 0; i < old_cap; ++i) {
+        if (old[i].blocks == 0) continue;
+        size_t j = usage_slot(old[i].pid);
+        while (tab[j].blocks != 0) j = (j + 1) & (cap - 1);
+        tab[j] = old[i];
+    }
+    free(old);
+    return 0;
+}
+
+static void usage_add(int pid, size_t bytes) {
+    usage_entry_t *e = usage_find(pid);
+    if (!e) {
+        if ((usage_count + 1) * 10 > usage_capacity * 7 && usage_grow() != 0)
+            return;
+        size_t j = usage_slot(pid);
+        while (usage_tab[j].blocks != 0) j = (j + 1) & (usage_capacity - 1);
+        e = &usage_tab[j];
+        e->pid   = pid;
+        e->bytes = 0;
+        usage_count++;
+    }
+    e->blocks++;
+    e->bytes += bytes;
+}
+
+/* Retrait d'un bloc ; suppression par décalage arrière quand l'entrée
+ * tombe à zéro (pas de tombstones en sondage linéaire). */
+static void usage_remove(int pid, size_t bytes) {
+    usage_entry_t *e = usage_find(pid);
+    if (!e) return;
+
+    e->bytes -= (bytes <= e->bytes) ? bytes : e->bytes;
+    if (--e->blocks > 0) return;
+
+    size_t mask = usage_capacity - 1;
+    size_t hole = (size_t)(e - usage_tab);
+    size_t j    = hole;
+    usage_count--;
+
+    for (;;) {
+        j = (j + 1) & mask;
+        if (usage_tab[j].blocks == 0) break;
+        size_t home = usage_slot(usage_tab[j].pid);
+        /* L'entrée j peut combler le trou si sa place "naturelle" n'est
+         * pas dans l'intervalle circulaire ]hole, j]. */
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            usage_tab[hole] = usage_tab[j];
+            hole = j;
+        }
+    }
+    usage_tab[hole].blocks = 0;
+    usage_tab[hole].bytes  = 0;
+}
+
+/* Change le propriétaire d'un bloc dans l'index (caches par thread). */
+static void usage_move(int from, int to, size_t bytes) {
+    USAGE_LOCK();
+    usage_remove(from, bytes);
+    usage_add(to, bytes);
+    USAGE_UNLOCK();
+}
+
+
 /************************************************************
    API publique
  ************************************************************/
 
+int memory_set_heap_size(size_t bytes) {
+    if (bytes < HEAP_MIN_SIZE) return -1;
+    bytes &= ~(size_t)15;   // alignement des en-têtes
+
+    uint8_t* zone = heap_default;
+    if (bytes > HEAP_DEFAULT_SIZE) {
+        zone = malloc(bytes);
+        if (!zone) return -1;
+    }
+    if (heap != heap_default) free(heap);
+
+    heap        = zone;
+    heap_size   = bytes;
+    first_block = NULL;     // à réinitialiser par memory_init
+    rover       = NULL;
+    return 0;
+}
+
+size_t memory_heap_size(void) {
+    return heap_size;
+}
+
 void memory_init(void) {
     /* On place un bloc unique couvrant tout le heap. */
     first_block         = (block_t*) heap;
-    first_block->size = HEAP_SIZE - sizeof(block_t);
+    first_block->size = heap_size - sizeof(block_t);
     first_block->free = 1;
+    first_block->magic = BLOCK_MAGIC;
     first_block->next = NULL;
-}
+    first_block->prev = NULL;
+    rover = first_block;
 
-void* mini_malloc(size_t size) {
-    if (size == 0 || !first_block)
-        return NULL;
+    compact_count       = 0;
+    compact_moved_total = 0;
+    compact_ticks_total = 0;
 
-    size = align_size(size);
+    /* Les caches et dépôts pointaient dans l'ancien heap. */
+    memset(&tcache.head, 0, sizeof(tcache.head));
+    memset(&tcache.count, 0, sizeof(tcache.count));
+    for (int c = 0; c < TCACHE_CLASSES; ++c) {
+        depots[c].head  = NULL;
+        depots[c].count = 0;
+    }
 
-    block_t* curr = first_block;
+    free(usage_tab);
+    usage_tab      = NULL;
+    usage_capacity = 0;
+    usage_count    = 0;
 
-    while (curr) {
-        if (curr->free && curr->size >= size) {
+    free(handle_slots);
+    handle_slots    = NULL;
+    handle_capacity = 0;
+    handle_count    = 0;
+    handle_used     = 0;
+}
 
-            /* Si le bloc est beaucoup plus grand, on le découpe (split). */
-            if (curr->size >= size + sizeof(block_t) + 8) {
-                uint8_t* split_addr = (uint8_t*)curr + sizeof(block_t) + size;
-                block_t* new_block  = (block_t*)split_addr;
+/* Recherche d'un bloc libre >= size selon la stratégie courante. */
+static block_t* heap_find_fit(size_t size) {
+    switch (strategy) {
+        case MEM_FIT_NEXT: {
+            /* Reprend là où la dernière recherche s'est arrêtée, puis reboucle. */
+            block_t* start = rover ? rover : first_block;
+            for (block_t* c = start; c; c = c->next) {
+                if (c->free && c->size >= size) return c;
+            }
+            for (block_t* c = first_block; c && c != start; c = c->next) {
+                if (c->free && c->size >= size) return c;
+            }
+            return NULL;
+        }
 
-                new_block->size = curr->size - size - sizeof(block_t);
-                new_block->free = 1;
-                new_block->next = curr->next;
+        case MEM_FIT_BEST: {
+            block_t* best = NULL;
+            for (block_t* c = first_block; c; c = c->next) {
+                if (c->free && c->size >= size &&
+                    (!best || c->size < best->size)) {
+                    best = c;
+                    if (c->size == size) break;  // impossible de faire mieux
+                }
+            }
+            return best;
+        }
 
-                curr->size = size;
-                curr->next = new_block;
+        case MEM_FIT_FIRST:
+        default:
+            for (block_t* c = first_block; c; c = c->next) {
+                if (c->free && c->size >= size) return c;
             }
+            return NULL;
+    }
+}
 
-            curr->free = 0;
+/* Recherche + découpe. Pas de trace ici. */
+static block_t* heap_find_and_split(size_t size) {
+    block_t* curr = heap_find_fit(size);
+    if (!curr) return NULL;
 
-            // --- DEBUT LOG ALLOCATION ---
-            // On récupère le PID courant, ou -1 si c'est le système
-            int owner = (global_scheduler.current) ? global_scheduler.current->pid : -1;
-            char size_str[32];
-            sprintf(size_str, "%zu", curr->size); // On logue la taille du bloc alloué
+    /* Si le bloc est beaucoup plus grand, on le découpe (split). */
+    if (curr->size >= size + sizeof(block_t) + 8) {
+        uint8_t* split_addr = (uint8_t*)curr + sizeof(block_t) + size;
+        block_t* new_block  = (block_t*)split_addr;
 
-            trace_event(
-                    global_scheduler.current_time,
-                    owner,
-                    "MEMORY",
-                    "ALLOC",
-                    size_str, // Raison = taille en octets
-                    -1,
-                    "MEM"
-            );
-            // --- FIN LOG ALLOCATION ---
+        new_block->size = curr->size - size - sizeof(block_t);
+        new_block->free = 1;
+        new_block->magic = BLOCK_MAGIC;
+        new_block->next = curr->next;
+        new_block->prev = curr;
+        if (new_block->next) new_block->next->prev = new_block;
 
-            return (uint8_t*)curr + sizeof(block_t);
+        curr->size = size;
+        curr->next = new_block;
+    }
+
+    curr->free = 0;
+    rover = curr->next ? curr->next : first_block;
+    return curr;
+}
+
+void* mini_malloc(size_t size) {
+    // Propriétaire par défaut : le processus du CPU 0, ou -1 si c'est le système
+    PCB *cur  = global_scheduler.running[0];
+    int owner = cur ? cur->pid : -1;
+    return mini_malloc_tagged(size, owner, MEM_TAG_GENERIC);
+}
+
+static void* heap_malloc(size_t size, int owner, mem_tag_t tag) {
+    if (size == 0 || !first_block)
+        return NULL;
+
+    size = align_size(size);
+
+    block_t* curr = heap_find_and_split(size);
+
+    /* Échec : si assez d'octets libres au total, c'est de la fragmentation
+     * externe -> on compacte et on retente une fois. */
+    if (!curr && auto_compact) {
+        memory_stats_t st;
+        heap_stats(&st);
+        if (st.free_bytes >= size) {
+            heap_compact(NULL);
+            curr = heap_find_and_split(size);
         }
-        curr = curr->next;
+    }
+
+    if (curr) {
+        curr->owner  = owner;
+        curr->tag    = (short)tag;
+        curr->cached = 0;
+        USAGE_LOCK();
+        usage_add(owner, curr->size);
+        USAGE_UNLOCK();
+
+        // --- DEBUT LOG ALLOCATION ---
+        TRACE_EVENT(TRACE_CAT_MEM,
+                global_scheduler.current_time,
+                owner,
+                EV_MEMORY,
+                ST_ALLOC,
+                RS_VALUE,   // Raison = taille du bloc alloué (arg)
+                -1,
+                Q_MEM,
+                (int64_t)curr->size
+        );
+        // --- FIN LOG ALLOCATION ---
+
+        return (uint8_t*)curr + sizeof(block_t);
     }
 
     /* Plus de place disponible. */
     return NULL;
 }
 
-void mini_free(void* ptr) {
+static void heap_free(void* ptr) {
     if (!ptr || !first_block)
         return;
 
     block_t* block = ptr_to_block(ptr);
 
     /* Vérifie que l’adresse pointe bien dans le heap simulé. */
-    if ((uint8_t*)block < heap || (uint8_t*)block >= heap + HEAP_SIZE)
+    if ((uint8_t*)block < heap || (uint8_t*)block >= heap + heap_size)
         return;  // pointeur invalide -> on ignore ou on log
 
-    /* Vérifie que ce bloc appartient bien à notre free list. */
-    block_t* curr = first_block;
-    block_t* prev = NULL;
-    int found = 0;
-
-    while (curr) {
-        if (curr == block) {
-            found = 1;
-            break;
-        }
-        prev = curr;
-        curr = curr->next;
-    }
-
-    if (!found)
+    /* Vérifie que l'en-tête est bien celui d'un bloc vivant :
+     * l'en-tête porte une sentinelle, pas besoin de reparcourir la liste. */
+    if (((uintptr_t)ptr & (sizeof(void*) - 1)) != 0 || block->magic != BLOCK_MAGIC)
         return;  // bloc inconnu -> on ignore
+    if (block->prev ? block->prev->next != block : first_block != block)
+        return;  // sentinelle trouvée dans des données utilisateur
 
     /* Protection contre double free. */
     if (block->free)
         return;
 
-    // --- DEBUT LOG FREE (Avant de fusionner, pour avoir la bonne taille) ---
-    int owner = (global_scheduler.current) ? global_scheduler.current->pid : -1;
-    char size_str[32];
-    sprintf(size_str, "%zu", block->size);
+    USAGE_LOCK();
+    usage_remove(block->owner, block->size);
+    USAGE_UNLOCK();
 
-    trace_event(
+    // --- DEBUT LOG FREE (Avant de fusionner, pour avoir la bonne taille) ---
+    TRACE_EVENT(TRACE_CAT_MEM,
             global_scheduler.current_time,
-            owner,
-            "MEMORY",
-            "FREE",
-            size_str, // Raison = taille en octets
+            block->owner,
+            EV_MEMORY,
+            ST_FREE,
+            RS_VALUE,   // Raison = taille en octets (arg)
             -1,
-            "MEM"
+            Q_MEM,
+            (int64_t)block->size
     );
     // --- FIN LOG FREE ---
 
     /* Marque le bloc comme libre. */
     block->free = 1;
+    release_epoch++;
 
     /* Fusion avec le bloc suivant s’il est libre. */
-    if (block->next && block->next->free) {
-        block->size += sizeof(block_t) + block->next->size;
-        block->next  = block->next->next;
+    block_t* next = block->next;
+    if (next && next->free) {
+        block->size += sizeof(block_t) + next->size;
+        block->next  = next->next;
+        if (block->next) block->next->prev = block;
+        next->magic  = 0;
+        if (rover == next) rover = block;
     }
 
     /* Fusion avec le bloc précédent s’il est libre. */
+    block_t* prev = block->prev;
     if (prev && prev->free) {
         prev->size += sizeof(block_t) + block->size;
         prev->next  = block->next;
+        if (prev->next) prev->next->prev = prev;
+        block->magic = 0;
+        if (rover == block) rover = prev;
+    }
+}
+
+void* mini_malloc_tagged(size_t size, int owner, mem_tag_t tag) {
+    if (size == 0)
+        return NULL;
+
+    if (concurrent && tcache_enabled && align_size(size) <= TCACHE_MAX_SIZE) {
+        return tcache_alloc(align_size(size), owner, tag);
+    }
+
+    HEAP_LOCK();
+    void* ptr = heap_malloc(size, owner, tag);
+    HEAP_UNLOCK();
+    return ptr;
+}
+
+void mini_free(void* ptr) {
+    if (!ptr)
+        return;
+
+    if (concurrent && tcache_enabled && tcache_free(ptr)) {
+        return;
     }
+
+    HEAP_LOCK();
+    heap_free(ptr);
+    HEAP_UNLOCK();
 }
 
 /* Affichage propre : liste des blocs (état du heap simulé). */
 void memory_dump(void) {
+    HEAP_LOCK();
     block_t* curr = first_block;
     int index = 0;
 
-    printf("=== HEAP STATE (%zu MiB) ===\n", HEAP_SIZE / (1024u * 1024u));
+    printf("=== HEAP STATE (%zu MiB) ===\n", heap_size / (1024u * 1024u));
 
     while (curr) {
         printf("Bloc %d : %s | ",
@@ -203,32 +607,18 @@ void memory_dump(void) {
     }
 
     printf("================================\n");
+    HEAP_UNLOCK();
 }
 
-void memory_dump_with_processes(struct PCB **tasks, int nb_tasks) {
+void memory_dump_with_processes(void) {
+    HEAP_LOCK();
     block_t* curr = first_block;
     int index = 0;
 
     printf("=== HEAP STATE BY PROCESS (%zu MiB) ===\n",
-           HEAP_SIZE / (1024u * 1024u));
+           heap_size / (1024u * 1024u));
 
     while (curr) {
-        // Pointeur "utilisateur" (ce que mini_malloc renvoie)
-        void *payload = (uint8_t*)curr + sizeof(block_t);
-        int owner_pid = -1;
-
-        // On cherche quel process possède ce bloc (si c'est un bloc USED)
-        if (!curr->free && tasks && nb_tasks > 0) {
-            for (int i = 0; i < nb_tasks; ++i) {
-                struct PCB *p = tasks[i];
-                if (!p) continue;
-                if (p->mem_base == payload) {
-                    owner_pid = p->pid;
-                    break;
-                }
-            }
-        }
-
         printf("Bloc %d : %s | ",
                index,
                curr->free ? "FREE" : "USED");
@@ -236,11 +626,12 @@ void memory_dump_with_processes(struct PCB **tasks, int nb_tasks) {
         print_human_size(curr->size);
 
         if (!curr->free) {
-            if (owner_pid != -1) {
-                printf(" | PID=%d", owner_pid);
+            if (curr->owner != -1) {
+                printf(" | PID=%d", curr->owner);
             } else {
-                printf(" | PID=?");
+                printf(" | PID=SYS");
             }
+            printf(" [%s]", memory_tag_to_str((mem_tag_t)curr->tag));
         } else {
             printf(" | FREE");
         }
@@ -251,5 +642,597 @@ void memory_dump_with_processes(struct PCB **tasks, int nb_tasks) {
         index++;
     }
 
+    memory_stats_t st;
+    heap_stats(&st);
+    printf("Libre : ");
+    print_human_size(st.free_bytes);
+    printf(" en %d bloc(s) | plus grand : ", st.free_blocks);
+    print_human_size(st.largest_free);
+    printf(" | fragmentation externe : %.1f %%\n", st.external_frag * 100.0);
+
     printf("=======================================\n");
-}
\ No newline at end of file
+    HEAP_UNLOCK();
+}
+/************************************************************
+   Propriétaires & dumps machine
+ ************************************************************/
+
+const char* memory_tag_to_str(mem_tag_t tag) {
+    switch (tag) {
+        case MEM_TAG_GENERIC: return "GENERIC";
+        case MEM_TAG_IMAGE:   return "IMAGE";
+        case MEM_TAG_ARENA:   return "ARENA";
+        case MEM_TAG_HEAP:    return "HEAP";
+        case MEM_TAG_SYNC:    return "SYNC";
+        default:              return "?";
+    }
+}
+
+static int usage_of(int pid, memory_usage_t *out) {
+    usage_entry_t *e = usage_find(pid);
+    if (out) {
+        out->pid    = pid;
+        out->bytes  = e ? e->bytes  : 0;
+        out->blocks = e ? e->blocks : 0;
+    }
+    return e ? 0 : -1;
+}
+
+size_t memory_rss(int pid) {
+    USAGE_LOCK();
+    usage_entry_t *e = usage_find(pid);
+    size_t bytes = e ? e->bytes : 0;
+    USAGE_UNLOCK();
+    return bytes;
+}
+
+static void heap_dump_csv(FILE *out) {
+    if (!out) return;
+
+    fprintf(out, "index,offset,size,state,pid,tag\n");
+
+    long index = 0;
+    for (block_t* curr = first_block; curr; curr = curr->next, ++index) {
+        size_t offset = (size_t)((uint8_t*)curr - heap);
+        if (curr->free) {
+            fprintf(out, "%ld,%zu,%zu,FREE,,\n", index, offset, curr->size);
+        } else {
+            fprintf(out, "%ld,%zu,%zu,USED,%d,%s\n", index, offset, curr->size,
+                    curr->owner, memory_tag_to_str((mem_tag_t)curr->tag));
+        }
+    }
+}
+
+static void usage_dump_csv(FILE *out) {
+    if (!out) return;
+
+    fprintf(out, "pid,bytes,blocks\n");
+    for (size_t i = 0; i < usage_capacity; ++i) {
+        if (usage_tab[i].blocks == 0) continue;
+        fprintf(out, "%d,%zu,%d\n",
+                usage_tab[i].pid, usage_tab[i].bytes, usage_tab[i].blocks);
+    }
+}
+
+
+/************************************************************
+   Fragmentation, handles & compaction
+ ************************************************************/
+
+void memory_set_strategy(memory_strategy_t s) {
+    HEAP_LOCK();
+    strategy = s;
+    rover    = first_block;
+    HEAP_UNLOCK();
+}
+
+memory_strategy_t memory_get_strategy(void) {
+    return strategy;
+}
+
+const char* memory_strategy_to_str(memory_strategy_t s) {
+    switch (s) {
+        case MEM_FIT_FIRST: return "first-fit";
+        case MEM_FIT_NEXT:  return "next-fit";
+        case MEM_FIT_BEST:  return "best-fit";
+        default:            return "?";
+    }
+}
+
+unsigned long memory_release_epoch(void) {
+    HEAP_LOCK();
+    unsigned long epoch = release_epoch;
+    HEAP_UNLOCK();
+    return epoch;
+}
+
+size_t memory_max_alloc(void) {
+    return heap_size - sizeof(block_t);
+}
+
+void memory_set_auto_compact(int enabled) {
+    auto_compact = enabled ? 1 : 0;
+}
+
+static void heap_stats(memory_stats_t *out) {
+    if (!out) return;
+
+    memset(out, 0, sizeof(*out));
+    out->heap_size     = heap_size;
+    out->compactions   = compact_count;
+    out->compact_moved = compact_moved_total;
+    out->compact_ticks = compact_ticks_total;
+
+    for (block_t* curr = first_block; curr; curr = curr->next) {
+        if (curr->free) {
+            out->free_bytes += curr->size;
+            out->free_blocks++;
+            out->free_hist[frag_bucket(curr->size)]++;
+            if (curr->size > out->largest_free)
+                out->largest_free = curr->size;
+        } else {
+            out->used_bytes += curr->size;
+            out->used_blocks++;
+        }
+    }
+
+    if (out->free_bytes > 0) {
+        out->external_frag = 1.0 - (double)out->largest_free / (double)out->free_bytes;
+    }
+}
+
+static int handle_register(void **slot) {
+    if (!slot) return -1;
+
+    /* Garde le taux de remplissage (tombstones comprises) sous 50 %. */
+    if ((handle_used + 1) * 2 > handle_capacity) {
+        size_t cap = handle_capacity ? handle_capacity : 64;
+        while ((handle_count + 1) * 2 > cap) cap *= 2;
+        if (handle_rehash(cap) != 0) return -1;
+    }
+
+    size_t mask = handle_capacity - 1;
+    size_t j = handle_hash(slot) & mask;
+    long   reuse = -1;
+
+    while (handle_slots[j] != HANDLE_EMPTY) {
+        if (handle_slots[j] == slot) return 0;      // déjà présent
+        if (handle_slots[j] == HANDLE_TOMBSTONE && reuse < 0) reuse = (long)j;
+        j = (j + 1) & mask;
+    }
+
+    if (reuse >= 0) {
+        j = (size_t)reuse;
+    } else {
+        handle_used++;
+    }
+    handle_slots[j] = slot;
+    handle_count++;
+    return 0;
+}
+
+static void handle_unregister(void **slot) {
+    if (!slot || handle_capacity == 0) return;
+
+    size_t mask = handle_capacity - 1;
+    size_t j = handle_hash(slot) & mask;
+
+    while (handle_slots[j] != HANDLE_EMPTY) {
+        if (handle_slots[j] == slot) {
+            handle_slots[j] = HANDLE_TOMBSTONE;
+            handle_count--;
+            return;
+        }
+        j = (j + 1) & mask;
+    }
+}
+
+static int heap_compact(memory_compact_report_t *out) {
+    memory_compact_report_t rep;
+    memset(&rep, 0, sizeof(rep));
+
+    if (!first_block) {
+        if (out) *out = rep;
+        return 0;
+    }
+
+    /* 1) Inventaire des blocs USED (triés par adresse car la liste l'est). */
+    long n = 0;
+    for (block_t* c = first_block; c; c = c->next) {
+        if (c->free) {
+            if (c->size > rep.largest_before) rep.largest_before = c->size;
+        } else {
+            n++;
+        }
+    }
+
+    uint8_t  **payloads = NULL;
+    size_t    *sizes    = NULL;
+    ptrdiff_t *deltas   = NULL;
+    uint8_t   *movable  = NULL;
+
+    if (n > 0) {
+        payloads = malloc((size_t)n * sizeof(*payloads));
+        sizes    = malloc((size_t)n * sizeof(*sizes));
+        deltas   = calloc((size_t)n, sizeof(*deltas));
+        movable  = calloc((size_t)n, sizeof(*movable));
+        if (!payloads || !sizes || !deltas || !movable) {
+            free(payloads); free(sizes); free(deltas); free(movable);
+            if (out) *out = rep;
+            return 0;
+        }
+
+        long i = 0;
+        for (block_t* c = first_block; c; c = c->next) {
+            if (c->free) continue;
+            payloads[i] = (uint8_t*)c + sizeof(block_t);
+            sizes[i]    = c->size;
+            i++;
+        }
+
+        /* 2) Un bloc est déplaçable s'il est référencé par un handle. */
+        for (size_t h = 0; h < handle_capacity; ++h) {
+            void **slot = handle_slots[h];
+            if (slot == HANDLE_EMPTY || slot == HANDLE_TOMBSTONE || !*slot) continue;
+            long b = find_block_index(payloads, sizes, n, (const uint8_t*)*slot);
+            if (b >= 0) movable[b] = 1;
+        }
+    }
+
+    /* 3) Glissement des blocs vers le bas. dst = où doit commencer le
+     * prochain en-tête ; les blocs libres rencontrés sont absorbés. */
+    uint8_t*  dst  = heap;
+    block_t*  prev = NULL;
+    block_t*  curr = first_block;
+    long      idx  = 0;
+
+    first_block = NULL;
+
+    while (curr) {
+        block_t* next = curr->next;
+
+        if (curr->free) {
+            curr = next;
+            continue;
+        }
+
+        block_t* placed;
+        size_t   span = sizeof(block_t) + curr->size;
+
+        if (movable[idx] && (uint8_t*)curr != dst) {
+            memmove(dst, curr, span);
+            placed = (block_t*)dst;
+            deltas[idx] = dst - (uint8_t*)curr;
+            rep.moved_blocks++;
+            rep.moved_bytes += span;
+        } else {
+            if (!movable[idx]) rep.pinned_blocks++;
+
+            /* Bloc épinglé : le trou [dst, curr) redevient un bloc libre. */
+            if ((uint8_t*)curr > dst) {
+                block_t* gap = (block_t*)dst;
+                gap->size = (size_t)((uint8_t*)curr - dst) - sizeof(block_t);
+                gap->free = 1;
+                gap->magic = BLOCK_MAGIC;
+                if (prev) prev->next = gap; else first_block = gap;
+                prev = gap;
+                if (gap->size > rep.largest_after) rep.largest_after = gap->size;
+            }
+            placed = curr;
+        }
+
+        if (prev) prev->next = placed; else first_block = placed;
+        prev = placed;
+        dst  = (uint8_t*)placed + span;
+        idx++;
+        curr = next;
+    }
+
+    /* Tout l'espace restant forme un seul bloc libre final. */
+    if (dst < heap + heap_size) {
+        block_t* tail = (block_t*)dst;
+        tail->size = (size_t)(heap + heap_size - dst) - sizeof(block_t);
+        tail->free = 1;
+        tail->magic = BLOCK_MAGIC;
+        if (prev) prev->next = tail; else first_block = tail;
+        prev = tail;
+        if (tail->size > rep.largest_after) rep.largest_after = tail->size;
+    }
+    if (prev) prev->next = NULL;
+
+    rover = first_block;
+
+    /* Chaînage arrière reconstruit en une passe. */
+    prev = NULL;
+    for (block_t* c = first_block; c; c = c->next) {
+        c->prev = prev;
+        prev = c;
+    }
+
+    /* 4) Mise à jour des handles (pointeurs intérieurs compris). */
+    if (rep.moved_blocks > 0) {
+        for (size_t h = 0; h < handle_capacity; ++h) {
+            void **slot = handle_slots[h];
+            if (slot == HANDLE_EMPTY || slot == HANDLE_TOMBSTONE || !*slot) continue;
+            long b = find_block_index(payloads, sizes, n, (const uint8_t*)*slot);
+            if (b >= 0 && deltas[b] != 0) {
+                *slot = (uint8_t*)*slot + deltas[b];
+            }
+        }
+    }
+
+    free(payloads); free(sizes); free(deltas); free(movable);
+
+    /* 5) Coût simulé : recopie des octets + 1 tick de parcours. */
+    rep.cost_ticks = 1 + (int)((rep.moved_bytes + MEMORY_COMPACT_BYTES_PER_TICK - 1)
+                               / MEMORY_COMPACT_BYTES_PER_TICK);
+
+    compact_count++;
+    compact_moved_total += rep.moved_bytes;
+    compact_ticks_total += rep.cost_ticks;
+
+    TRACE_EVENT(TRACE_CAT_MEM,
+            global_scheduler.current_time,
+            -1,
+            EV_MEMORY,
+            ST_COMPACT,
+            RS_VALUE,   // Raison = coût en ticks (arg)
+            -1,
+            Q_MEM,
+            rep.cost_ticks
+    );
+
+    if (out) *out = rep;
+    return rep.cost_ticks;
+}
+
+
+/************************************************************
+   Mode concurrent : caches par thread
+ ************************************************************/
+
+/* Classe exacte d'une taille (alignée), -1 si ce n'est pas une classe. */
+static int tcache_class_exact(size_t size) {
+    for (int c = 0; c < TCACHE_CLASSES; ++c) {
+        if (tcache_sizes[c] == size) return c;
+    }
+    return -1;
+}
+
+/* Plus petite classe >= size. */
+static int tcache_class_for(size_t size) {
+    for (int c = 0; c < TCACHE_CLASSES; ++c) {
+        if (tcache_sizes[c] >= size) return c;
+    }
+    return -1;
+}
+
+/* Rend une chaîne de blocs au heap (verrou du heap pris par l'appelant). */
+static void heap_release_chain(void* head) {
+    while (head) {
+        void* next = *(void**)head;
+        heap_free(head);
+        head = next;
+    }
+}
+
+static void tcache_flush_current(void) {
+    HEAP_LOCK();
+    for (int c = 0; c < TCACHE_CLASSES; ++c) {
+        heap_release_chain(tcache.head[c]);
+        tcache.head[c]  = NULL;
+        tcache.count[c] = 0;
+    }
+    HEAP_UNLOCK();
+}
+
+static void tcache_thread_exit(void* arg) {
+    (void)arg;
+    tcache_flush_current();
+}
+
+static void tcache_global_init(void) {
+    pthread_key_create(&tcache_key, tcache_thread_exit);
+    for (int c = 0; c < TCACHE_CLASSES; ++c) {
+        pthread_mutex_init(&depots[c].lock, NULL);
+        depots[c].head  = NULL;
+        depots[c].count = 0;
+    }
+}
+
+/* Installe (une fois par thread) le vidage automatique en fin de thread. */
+static void tcache_register_thread(void) {
+    pthread_once(&tcache_once, tcache_global_init);
+    if (!tcache.registered) {
+        tcache.registered = 1;
+        pthread_setspecific(tcache_key, &tcache);
+    }
+}
+
+/* Remplit le cache d'une classe : d'abord le dépôt, sinon un lot
+ * découpé dans le heap sous un seul verrouillage. */
+static void tcache_refill(int c) {
+    tc_depot_t* d = &depots[c];
+
+    pthread_mutex_lock(&d->lock);
+    for (int i = 0; i < TCACHE_BATCH && d->head; ++i) {
+        void* blk = d->head;
+        d->head = *(void**)blk;
+        d->count--;
+        *(void**)blk = tcache.head[c];
+        tcache.head[c] = blk;
+        tcache.count[c]++;
+    }
+    pthread_mutex_unlock(&d->lock);
+
+    if (tcache.count[c] > 0) return;
+
+    HEAP_LOCK();
+    for (int i = 0; i < TCACHE_BATCH; ++i) {
+        void* blk = heap_malloc(tcache_sizes[c], MEM_OWNER_TCACHE, MEM_TAG_GENERIC);
+        if (!blk) break;
+        ptr_to_block(blk)->cached = 1;
+        *(void**)blk = tcache.head[c];
+        tcache.head[c] = blk;
+        tcache.count[c]++;
+    }
+    HEAP_UNLOCK();
+}
+
+/* Le bloc servi est marqué à son propriétaire (en-tête et index d'usage)
+ * comme un bloc pris dans le heap. */
+static void* tcache_alloc(size_t size, int owner, mem_tag_t tag) {
+    int c = tcache_class_for(size);
+    if (c < 0) return NULL;
+
+    tcache_register_thread();
+
+    if (!tcache.head[c]) {
+        tcache_refill(c);
+        if (!tcache.head[c]) return NULL;
+    }
+
+    void* blk = tcache.head[c];
+    tcache.head[c] = *(void**)blk;
+    tcache.count[c]--;
+
+    block_t* block = ptr_to_block(blk);
+    block->owner = owner;
+    block->tag   = (short)tag;
+    usage_move(MEM_OWNER_TCACHE, owner, block->size);
+    return blk;
+}
+
+/* Rend un lot de TCACHE_BATCH blocs : au dépôt s'il a de la place,
+ * sinon directement au heap. */
+static void tcache_spill(int c) {
+    void* batch = NULL;
+    for (int i = 0; i < TCACHE_BATCH && tcache.head[c]; ++i) {
+        void* blk = tcache.head[c];
+        tcache.head[c] = *(void**)blk;
+        tcache.count[c]--;
+        *(void**)blk = batch;
+        batch = blk;
+    }
+
+    tc_depot_t* d = &depots[c];
+    pthread_mutex_lock(&d->lock);
+    if (d->count + TCACHE_BATCH <= DEPOT_MAX) {
+        while (batch) {
+            void* next = *(void**)batch;
+            *(void**)batch = d->head;
+            d->head = batch;
+            d->count++;
+            batch = next;
+        }
+    }
+    pthread_mutex_unlock(&d->lock);
+
+    if (batch) {
+        HEAP_LOCK();
+        heap_release_chain(batch);
+        HEAP_UNLOCK();
+    }
+}
+
+/* Chemin rapide de mini_free : 1 si le bloc a été pris par le cache. */
+static int tcache_free(void* ptr) {
+    block_t* block = ptr_to_block(ptr);
+
+    if ((uint8_t*)block < heap || (uint8_t*)block >= heap + heap_size)
+        return 0;
+    if (((uintptr_t)ptr & (sizeof(void*) - 1)) != 0 ||
+        block->magic != BLOCK_MAGIC || block->free || !block->cached)
+        return 0;
+
+    int c = tcache_class_exact(block->size);
+    if (c < 0) return 0;
+
+    tcache_register_thread();
+
+    usage_move(block->owner, MEM_OWNER_TCACHE, block->size);
+    block->owner = MEM_OWNER_TCACHE;
+    block->tag   = MEM_TAG_GENERIC;
+
+    *(void**)ptr = tcache.head[c];
+    tcache.head[c] = ptr;
+    tcache.count[c]++;
+
+    if (tcache.count[c] > TCACHE_BIN_MAX) {
+        tcache_spill(c);
+    }
+    return 1;
+}
+
+void memory_thread_flush(void) {
+    if (!concurrent) return;
+    tcache_flush_current();
+}
+
+void memory_set_concurrent(int enabled, int thread_cache) {
+    pthread_once(&tcache_once, tcache_global_init);
+
+    if (concurrent && !enabled) {
+        /* Retour au mode simple : le thread appelant est supposé seul,
+         * on vide son cache et les dépôts. */
+        tcache_flush_current();
+        for (int c = 0; c < TCACHE_CLASSES; ++c) {
+            heap_release_chain(depots[c].head);
+            depots[c].head  = NULL;
+            depots[c].count = 0;
+        }
+    }
+
+    concurrent     = enabled ? 1 : 0;
+    tcache_enabled = thread_cache ? 1 : 0;
+}
+
+
+/************************************************************
+   Points d'entrée publics verrouillés
+ ************************************************************/
+
+void memory_get_stats(memory_stats_t *out) {
+    HEAP_LOCK();
+    heap_stats(out);
+    HEAP_UNLOCK();
+}
+
+int memory_compact(memory_compact_report_t *out) {
+    HEAP_LOCK();
+    int cost = heap_compact(out);
+    HEAP_UNLOCK();
+    return cost;
+}
+
+int memory_handle_register(void **slot) {
+    HEAP_LOCK();
+    int rc = handle_register(slot);
+    HEAP_UNLOCK();
+    return rc;
+}
+
+void memory_handle_unregister(void **slot) {
+    HEAP_LOCK();
+    handle_unregister(slot);
+    HEAP_UNLOCK();
+}
+
+int memory_usage_of(int pid, memory_usage_t *out) {
+    USAGE_LOCK();
+    int rc = usage_of(pid, out);
+    USAGE_UNLOCK();
+    return rc;
+}
+
+void memory_dump_csv(FILE *out) {
+    HEAP_LOCK();
+    heap_dump_csv(out);
+    HEAP_UNLOCK();
+}
+
+void memory_usage_dump_csv(FILE *out) {
+    USAGE_LOCK();
+    usage_dump_csv(out);
+    USAGE_UNLOCK();
+}
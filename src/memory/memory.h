@@ -3,14 +3,52 @@
 #ifndef MINIOS_MEMORY_H
 #define MINIOS_MEMORY_H
 #include <stddef.h>  // size_t
+#include <stdio.h>   // FILE
 struct PCB;   // déclaration incomplète, pour utiliser PCB* sans l'inclure
 
+/* Stratégies de placement de mini_malloc(). */
+typedef enum {
+    MEM_FIT_FIRST = 0,   // premier bloc libre assez grand (défaut)
+    MEM_FIT_NEXT,        // idem, en repartant du dernier bloc alloué
+    MEM_FIT_BEST,        // plus petit bloc libre assez grand
+    MEM_FIT_COUNT
+} memory_strategy_t;
+
+/* Nature d'une allocation (portée par l'en-tête du bloc). */
+typedef enum {
+    MEM_TAG_GENERIC = 0, // mini_malloc() sans précision
+    MEM_TAG_IMAGE,       // zone principale d'un processus (mem_base)
+    MEM_TAG_ARENA,       // arène de process_alloc
+    MEM_TAG_HEAP,        // process_alloc hors arène
+    MEM_TAG_SYNC,        // noeuds d'attente mutex / sémaphore
+    MEM_TAG_COUNT
+} mem_tag_t;
+
+/* Propriétaire des petits blocs détenus par les caches par thread
+ * (mode concurrent, cf. memory_set_concurrent). */
+#define MEM_OWNER_TCACHE (-2)
+
+/* Consommation d'un processus sur le heap simulé. */
+typedef struct memory_usage {
+    int    pid;
+    size_t bytes;        // octets utiles des blocs possédés (RSS)
+    int    blocks;       // nombre de blocs possédés
+} memory_usage_t;
+
 /**
  * Initialise le heap simulé.
  * À appeler une fois au démarrage du MiniOS.
  */
 void memory_init(void);
 
+/**
+ * Taille du heap simulé (64 MiB par défaut, au moins 64 KiB), conservée
+ * par memory_init qui doit être rappelé ensuite. Retourne 0, ou -1 si la
+ * taille est trop petite ou la zone impossible à allouer.
+ */
+int memory_set_heap_size(size_t bytes);
+size_t memory_heap_size(void);
+
 /**
  * Allocation dynamique dans le heap simulé.
  * Équivalent simplifié de malloc().
@@ -20,6 +58,20 @@ void memory_init(void);
  */
 void* mini_malloc(size_t size);
 
+/**
+ * Variante de mini_malloc() qui fixe explicitement le propriétaire
+ * (PID, -1 = système) et la nature du bloc. mini_malloc() attribue le
+ * bloc au processus courant avec MEM_TAG_GENERIC.
+ */
+void* mini_malloc_tagged(size_t size, int owner, mem_tag_t tag);
+
+/**
+ * Choix de la stratégie de placement (conservée par memory_init).
+ */
+void memory_set_strategy(memory_strategy_t s);
+memory_strategy_t memory_get_strategy(void);
+const char* memory_strategy_to_str(memory_strategy_t s);
+
 /**
  * Libération d’un bloc alloué par mini_malloc().
  * Équivalent simplifié de free().
@@ -39,11 +91,156 @@ void memory_dump(void);
  */
 void memory_visual_dump(void);
 /**
- * Affiche l'état du heap en annotant chaque bloc USED
- * avec le PID du processus qui possède ce bloc (si connu).
+ * Affiche l'état du heap en annotant chaque bloc USED avec son PID
+ * propriétaire et sa nature (lus dans l'en-tête, parcours O(blocs)).
+ */
+void memory_dump_with_processes(void);
+
+/**
+ * Consommation courante d'un processus, en O(1) (index par PID tenu
+ * à jour par mini_malloc / mini_free).
+ * @return 0 si le processus possède au moins un bloc, -1 sinon
+ *         (out est alors rempli avec des zéros).
  */
-void memory_dump_with_processes(struct PCB **tasks, int nb_tasks);
+int memory_usage_of(int pid, memory_usage_t *out);
 
+/** Raccourci : octets possédés par pid (0 si aucun). */
+size_t memory_rss(int pid);
 
+/**
+ * Dumps lisibles par machine (CSV) :
+ *  - memory_dump_csv       : un bloc par ligne
+ *                            index,offset,size,state,pid,tag
+ *  - memory_usage_dump_csv : une ligne par propriétaire pid,bytes,blocks
+ */
+void memory_dump_csv(FILE *out);
+void memory_usage_dump_csv(FILE *out);
+
+const char* memory_tag_to_str(mem_tag_t tag);
+
+
+/************************************************************
+   Fragmentation & compaction
+ ************************************************************/
+
+/* Nombre de classes de l'histogramme des blocs libres.
+ * Classe k : blocs de taille [2^(k+4), 2^(k+5)) octets,
+ * la première absorbe tout ce qui est < 32 B et la dernière
+ * tout ce qui dépasse. */
+#define MEMORY_FRAG_BUCKETS 24
+
+/* Coût simulé d'une compaction : nombre d'octets recopiés par tick. */
+#define MEMORY_COMPACT_BYTES_PER_TICK (64u * 1024u)
+
+/* Photographie de l'état du heap (calculée à la demande). */
+typedef struct memory_stats {
+    size_t heap_size;        // taille totale du heap (en-têtes compris)
+    size_t used_bytes;       // octets utiles dans les blocs USED
+    size_t free_bytes;       // octets utiles dans les blocs FREE
+    size_t largest_free;     // plus grand bloc libre (ce qu'on peut encore allouer d'un coup)
+    int    used_blocks;
+    int    free_blocks;
+    double external_frag;    // 1 - largest_free / free_bytes (0 = pas de fragmentation)
+    int    free_hist[MEMORY_FRAG_BUCKETS];
+
+    /* Cumuls depuis memory_init() */
+    int    compactions;      // nombre de passes de compaction
+    size_t compact_moved;    // octets déplacés au total
+    int    compact_ticks;    // coût simulé total (ticks)
+} memory_stats_t;
+
+/* Résultat d'une passe de compaction. */
+typedef struct memory_compact_report {
+    int    moved_blocks;     // blocs relogés
+    size_t moved_bytes;      // octets recopiés (en-têtes compris)
+    int    pinned_blocks;    // blocs USED laissés en place (aucun handle connu)
+    size_t largest_before;   // plus grand bloc libre avant / après
+    size_t largest_after;
+    int    cost_ticks;       // coût simulé de la passe
+} memory_compact_report_t;
+
+/**
+ * Calcule les métriques de fragmentation du heap (parcours O(blocs)).
+ */
+void memory_get_stats(memory_stats_t *out);
+
+/**
+ * Enregistre un "handle" : l'adresse d'un pointeur (hors heap simulé)
+ * qui référence un bloc alloué par mini_malloc (ex : &p->mem_base).
+ *
+ * Seuls les blocs référencés par au moins un handle sont déplaçables :
+ * lors d'une compaction, le bloc est relogé et *slot est mis à jour
+ * (pointeurs intérieurs au bloc compris). Les autres blocs USED
+ * restent épinglés à leur adresse.
+ *
+ * @return 0 si OK, -1 si plus de mémoire hôte.
+ */
+int memory_handle_register(void **slot);
+
+/**
+ * Retire un handle de la table (à faire avant de libérer le bloc
+ * ou la structure qui contient le pointeur).
+ */
+void memory_handle_unregister(void **slot);
+
+/**
+ * Passe de compaction : fait glisser les blocs déplaçables vers le début
+ * du heap pour regrouper l'espace libre, met à jour les handles et trace
+ * un événement MEMORY/COMPACT dont la raison est le coût en ticks.
+ *
+ * @param out : rapport détaillé (peut être NULL)
+ * @return coût simulé de la passe, en ticks.
+ */
+int memory_compact(memory_compact_report_t *out);
+
+/**
+ * Compteur de libérations : change à chaque mini_free() effectif.
+ * Permet de savoir à peu de frais si de la place a pu se libérer
+ * depuis la dernière tentative d'allocation (admission mémoire).
+ */
+unsigned long memory_release_epoch(void);
+
+/**
+ * Plus grosse allocation possible sur un heap vide.
+ */
+size_t memory_max_alloc(void);
+
+/**
+ * Active / désactive la compaction automatique : quand mini_malloc()
+ * échoue alors qu'il reste assez d'octets libres au total, on compacte
+ * puis on retente une fois.
+ */
+void memory_set_auto_compact(int enabled);
+
+
+
+/************************************************************
+   Mode concurrent (threads hôtes)
+ ************************************************************/
+
+/**
+ * Rend le heap utilisable depuis plusieurs threads hôtes (simulation
+ * parallèle, logger asynchrone, ...).
+ *
+ * - enabled      : toutes les opérations passent par un verrou central.
+ * - thread_cache : les petites allocations (<= 256 o, 8 classes) sont
+ *                  servies par un cache propre à chaque thread, rempli et
+ *                  vidé par lots de 32 via un dépôt par classe (verrou par
+ *                  classe) ; le verrou du heap n'est pris que pour les
+ *                  lots qui vont ou viennent réellement du heap.
+ *
+ * Les blocs en cache appartiennent au propriétaire MEM_OWNER_TCACHE ;
+ * un bloc servi par le cache prend le PID et la nature demandés (RSS et
+ * index d'usage exacts), mais ses allocations ne sont pas tracées. À appeler quand un seul thread
+ * utilise le heap ; en désactivant, le cache de l'appelant et les dépôts
+ * sont rendus au heap.
+ */
+void memory_set_concurrent(int enabled, int thread_cache);
+
+/**
+ * Rend au heap le cache du thread appelant (fait automatiquement à la
+ * fin de chaque thread).
+ */
+void memory_thread_flush(void);
 
 #endif //MINIOS_MEMORY_H
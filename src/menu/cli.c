@@ -0,0 +1,359 @@
+#include "cli.h"
+#include "../trace/logger.h"
+#include "../io/disk.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+void cli_default_options(cli_options_t *opt) {
+    memset(opt, 0, sizeof(*opt));
+    opt->policy       = SCHED_PRIORITY;
+    opt->quantum      = 2;
+    opt->cpus         = 1;
+    opt->workload     = CLI_WORKLOAD_SCENARIO;
+    opt->trace_path   = CLI_DEFAULT_TRACE;
+    opt->trace_format = -1;
+    opt->trace_mask   = TRACE_CAT_ALL;
+    opt->disk_sched   = -1;
+    opt->heap_dump_tick = -1;
+    io_irq_default_config(&opt->irq_config);
+    nic_default_config(&opt->nic_config);
+    workload_synth_default_config(&opt->synth);
+    trace_flight_default_config(&opt->flight);
+}
+
+void cli_usage(FILE *out, const char *prog) {
+    fprintf(out,
+        "Usage : %s [options]   (sans argument : menu interactif)\n"
+        "\n"
+        "Charge (une seule) :\n"
+        "  --workload FICHIER     fichier de charge .csv / .jsonl\n"
+        "  --replay TRACE         trace rejouee (.csv / .mtrace / .ctrace)\n"
+        "  --synth GRAINE         charge synthetique\n"
+        "    --count N            processus generes (defaut 1000)\n"
+        "    --rate R             arrivees par tick (defaut 0.2)\n"
+        "    --bursty             arrivees en rafales (on/off)\n"
+        "\n"
+        "Ordonnancement :\n"
+        "  --policy rr|priority|prr   (defaut priority)\n"
+        "  --quantum N            quantum RR / PRR (defaut 2)\n"
+        "  --cpus N               CPU simules (1 a %d, defaut 1)\n"
+        "  --heap TAILLE          heap simule, suffixes K/M/G (defaut 64M)\n"
+        "  --io-channels LISTE    canaux par peripherique, ex. disk=4,network=8\n"
+        "                         (defaut printer=1,keyboard=1,mouse=2,disk=2,\n"
+        "                         screen=1,network=3)\n"
+        "  --disk fcfs|sstf|scan|clook|deadline\n"
+        "                         modele de disque (seek, rotation, transfert) ;\n"
+        "                         IO(DISK,n) = n blocs\n"
+        "    --disk-merge N       blocs max d'une fusion (defaut 256, 1 = aucune)\n"
+        "  --nic irq|napi         modele de carte reseau (lien, interlocuteur local,\n"
+        "                         anneaux) ; IO(NETWORK,n) = requete de n Ko\n"
+        "    --nic-link DEBIT,LAT Ko par tick et propagation en ticks (defaut 4,2)\n"
+        "    --nic-rings TX,RX    entrees des anneaux (defaut 64,64)\n"
+        "    --nic-drop           anneau plein : perte et reemission (defaut :\n"
+        "                         contre-pression)\n"
+        "  --irq HAUT,BAS         fins d'I/O par interruptions : HAUT ticks CPU par\n"
+        "                         interruption + BAS par completion (ex. 1,1)\n"
+        "    --irq-coalesce N,T   une interruption pour N completions, ou apres\n"
+        "                         T ticks d'attente (defaut 1,0 : aucune coalescence)\n"
+        "  --aio                  IO des programmes en asynchrone (SUBMIT, WAIT\n"
+        "                         avant l'I/O suivante) : calcul et I/O se recouvrent\n"
+        "\n"
+        "Trace :\n"
+        "  --trace CHEMIN|none    defaut " CLI_DEFAULT_TRACE "\n"
+        "  --trace-format csv|binary|compact|chrome   (defaut : extension)\n"
+        "  --trace-mask LISTE     sched,mem,io,sync | all | none\n"
+        "  --trace-compress 0-9   niveau zlib des traces compactes\n"
+        "  --flight CHEMIN[,N[,SEUIL]]\n"
+        "                         flight recorder au lieu de la trace : garde les N\n"
+        "                         derniers evenements (defaut 65536) et les ecrit dans\n"
+        "                         CHEMIN-NNN.<ext> sur OOM, ou sur une attente READY /\n"
+        "                         BLOCKED de plus de SEUIL ticks\n"
+        "\n"
+        "Sorties :\n"
+        "  --stats FICHIER|-      bilan CSV (une ligne par run, ajoutee au fichier)\n"
+        "  --heap-dump PREFIXE[,TICK]\n"
+        "                         etat du heap en CSV a TICK (defaut : fin) :\n"
+        "                         PREFIXE.blocks.csv (un bloc par ligne) et\n"
+        "                         PREFIXE.owners.csv (octets par processus)\n"
+        "  --viz                  lance tools/gantt_plotly.py sur la trace en fin\n"
+        "                         de simulation (--no-viz : non, le defaut)\n"
+        "  --quiet                ni dumps du heap ni bilan detaille\n"
+        "  -h, --help\n"
+        "\n"
+        "Code de sortie : 0 = ok, 1 = arguments / fichiers invalides,\n"
+        "2 = charge interrompue (ligne invalide...).\n",
+        prog, SCHED_MAX_CPUS);
+}
+
+static int bad(const char *opt, const char *value) {
+    fprintf(stderr, "miniOS: valeur invalide pour %s : '%s' (--help)\n", opt, value);
+    return -1;
+}
+
+static bool to_int(const char *s, int min, int max, int *out) {
+    char *end;
+    long  x = strtol(s, &end, 10);
+    if (end == s || *end != '\0' || x < min || x > max) return false;
+    *out = (int)x;
+    return true;
+}
+
+/* Taille en octets, suffixes K / M / G */
+static bool to_size(const char *s, size_t *out) {
+    char              *end;
+    unsigned long long x = strtoull(s, &end, 10);
+    if (end == s || *s == '-') return false;
+
+    unsigned long long unit = 1;
+    switch (toupper((unsigned char)*end)) {
+        case 'K': unit = 1ull << 10; end++; break;
+        case 'M': unit = 1ull << 20; end++; break;
+        case 'G': unit = 1ull << 30; end++; break;
+        default:  break;
+    }
+    if (*end != '\0' || x > (unsigned long long)SIZE_MAX / unit) return false;
+    *out = (size_t)(x * unit);
+    return true;
+}
+
+/* "disk=4,network=8" : canaux par périphérique, les autres inchangés */
+static bool parse_channels(const char *s, int *channels) {
+    while (*s) {
+        const char *eq = strchr(s, '=');
+        if (!eq) return false;
+
+        char   name[16];
+        size_t len = (size_t)(eq - s);
+        if (len == 0 || len >= sizeof(name)) return false;
+        memcpy(name, s, len);
+        name[len] = '\0';
+        int dev = io_device_from_str(name);
+        if (dev < 0) return false;
+
+        char *end;
+        long  n = strtol(eq + 1, &end, 10);
+        if (end == eq + 1 || n < 1 || n > IO_MAX_CHANNELS) return false;
+        if (*end != ',' && *end != '\0') return false;
+        channels[dev] = (int)n;
+
+        s = (*end == ',') ? end + 1 : end;
+    }
+    return true;
+}
+
+/* "a,b" : deux entiers >= 0 */
+static bool parse_pair(const char *s, int *a, int *b) {
+    char *end;
+    long  x = strtol(s, &end, 10);
+    if (end == s || *end != ',' || x < 0 || x > 1000000000) return false;
+    const char *t = end + 1;
+    long        y = strtol(t, &end, 10);
+    if (end == t || *end != '\0' || y < 0 || y > 1000000000) return false;
+    *a = (int)x;
+    *b = (int)y;
+    return true;
+}
+
+/* "chemin[,événements[,seuil]]" (--flight) */
+static bool parse_flight(const char *s, cli_options_t *opt) {
+    const char *comma = strchr(s, ',');
+    size_t      len   = comma ? (size_t)(comma - s) : strlen(s);
+    if (len == 0 || len >= sizeof(opt->flight_path)) return false;
+    memcpy(opt->flight_path, s, len);
+    opt->flight_path[len] = '\0';
+    if (!comma) return true;
+
+    char *end;
+    long  n = strtol(comma + 1, &end, 10);
+    if (end == comma + 1 || n < 1 || n > (1L << 24)) return false;
+    opt->flight.capacity = (size_t)n;
+    if (*end == '\0') return true;
+    if (*end != ',') return false;
+
+    int threshold;
+    if (!to_int(end + 1, 1, 1000000000, &threshold)) return false;
+    opt->flight.latency_threshold = threshold;
+    opt->flight.block_threshold   = threshold;
+    return true;
+}
+
+/* "préfixe[,tick]" (--heap-dump) */
+static bool parse_heap_dump(const char *s, cli_options_t *opt) {
+    const char *comma = strchr(s, ',');
+    size_t      len   = comma ? (size_t)(comma - s) : strlen(s);
+    if (len == 0 || len >= sizeof(opt->heap_dump)) return false;
+    memcpy(opt->heap_dump, s, len);
+    opt->heap_dump[len] = '\0';
+    return !comma || to_int(comma + 1, 0, 2147483647, &opt->heap_dump_tick);
+}
+
+static int parse_policy(const char *s, SchedulingPolicy *out) {
+    if (strcmp(s, "rr") == 0 || strcmp(s, "1") == 0)       *out = SCHED_ROUND_ROBIN;
+    else if (strcmp(s, "priority") == 0 || strcmp(s, "2") == 0) *out = SCHED_PRIORITY;
+    else if (strcmp(s, "prr") == 0 || strcmp(s, "3") == 0) *out = SCHED_P_RR;
+    else return -1;
+    return 0;
+}
+
+static int parse_format(const char *s) {
+    if (strcmp(s, "csv") == 0)     return TRACE_FORMAT_CSV;
+    if (strcmp(s, "binary") == 0)  return TRACE_FORMAT_BINARY;
+    if (strcmp(s, "compact") == 0) return TRACE_FORMAT_COMPACT;
+    if (strcmp(s, "chrome") == 0)  return TRACE_FORMAT_CHROME;
+    return -1;
+}
+
+static int set_workload(cli_options_t *opt, cli_workload_t kind, const char *path) {
+    if (opt->workload != CLI_WORKLOAD_SCENARIO) {
+        fprintf(stderr, "miniOS: une seule charge parmi --workload / --replay / --synth\n");
+        return -1;
+    }
+    opt->workload      = kind;
+    opt->workload_path = path;
+    return 0;
+}
+
+int cli_parse(int argc, char **argv, cli_options_t *opt) {
+    bool synth_opts = false;
+
+    cli_default_options(opt);
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+
+        /* Options sans valeur */
+        if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0) {
+            cli_usage(stdout, argv[0]);
+            return 1;
+        }
+        if (strcmp(a, "--viz") == 0)    { opt->viz    = true;  continue; }
+        if (strcmp(a, "--no-viz") == 0) { opt->viz    = false; continue; }
+        if (strcmp(a, "--quiet") == 0)  { opt->quiet  = true; continue; }
+        if (strcmp(a, "--aio") == 0)    { opt->aio    = true; continue; }
+        if (strcmp(a, "--nic-drop") == 0) {
+            opt->nic_config.drop = true;
+            opt->nic_opts = true;
+            continue;
+        }
+        if (strcmp(a, "--bursty") == 0) {
+            opt->synth.arrival = SYNTH_ARRIVAL_BURSTY;
+            synth_opts = true;
+            continue;
+        }
+
+        /* Options à valeur */
+        if (strncmp(a, "--", 2) != 0 || i + 1 >= argc) {
+            fprintf(stderr, "miniOS: argument inattendu '%s' (--help)\n", a);
+            return -1;
+        }
+        const char *v = argv[++i];
+
+        if (strcmp(a, "--policy") == 0) {
+            if (parse_policy(v, &opt->policy) < 0) return bad(a, v);
+        } else if (strcmp(a, "--quantum") == 0) {
+            if (!to_int(v, 1, 1000000000, &opt->quantum)) return bad(a, v);
+        } else if (strcmp(a, "--cpus") == 0) {
+            if (!to_int(v, 1, SCHED_MAX_CPUS, &opt->cpus)) return bad(a, v);
+        } else if (strcmp(a, "--workload") == 0) {
+            if (set_workload(opt, CLI_WORKLOAD_FILE, v) < 0) return -1;
+        } else if (strcmp(a, "--replay") == 0) {
+            if (set_workload(opt, CLI_WORKLOAD_REPLAY, v) < 0) return -1;
+        } else if (strcmp(a, "--synth") == 0) {
+            char *end;
+            opt->synth.seed = strtoull(v, &end, 10);
+            if (end == v || *end != '\0' || *v == '-') return bad(a, v);
+            if (set_workload(opt, CLI_WORKLOAD_SYNTH, NULL) < 0) return -1;
+        } else if (strcmp(a, "--count") == 0) {
+            int n;
+            if (!to_int(v, 1, 2147483647, &n)) return bad(a, v);
+            opt->synth.count = n;
+            synth_opts = true;
+        } else if (strcmp(a, "--rate") == 0) {
+            char *end;
+            opt->synth.rate = strtod(v, &end);
+            if (end == v || *end != '\0' || !(opt->synth.rate > 0)) return bad(a, v);
+            synth_opts = true;
+        } else if (strcmp(a, "--trace") == 0) {
+            opt->trace_path = (strcmp(v, "none") == 0) ? NULL : v;
+        } else if (strcmp(a, "--trace-format") == 0) {
+            if ((opt->trace_format = parse_format(v)) < 0) return bad(a, v);
+        } else if (strcmp(a, "--trace-mask") == 0) {
+            int m = trace_parse_mask(v);
+            if (m < 0) return bad(a, v);
+            opt->trace_mask = (unsigned)m;
+        } else if (strcmp(a, "--trace-compress") == 0) {
+            if (!to_int(v, 0, 9, &opt->trace_compression)) return bad(a, v);
+        } else if (strcmp(a, "--flight") == 0) {
+            if (!parse_flight(v, opt)) return bad(a, v);
+        } else if (strcmp(a, "--heap") == 0) {
+            if (!to_size(v, &opt->heap_size)) return bad(a, v);
+        } else if (strcmp(a, "--disk") == 0) {
+            if ((opt->disk_sched = disk_sched_from_str(v)) < 0) return bad(a, v);
+        } else if (strcmp(a, "--disk-merge") == 0) {
+            if (!to_int(v, 1, 1000000000, &opt->disk_merge)) return bad(a, v);
+        } else if (strcmp(a, "--nic") == 0) {
+            int m = nic_rx_mode_from_str(v);
+            if (m < 0) return bad(a, v);
+            opt->nic_config.rx_mode = (nic_rx_mode_t)m;
+            opt->nic = true;
+        } else if (strcmp(a, "--nic-link") == 0) {
+            if (!parse_pair(v, &opt->nic_config.bandwidth, &opt->nic_config.latency) ||
+                opt->nic_config.bandwidth < 1) {
+                return bad(a, v);
+            }
+            opt->nic_opts = true;
+        } else if (strcmp(a, "--nic-rings") == 0) {
+            if (!parse_pair(v, &opt->nic_config.tx_ring, &opt->nic_config.rx_ring) ||
+                opt->nic_config.tx_ring < 1 || opt->nic_config.rx_ring < 1) {
+                return bad(a, v);
+            }
+            opt->nic_opts = true;
+        } else if (strcmp(a, "--irq") == 0) {
+            if (!parse_pair(v, &opt->irq_config.top_half, &opt->irq_config.bottom_half)) {
+                return bad(a, v);
+            }
+            opt->irq = true;
+        } else if (strcmp(a, "--irq-coalesce") == 0) {
+            if (!parse_pair(v, &opt->irq_config.coalesce_count, &opt->irq_config.coalesce_ticks) ||
+                opt->irq_config.coalesce_count < 1) {
+                return bad(a, v);
+            }
+            opt->irq_coalesce = true;
+        } else if (strcmp(a, "--io-channels") == 0) {
+            if (!parse_channels(v, opt->io_channels)) return bad(a, v);
+        } else if (strcmp(a, "--heap-dump") == 0) {
+            if (!parse_heap_dump(v, opt)) return bad(a, v);
+        } else if (strcmp(a, "--stats") == 0) {
+            opt->stats_path = v;
+        } else {
+            fprintf(stderr, "miniOS: option inconnue '%s' (--help)\n", a);
+            return -1;
+        }
+    }
+
+    if (opt->workload == CLI_WORKLOAD_SCENARIO) {
+        fprintf(stderr, "miniOS: charge manquante (--workload, --replay ou --synth)\n");
+        return -1;
+    }
+    if (opt->flight_path[0]) opt->trace_path = NULL;   // l'anneau remplace la trace
+    if (opt->disk_merge > 0 && opt->disk_sched < 0) {
+        fprintf(stderr, "miniOS: --disk-merge demande --disk\n");
+        return -1;
+    }
+    if (opt->nic_opts && !opt->nic) {
+        fprintf(stderr, "miniOS: --nic-link / --nic-rings / --nic-drop demandent --nic\n");
+        return -1;
+    }
+    if (opt->irq_coalesce && !opt->irq) {
+        fprintf(stderr, "miniOS: --irq-coalesce demande --irq\n");
+        return -1;
+    }
+    if (synth_opts && opt->workload != CLI_WORKLOAD_SYNTH) {
+        fprintf(stderr, "miniOS: --count / --rate / --bursty demandent --synth\n");
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef MINIOS_CLI_H
+#define MINIOS_CLI_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../scheduler/scheduler.h"
+#include "../workload/synth.h"
+#include "../io/io.h"
+#include "../io/nic.h"
+#include "../trace/logger.h"
+
+/*
+ * Mode sans menu (scripts, campagnes de benchmarks) : miniOS lancé avec
+ * des arguments ne pose aucune question. Voir cli_usage pour la liste.
+ *
+ * Code de sortie : 0 = simulation complète, 1 = arguments ou fichiers
+ * invalides, 2 = charge interrompue en cours de route (ligne invalide...).
+ */
+
+/* Origine des processus */
+typedef enum {
+    CLI_WORKLOAD_SCENARIO = 0,   // scénario interactif (menu uniquement)
+    CLI_WORKLOAD_REPLAY,         // trace rejouée
+    CLI_WORKLOAD_FILE,           // fichier .csv / .jsonl
+    CLI_WORKLOAD_SYNTH           // charge synthétique
+} cli_workload_t;
+
+#define CLI_DEFAULT_TRACE "tools/trace/trace.csv"
+
+typedef struct cli_options {
+    SchedulingPolicy        policy;
+    int                     quantum;         // RR / P_RR
+    int                     cpus;
+
+    cli_workload_t          workload;
+    const char             *workload_path;   // REPLAY / FILE
+    workload_synth_config_t synth;           // SYNTH
+
+    const char             *trace_path;      // NULL = pas de trace
+    int                     trace_format;    // trace_format_t, -1 = d'après l'extension
+    unsigned                trace_mask;      // TRACE_CAT_*
+    int                     trace_compression;
+    char                    flight_path[512]; // "" = pas de flight recorder (sinon remplace trace_path)
+    trace_flight_config_t   flight;
+
+    size_t                  heap_size;       // octets, 0 = défaut de memory.c
+    int                     io_channels[IO_DEVICE_COUNT]; // 0 = défaut de io.c
+    int                     disk_sched;      // disk_sched_t, -1 = pas de modèle de disque
+    int                     disk_merge;      // blocs max d'un groupe fusionné, 0 = défaut
+    bool                    nic;             // modèle de carte réseau (nic_config)
+    bool                    nic_opts;        // --nic-link / --nic-rings / --nic-drop donnés
+    nic_config_t            nic_config;
+    bool                    irq;             // modèle d'interruptions (irq_config)
+    bool                    irq_coalesce;    // --irq-coalesce donné
+    io_irq_config_t         irq_config;
+    const char             *stats_path;      // NULL = aucun, "-" = sortie standard
+    char                    heap_dump[512];  // préfixe des dumps CSV du heap, "" = aucun
+    int                     heap_dump_tick;  // instant du dump, -1 = fin de simulation
+    bool                    viz;             // lance gantt_plotly.py (menu seulement par défaut)
+    bool                    quiet;           // ni dumps du heap ni bilan détaillé
+    bool                    aio;             // IO des programmes rendues asynchrones
+} cli_options_t;
+
+/* Défauts : PRIORITY, quantum 2, 1 CPU, trace CLI_DEFAULT_TRACE, tout
+ * enregistré, heap par défaut, I/O disque à durée fixe, pas de stats,
+ * pas de visualisation (le menu interactif la lance). */
+void cli_default_options(cli_options_t *opt);
+
+/**
+ * Lit la ligne de commande. Retourne 0 si la simulation peut démarrer,
+ * 1 si l'aide a été affichée, -1 si un argument est invalide (message
+ * sur stderr).
+ */
+int cli_parse(int argc, char **argv, cli_options_t *opt);
+
+void cli_usage(FILE *out, const char *prog);
+
+#endif // MINIOS_CLI_H
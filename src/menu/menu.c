@@ -8,6 +8,9 @@ int menu_start_choice(void) {
     printf("==========================================\n");
     printf("1 - Lancer une nouvelle simulation interactive\n");
     printf("2 - Visualiser le graphique de DEMO (.csv)\n");
+    printf("3 - Rejouer une trace comme charge (autre politique)\n");
+    printf("4 - Charger un fichier de charge (.csv / .jsonl)\n");
+    printf("5 - Generer une charge synthetique (graine)\n");
     printf("Votre choix : ");
 
     if (scanf("%d", &choice) != 1) {
@@ -16,7 +19,7 @@ int menu_start_choice(void) {
         return 1; // Par défaut : simulation
     }
 
-    if (choice == 2) return 2;
+    if (choice >= 2 && choice <= 5) return choice;
     return 1;
 }
 
@@ -56,4 +59,70 @@ int menu_choose_quantum(void) {
         return 2;
     }
     return q;
-}
\ No newline at end of file
+}
+
+/* Demander un chemin de fichier (defaut si saisie invalide) */
+static void ask_path(const char *title, const char *prompt, const char *fallback,
+                     char *buf, int size)
+{
+    printf("\n=== %s ===\n", title);
+    printf("%s : ", prompt);
+
+    char path[256];
+    if (scanf("%255s", path) != 1) {
+        fprintf(stderr, "Chemin invalide, utilisation de %s.\n", fallback);
+        snprintf(path, sizeof(path), "%s", fallback);
+    }
+    snprintf(buf, (size_t)size, "%s", path);
+}
+
+/* Demander la trace a rejouer */
+void menu_choose_trace(char *buf, int size) {
+    ask_path("Rejeu d'une trace", "Chemin de la trace (.csv / .mtrace / .ctrace)",
+             "tools/trace/demo.csv", buf, size);
+}
+
+/* Demander le fichier de charge */
+void menu_choose_workload(char *buf, int size) {
+    ask_path("Fichier de charge", "Chemin du fichier (.csv / .jsonl)",
+             "tools/workload/example.csv", buf, size);
+}
+
+/* Parametres principaux de la charge synthetique */
+void menu_choose_synth(workload_synth_config_t *cfg) {
+    workload_synth_default_config(cfg);
+
+    printf("\n=== Charge synthetique ===\n");
+
+    unsigned long long seed = 0;
+    printf("Graine (entier) : ");
+    if (scanf("%llu", &seed) != 1) {
+        fprintf(stderr, "Graine invalide, 42 par defaut.\n");
+        seed = 42;
+    }
+    cfg->seed = seed;
+
+    long count = 0;
+    printf("Nombre de processus (> 0) : ");
+    if (scanf("%ld", &count) != 1 || count <= 0) {
+        fprintf(stderr, "Nombre invalide, %ld par defaut.\n", cfg->count);
+    } else {
+        cfg->count = count;
+    }
+
+    int mode = 1;
+    printf("Arrivees : 1 = Poisson, 2 = en rafales (on/off) : ");
+    if (scanf("%d", &mode) != 1 || (mode != 1 && mode != 2)) {
+        fprintf(stderr, "Choix invalide, Poisson par defaut.\n");
+        mode = 1;
+    }
+    cfg->arrival = (mode == 2) ? SYNTH_ARRIVAL_BURSTY : SYNTH_ARRIVAL_POISSON;
+
+    double rate = 0;
+    printf("Debit d'arrivee (processus par tick, > 0) : ");
+    if (scanf("%lf", &rate) != 1 || !(rate > 0)) {
+        fprintf(stderr, "Debit invalide, %.2f par defaut.\n", cfg->rate);
+    } else {
+        cfg->rate = rate;
+    }
+}
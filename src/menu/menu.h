@@ -2,15 +2,37 @@
 #define MINIOS_MENU_H
 
 #include "../scheduler/scheduler.h"
+#include "../workload/synth.h"
 
 /**
  * Affiche le menu de démarrage :
  * 1. Lancer une simulation
  * 2. Voir la démo (fichier CSV statique)
- * Retourne 1 ou 2.
+ * 3. Rejouer une trace comme charge
+ * 4. Charger un fichier de charge
+ * 5. Générer une charge synthétique
+ * Retourne 1 à 5.
  */
 int menu_start_choice(void);
 
+/**
+ * Demande le chemin de la trace à rejouer (buf de taille size).
+ * Défaut : tools/trace/demo.csv.
+ */
+void menu_choose_trace(char *buf, int size);
+
+/**
+ * Demande le chemin du fichier de charge (cf. workload_file.h).
+ * Défaut : tools/workload/example.csv.
+ */
+void menu_choose_workload(char *buf, int size);
+
+/**
+ * Demande graine, nombre de processus, type d'arrivées et débit ; les
+ * autres paramètres gardent les défauts de workload_synth_default_config.
+ */
+void menu_choose_synth(workload_synth_config_t *cfg);
+
 SchedulingPolicy menu_choose_policy(void);
 int menu_choose_quantum(void);
 
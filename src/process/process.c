@@ -4,9 +4,13 @@
 #include "../scheduler/scheduler.h"
 #include "../trace/logger.h"
 #include "../memory/memory.h"   // adapte le chemin/nom si besoin
+#include "../sync/mutex.h"
+#include "../io/io.h"
 
 static int next_pid = 1;  // compteur de PID
 
+static size_t arena_size = PROCESS_ARENA_DEFAULT_SIZE;  // taille des nouvelles arènes
+
 PCB *process_create(ProcessPriority priority,
                     int burst_time,
                     int arrival_time,
@@ -39,6 +43,11 @@ PCB *process_create(ProcessPriority priority,
     p->stack   = NULL;
     p->context = NULL;
 
+    /* ARÈNE (créée paresseusement par process_alloc) */
+    p->arena_base = NULL;
+    p->arena_size = 0;
+    p->arena_used = 0;
+
     /* MÉMOIRE ALLOUÉE (tableau d’allocs mini-malloc, optionnel) */
     p->allocations    = NULL;
     p->alloc_count    = 0;
@@ -48,31 +57,34 @@ PCB *process_create(ProcessPriority priority,
     p->blocked_until  = -1;
     p->waiting_for_io = false;
     p->io_device      = -1;  // par défaut : aucune I/O
-    p->io_duration    = 0;   // aucune I/O
-    p->io_start_time  = -1;  // -1 = pas de déclenchement prévu
+    p->disk_lba       = -1;
+
+    /* I/O ASYNCHRONES */
+    p->aio_inflight = 0;
+    p->aio_ready    = 0;
+    p->aio_wait_for = 0;
+
+    /* PROGRAMME (optionnel, cf. process_set_program) */
+    p->program     = NULL;
+    p->program_len = 0;
+    p->program_pc  = -1;
+    p->burst_left  = 0;
 
     /* SYNCHRO */
     p->waiting_on_mutex     = NULL;
     p->waiting_on_semaphore = NULL;
 
     /* MÉMOIRE PROCESSUS (zone principale) */
-    p->mem_size = mem_size;
+    p->mem_size       = mem_size;
+    p->mem_wait_since = -1;
     if (mem_size > 0) {
-        // Remplace mini_malloc par le nom réel si différent
-        p->mem_base = mini_malloc(mem_size);
-        if (p->mem_base == NULL) {
-            // Pas assez de mémoire : on peut marquer le process comme terminé
-            p->state = TERMINATED;
-            trace_event(
-                global_scheduler.current_time,
-                p->pid,
-                "CREATE_FAIL_OOM",
-                "TERMINATED",
-                "",
-                -1,
-                "NONE"
-            );
+        p->mem_base = mini_malloc_tagged(mem_size, p->pid, MEM_TAG_IMAGE);
+        if (p->mem_base != NULL) {
+            // mem_base suit le bloc si une compaction le déplace
+            memory_handle_register(&p->mem_base);
         }
+        // Sinon mem_base reste NULL : l'admission (admission_submit)
+        // retentera l'allocation et mettra le processus en attente.
     } else {
         p->mem_base = NULL;
     }
@@ -84,73 +96,195 @@ PCB *process_create(ProcessPriority priority,
     global_scheduler.total_processes++;
 
     /* Trace de création */
-    trace_event(
+    TRACE_EVENT(TRACE_CAT_SCHED,
         global_scheduler.current_time,
         p->pid,
-        "CREATE",
-        "NEW",
-        "",
+        EV_CREATE,
+        ST_NEW,
+        RS_NONE,
         -1,
-        "NEW"
+        Q_NEW,
+        0
     );
 
-    void *process_alloc(PCB *p, size_t size) {
-        if (!p || size == 0) {
-            return NULL;
-        }
+    return p;
+}
 
-        void *ptr = mini_malloc(size);
-        if (!ptr) {
-            return NULL;
-        }
+int process_set_program(PCB *p, const burst_t *bursts, int count) {
+    if (!p || !bursts || count <= 0) return -1;
 
-        // Initialisation du tableau d'allocations si besoin
-        if (p->alloc_capacity == 0) {
-            p->alloc_capacity = 4;
-            p->allocations = malloc(p->alloc_capacity * sizeof(void *));
-            if (!p->allocations) {
-                mini_free(ptr);
-                p->alloc_capacity = 0;
-                return NULL;
-            }
+    burst_t *prog = malloc((size_t)count * sizeof(burst_t));
+    if (!prog) return -1;
+
+    int n = 0, cpu_total = 0, last_cpu = -1;
+    for (int i = 0; i < count; ++i) {
+        burst_t b = bursts[i];
+
+        switch (b.kind) {
+            case BURST_CPU:
+            case BURST_IO:
+            case BURST_SUBMIT:
+                if (b.duration <= 0) continue;
+                break;
+            case BURST_WAIT:
+                if (b.arg < 0) goto invalid;
+                break;
+            case BURST_REAP:
+                break;
+            case BURST_LOCK:
+            case BURST_UNLOCK:
+                if (!mutex_shared(b.arg)) goto invalid;
+                break;
+            case BURST_ALLOC:
+                if (b.arg <= 0) goto invalid;
+                break;
+            case BURST_FREE:
+                break;
+            default:
+                goto invalid;
         }
-        // Agrandir le tableau si plein
-        else if (p->alloc_count >= p->alloc_capacity) {
-            int new_cap = p->alloc_capacity * 2;
-            void **new_tab = realloc(p->allocations, new_cap * sizeof(void *));
-            if (!new_tab) {
-                mini_free(ptr);
-                return NULL;
+        bool io = b.kind == BURST_IO || b.kind == BURST_SUBMIT;
+        if (io && (b.arg < 0 || b.arg >= IO_DEVICE_COUNT)) goto invalid;
+        if (b.lba < 0 || (b.lba > 0 && (!io || b.arg != IO_DEVICE_DISK))) goto invalid;
+
+        if (b.kind == BURST_CPU) {
+            cpu_total += b.duration;
+            if (n > 0 && prog[n - 1].kind == BURST_CPU) {
+                prog[n - 1].duration += b.duration;    // fusion
+                continue;
             }
-            p->allocations = new_tab;
-            p->alloc_capacity = new_cap;
+            last_cpu = n;
         }
+        prog[n++] = b;
+    }
+    if (cpu_total == 0) goto invalid;
+
+    /* Après le dernier calcul : seuls les UNLOCK et les WAIT (I/O
+     * asynchrones à attendre avant de finir) ont encore un sens */
+    int m = last_cpu + 1;
+    for (int i = last_cpu + 1; i < n; ++i) {
+        if (prog[i].kind == BURST_UNLOCK || prog[i].kind == BURST_WAIT) prog[m++] = prog[i];
+    }
+    n = m;
+
+    free(p->program);
+    p->program        = prog;
+    p->program_len    = n;
+    p->program_pc     = -1;
+    p->burst_left     = 0;
+    p->remaining_time = cpu_total;
+    return 0;
+
+invalid:
+    free(prog);
+    return -1;
+}
+
+void process_destroy(PCB *p) {
+    if (!p) return;
+    free(p->program);
+    free(p);
+}
+
+void process_set_arena_size(size_t size) {
+    arena_size = (size > 0) ? size : PROCESS_ARENA_DEFAULT_SIZE;
+}
+
+/* Allocation "bump" dans l'arène, créée au premier besoin. Ni l'arène ni
+ * les blocs de débordement ne sont des handles de compaction : l'appelant
+ * garde des pointeurs à l'intérieur, les blocs restent donc épinglés. */
+static void *arena_alloc(PCB *p, size_t size) {
+    const size_t align = sizeof(void*);
+    size = (size + align - 1) & ~(align - 1);
+
+    if (!p->arena_base) {
+        // Une allocation plus grosse que l'arène entière passe en débordement
+        if (size > arena_size) return NULL;
 
-        p->allocations[p->alloc_count++] = ptr;
+        p->arena_base = mini_malloc_tagged(arena_size, p->pid, MEM_TAG_ARENA);
+        if (!p->arena_base) return NULL;
+        p->arena_size = arena_size;
+        p->arena_used = 0;
+    }
+
+    if (size > p->arena_size - p->arena_used) {
+        return NULL;
+    }
+
+    void *ptr = (char *)p->arena_base + p->arena_used;
+    p->arena_used += size;
+    return ptr;
+}
+
+void *process_alloc(PCB *p, size_t size) {
+    if (!p || size == 0) {
+        return NULL;
+    }
+
+    void *ptr = arena_alloc(p, size);
+    if (ptr) {
         return ptr;
     }
 
-    void process_free_all(PCB *p) {
-        if (!p) return;
+    // Débordement : bloc individuel sur le heap
+    ptr = mini_malloc_tagged(size, p->pid, MEM_TAG_HEAP);
+    if (!ptr) {
+        return NULL;
+    }
 
-        // Libérer toutes les allocations enregistrées
-        for (int i = 0; i < p->alloc_count; ++i) {
-            if (p->allocations && p->allocations[i]) {
-                mini_free(p->allocations[i]);
-                p->allocations[i] = NULL;
-            }
+    // Initialisation du tableau d'allocations si besoin
+    if (p->alloc_capacity == 0) {
+        p->alloc_capacity = 4;
+        p->allocations = malloc(p->alloc_capacity * sizeof(void *));
+        if (!p->allocations) {
+            mini_free(ptr);
+            p->alloc_capacity = 0;
+            return NULL;
+        }
+    }
+    // Agrandir le tableau si plein
+    else if (p->alloc_count >= p->alloc_capacity) {
+        int new_cap = p->alloc_capacity * 2;
+        void **new_tab = realloc(p->allocations, new_cap * sizeof(void *));
+        if (!new_tab) {
+            mini_free(ptr);
+            return NULL;
         }
+        p->allocations = new_tab;
+        p->alloc_capacity = new_cap;
+    }
+
+    p->allocations[p->alloc_count] = ptr;
+    p->alloc_count++;
+    return ptr;
+}
 
-        p->alloc_count = 0;
+void process_free_all(PCB *p) {
+    if (!p) return;
 
-        // Libérer le tableau lui-même
-        if (p->allocations) {
-            free(p->allocations);
-            p->allocations = NULL;
+    // L'arène entière part en un seul mini_free
+    if (p->arena_base) {
+        mini_free(p->arena_base);
+        p->arena_base = NULL;
+        p->arena_size = 0;
+        p->arena_used = 0;
+    }
+
+    // Libérer les allocations hors arène
+    for (int i = 0; i < p->alloc_count; ++i) {
+        if (p->allocations && p->allocations[i]) {
+            mini_free(p->allocations[i]);
+            p->allocations[i] = NULL;
         }
+    }
 
-        p->alloc_capacity = 0;
+    p->alloc_count = 0;
+
+    // Libérer le tableau lui-même
+    if (p->allocations) {
+        free(p->allocations);
+        p->allocations = NULL;
     }
 
-    return p;
+    p->alloc_capacity = 0;
 }
@@ -4,6 +4,12 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+/* blocked_until des processus bloqués sans échéance (mutex, sémaphore...) */
+#define PCB_BLOCKED_FOREVER 1000000000
+
+/* Taille par défaut de l'arène d'un processus (cf. process_alloc). */
+#define PROCESS_ARENA_DEFAULT_SIZE (64u * 1024u)
+
 typedef enum {
     NEW = 0,
     READY,
@@ -18,6 +24,28 @@ typedef enum {
     PRIORITY_HIGH
 } ProcessPriority;
 
+/* Programme d'un processus : suite d'étapes (cf. process_set_program) */
+typedef enum {
+    BURST_CPU = 0,   // duration ticks de calcul
+    BURST_IO,        // I/O bloquante de duration ticks sur le périphérique arg
+    BURST_LOCK,      // prend le mutex partagé arg (bloquant, cf. mutex_shared)
+    BURST_UNLOCK,    // rend le mutex partagé arg
+    BURST_ALLOC,     // process_alloc de arg octets
+    BURST_FREE,      // rend tout ce qu'ont obtenu les ALLOC (process_free_all)
+    BURST_SUBMIT,    // I/O asynchrone (comme IO, sans bloquer, cf. io_submit_async)
+    BURST_WAIT,      // attend arg complétions asynchrones (0 = toutes) et les récolte
+    BURST_REAP       // récolte les complétions disponibles, sans bloquer
+} burst_kind_t;
+
+typedef struct burst {
+    int kind;        // burst_kind_t
+    int arg;         // io_device_t (IO, SUBMIT) / n° de mutex (LOCK, UNLOCK) / octets (ALLOC)
+                     // complétions attendues (WAIT)
+    int duration;    // ticks (CPU, IO) ; blocs pour IO sur DISK avec le modèle de disque
+    int lba;         // IO sur DISK : bloc de départ + 1 (0 = à la suite de la
+                     // précédente I/O disque du processus, cf. disk.h)
+} burst_t;
+
 typedef struct PCB {
     /* IDENTIFICATION */
     int pid;
@@ -30,6 +58,7 @@ typedef struct PCB {
     int arrival_time;        // temps où le processus entre dans le système
     int start_time;          // premier RUNNING
     int finish_time;         // moment TERMINATED
+    bool killed;             // terminé par l'admission (rejet, OOM-kill), pas à la fin de son travail
     int remaining_time;      // temps CPU restant (burst)
     int last_run_time;       // pour Round Robin / fairness
     int quantum_remaining;   // Pour Round Robin / ticks restants dans le quantum
@@ -38,17 +67,32 @@ typedef struct PCB {
     void *stack;             // pointeur vers la pile simulée
     void *context;           // registre / contexte (simulé car user-level)
 
-    /* MÉMOIRE ALLOUÉE (mini_malloc) — allocations multiples éventuelles */
+    /* ARÈNE (région unique carvée dans le heap simulé, allocation "bump") */
+    void  *arena_base;       // bloc mini_malloc de l'arène (NULL tant qu'inutilisée)
+    size_t arena_size;       // taille de la région
+    size_t arena_used;       // octets déjà distribués (pointeur de bump)
+
+    /* MÉMOIRE ALLOUÉE (mini_malloc) — allocations qui ne tiennent pas dans l'arène */
     void **allocations;      // tableau des pointeurs alloués via mini_malloc
     int alloc_count;         // nombre d’allocations
     int alloc_capacity;      // taille max du tableau
 
-    /* I/O BLOQUANTES */
+    /* I/O BLOQUANTES (lancées par les étapes IO du programme) */
     int  blocked_until;      // temps de réveil si I/O en attente
     bool waiting_for_io;     // true si en I/O, false sinon
-    int  io_device;          // code du périphérique I/O (ou -1 si aucune I/O)
-    int  io_duration;        // durée de l'I/O en ticks (0 = pas d’I/O)
-    int  io_start_time;      // tick global auquel lancer l'I/O (>=0, -1 = jamais)
+    int  io_device;          // périphérique de l'I/O en cours (ou -1)
+    int  disk_lba;           // bloc de la prochaine I/O disque sans adresse (-1 = zone à tirer)
+
+    /* I/O ASYNCHRONES (étapes SUBMIT / WAIT / REAP) */
+    int  aio_inflight;       // soumises, pas encore terminées
+    int  aio_ready;          // terminées, pas encore récoltées
+    int  aio_wait_for;       // WAIT en cours : complétions attendues (0 = aucun)
+
+    /* PROGRAMME (NULL = burst CPU unique) */
+    burst_t *program;
+    int      program_len;
+    int      program_pc;     // étape en cours (-1 = pas encore élu)
+    int      burst_left;     // ticks restants de la rafale CPU (0 = étape suivante)
 
     /* SYNCHRONISATION */
     void *waiting_on_mutex;      // mutex sur lequel il est bloqué
@@ -57,6 +101,7 @@ typedef struct PCB {
     /* MÉMOIRE PROPRE AU PROCESSUS (zone principale) */
     size_t mem_size;        // taille mémoire demandée pour ce process
     void *mem_base;         // pointeur / adresse renvoyée par le mini-malloc
+    int   mem_wait_since;   // tick d'entrée en attente mémoire (-1 sinon)
 
     /* CHAÎNAGE POUR LES FILES (READY, BLOCKED, etc.) */
     struct PCB *next;
@@ -76,17 +121,53 @@ PCB *process_create(ProcessPriority priority,
                     size_t mem_size);
 
 /**
- * Alloue un bloc de taille 'size' pour le processus p sur le mini-heap,
- * et enregistre ce pointeur dans p->allocations pour pouvoir tout
- * libérer facilement à la fin.
+ * Donne au processus un programme (copié) qui remplace son burst :
+ * remaining_time devient la somme des rafales CPU. Le scheduler exécute
+ * les étapes hors CPU quand le processus est élu et que la rafale CPU
+ * précédente est épuisée. Les rafales CPU consécutives sont fusionnées,
+ * les étapes vides ignorées, et après le dernier calcul seuls les UNLOCK
+ * et les WAIT restent (un processus finit sur le CPU, ou au réveil d'un WAIT
+ * final qui attend toutes ses I/O asynchrones ; scheduler_terminate joue
+ * ces UNLOCK et libère sa mémoire). Un ALLOC refusé (heap plein) est sauté et
+ * compté dans global_scheduler.alloc_failures.
+ * Retourne 0, ou -1 si plus de mémoire / étape invalide / aucun CPU.
+ */
+int process_set_program(PCB *p, const burst_t *bursts, int count);
+
+/**
+ * Libère le PCB et son programme (la mémoire simulée est rendue par
+ * scheduler_terminate).
+ */
+void process_destroy(PCB *p);
+
+/**
+ * Alloue 'size' octets pour le processus p.
+ *
+ * Les petites allocations sont servies par "bump pointer" dans l'arène
+ * du processus (créée au premier appel, cf. process_set_arena_size) :
+ * pas de parcours du heap, pas d'en-tête par allocation.
+ * Ce qui ne tient pas dans l'arène passe par mini_malloc() et est
+ * enregistré dans p->allocations.
+ *
+ * Les pointeurs rendus restent valides jusqu'à process_free_all, même
+ * après memory_compact : l'arène et les débordements ne sont pas des
+ * handles, la compaction les laisse épinglés à leur adresse (seul
+ * mem_base est déplaçable).
  */
 void *process_alloc(PCB *p, size_t size);
 
 /**
- * Libère toutes les allocations enregistrées dans p->allocations
- * (sauf mem_base, qui est gérée à part) et nettoie la structure.
+ * Libère toute la mémoire du processus obtenue via process_alloc :
+ * l'arène en une seule opération, plus les éventuels débordements
+ * de p->allocations (sauf mem_base, qui est gérée à part).
+ * Le coût ne dépend pas du nombre de petites allocations.
  */
 void process_free_all(PCB *p);
 
+/**
+ * Règle la taille des arènes créées ensuite (0 = taille par défaut).
+ */
+void process_set_arena_size(size_t size);
+
 
 #endif //MINIOS_PROCESS_H
@@ -0,0 +1,213 @@
+#include "program.h"
+#include "../io/io.h"
+#include "../sync/mutex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+typedef struct step_syntax {
+    const char *name;
+    int         kind;
+    int         nargs;
+    int         max_args;   // arguments facultatifs en fin de liste
+} step_syntax_t;
+
+static const step_syntax_t steps[] = {
+    { "CPU",    BURST_CPU,    1, 1 },
+    { "IO",     BURST_IO,     2, 3 },   // IO(DISK, n, lba)
+    { "LOCK",   BURST_LOCK,   1, 1 },
+    { "UNLOCK", BURST_UNLOCK, 1, 1 },
+    { "ALLOC",  BURST_ALLOC,  1, 1 },
+    { "FREE",   BURST_FREE,   0, 0 },
+    { "SUBMIT", BURST_SUBMIT, 2, 3 },   // comme IO, asynchrone
+    { "WAIT",   BURST_WAIT,   0, 1 },
+    { "REAP",   BURST_REAP,   0, 0 },
+};
+#define NSTEPS ((int)(sizeof(steps) / sizeof(steps[0])))
+
+static const step_syntax_t *step_named(const char *s, size_t len) {
+    for (int i = 0; i < NSTEPS; ++i) {
+        const char *n = steps[i].name;
+        if (strlen(n) != len) continue;
+
+        size_t k = 0;
+        while (k < len && toupper((unsigned char)s[k]) == n[k]) k++;
+        if (k == len) return &steps[i];
+    }
+    return NULL;
+}
+
+/* Entier positif ou nul, suffixes K / M si scaled */
+static bool parse_count(const char *s, bool scaled, int *out) {
+    char     *end;
+    long long x = strtoll(s, &end, 10);
+    if (end == s || x < 0) return false;
+
+    if (scaled && (*end == 'K' || *end == 'k')) { x *= 1024;        end++; }
+    else if (scaled && (*end == 'M' || *end == 'm')) { x *= 1024 * 1024; end++; }
+
+    if (*end != '\0' || x > 0x7FFFFFFF) return false;
+    *out = (int)x;
+    return true;
+}
+
+int program_parse(const char *text, burst_t *out, int max, const char **err) {
+    const char *p = text;
+    int         n = 0;
+
+    for (;;) {
+        while (isspace((unsigned char)*p) || *p == ';') p++;
+        if (*p == '\0') break;
+
+        const char *name = p;
+        while (isalpha((unsigned char)*p)) p++;
+        const step_syntax_t *st = step_named(name, (size_t)(p - name));
+        if (!st) {
+            *err = "etape inconnue (CPU, IO, LOCK, UNLOCK, ALLOC, FREE, SUBMIT, WAIT, REAP)";
+            return -1;
+        }
+
+        /* Arguments entre parenthèses (facultatives sans argument) */
+        char args[3][32] = { "", "", "" };
+        int  nargs = 0;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '(') {
+            p++;
+            for (;;) {
+                while (isspace((unsigned char)*p)) p++;
+                if (*p == ')' && nargs == 0) break;
+                if (nargs == st->max_args) {
+                    *err = "trop d'arguments";
+                    return -1;
+                }
+                size_t len = 0;
+                while (*p && *p != ',' && *p != ':' && *p != ')' && !isspace((unsigned char)*p)) {
+                    if (len + 1 < sizeof(args[0])) args[nargs][len++] = *p;
+                    p++;
+                }
+                args[nargs][len] = '\0';
+                nargs++;
+
+                while (isspace((unsigned char)*p)) p++;
+                if (*p == ',' || *p == ':') { p++; continue; }
+                if (*p == ')') break;
+                *err = "')' attendue";
+                return -1;
+            }
+            p++;
+        }
+        if (nargs < st->nargs || nargs > st->max_args) {
+            *err = "nombre d'arguments incorrect";
+            return -1;
+        }
+        if (n == max) {
+            *err = "programme trop long";
+            return -1;
+        }
+
+        burst_t b = { .kind = st->kind };
+        bool    ok = true;
+        switch (st->kind) {
+            case BURST_CPU:
+                ok = parse_count(args[0], false, &b.duration) && b.duration > 0;
+                break;
+            case BURST_IO:
+            case BURST_SUBMIT:
+                if (!parse_count(args[0], false, &b.arg)) b.arg = io_device_from_str(args[0]);
+                ok = b.arg >= 0 && b.arg < IO_DEVICE_COUNT &&
+                     parse_count(args[1], false, &b.duration) && b.duration > 0;
+                if (ok && nargs == 3) {   // adresse : disque uniquement
+                    ok = b.arg == IO_DEVICE_DISK && parse_count(args[2], false, &b.lba) &&
+                         b.lba < 0x7FFFFFFF;
+                    b.lba++;
+                }
+                break;
+            case BURST_LOCK:
+            case BURST_UNLOCK:
+                ok = parse_count(args[0], false, &b.arg) && mutex_shared(b.arg) != NULL;
+                break;
+            case BURST_ALLOC:
+                ok = parse_count(args[0], true, &b.arg) && b.arg > 0;
+                break;
+            case BURST_WAIT:
+                ok = nargs == 0 || parse_count(args[0], false, &b.arg);
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            *err = "argument invalide";
+            return -1;
+        }
+        out[n++] = b;
+    }
+    return n;
+}
+
+int program_format(const burst_t *prog, int count, char *buf, size_t size) {
+    int len = 0;
+    if (size > 0) buf[0] = '\0';
+
+    for (int i = 0; i < count; ++i) {
+        const burst_t *b   = &prog[i];
+        const char    *sep = i ? " " : "";
+        size_t         off = (size_t)len < size ? (size_t)len : size;
+        size_t         rem = size - off;
+        int            w;
+
+        switch (b->kind) {
+            case BURST_CPU:    w = snprintf(buf + off, rem, "%sCPU(%d)", sep, b->duration); break;
+            case BURST_IO:
+            case BURST_SUBMIT: {
+                const char *name = b->kind == BURST_IO ? "IO" : "SUBMIT";
+                const char *dev  = io_device_to_str((io_device_t)b->arg);
+                if (b->lba > 0) {
+                    w = snprintf(buf + off, rem, "%s%s(%s,%d,%d)", sep, name, dev,
+                                 b->duration, b->lba - 1);
+                } else {
+                    w = snprintf(buf + off, rem, "%s%s(%s,%d)", sep, name, dev, b->duration);
+                }
+                break;
+            }
+            case BURST_LOCK:   w = snprintf(buf + off, rem, "%sLOCK(%d)", sep, b->arg);      break;
+            case BURST_UNLOCK: w = snprintf(buf + off, rem, "%sUNLOCK(%d)", sep, b->arg);    break;
+            case BURST_ALLOC:  w = snprintf(buf + off, rem, "%sALLOC(%d)", sep, b->arg);     break;
+            case BURST_FREE:   w = snprintf(buf + off, rem, "%sFREE", sep);                  break;
+            case BURST_WAIT:
+                w = b->arg > 0 ? snprintf(buf + off, rem, "%sWAIT(%d)", sep, b->arg)
+                               : snprintf(buf + off, rem, "%sWAIT", sep);
+                break;
+            case BURST_REAP:   w = snprintf(buf + off, rem, "%sREAP", sep);                  break;
+            default:           w = snprintf(buf + off, rem, "%s?", sep);                     break;
+        }
+        len += w;
+    }
+    return len;
+}
+
+int program_to_async(const burst_t *prog, int count, burst_t *out, int max) {
+    static const burst_t wait = { .kind = BURST_WAIT };
+    bool pending = false;
+    int  n = 0;
+
+    for (int i = 0; i < count; ++i) {
+        burst_t b = prog[i];
+        if (b.kind == BURST_IO) {
+            if (pending) {
+                if (n == max) return -1;
+                out[n++] = wait;
+            }
+            b.kind  = BURST_SUBMIT;
+            pending = true;
+        }
+        if (n == max) return -1;
+        out[n++] = b;
+    }
+    if (pending) {
+        if (n == max) return -1;
+        out[n++] = wait;
+    }
+    return n;
+}
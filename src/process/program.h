@@ -0,0 +1,48 @@
+#ifndef MINIOS_PROGRAM_H
+#define MINIOS_PROGRAM_H
+
+#include <stddef.h>
+#include "process.h"
+
+/*
+ * Forme texte des programmes de processus (cf. process_set_program) :
+ * étapes séparées par des espaces ou des ';', arguments par ',' ou ':'.
+ *
+ *   CPU(n)        n ticks de calcul
+ *   IO(dev, d)    I/O bloquante de d ticks ; dev = nom (DISK...) ou code
+ *   IO(DISK, n, lba)  I/O disque adressée (modèle de disque : n blocs à
+ *                 partir du bloc lba ; sans lba, à la suite de la précédente)
+ *   LOCK(m)       prend le mutex partagé m (mutex_shared)
+ *   UNLOCK(m)     le rend
+ *   ALLOC(sz)     process_alloc de sz octets (suffixes K et M acceptés)
+ *   FREE          rend tout ce qu'ont obtenu les ALLOC
+ *   SUBMIT(dev, d[, lba])  comme IO, mais asynchrone : le processus continue
+ *   WAIT / WAIT(n)  attend toutes les I/O asynchrones (ou n complétions)
+ *   REAP          récolte les complétions disponibles sans bloquer
+ *
+ * ex : "LOCK(0) CPU(3) IO(DISK,5) ALLOC(64K) CPU(2) FREE UNLOCK(0) CPU(1)"
+ */
+
+#define PROGRAM_MAX_STEPS 256
+
+/**
+ * Lit un programme texte dans out (au plus max étapes). Retourne le nombre
+ * d'étapes, ou -1 avec *err pointant sur un message statique.
+ */
+int program_parse(const char *text, burst_t *out, int max, const char **err);
+
+/**
+ * Écrit le programme dans buf (même syntaxe, tronqué à size). Retourne la
+ * longueur complète, comme snprintf.
+ */
+int program_format(const burst_t *prog, int count, char *buf, size_t size);
+
+/**
+ * Copie le programme dans out en rendant ses I/O asynchrones : chaque IO
+ * devient un SUBMIT, et un WAIT est inséré avant l'IO suivante et en fin
+ * de programme. out doit pouvoir contenir 2 * count étapes. Retourne le
+ * nombre d'étapes écrites, ou -1 si max est trop petit.
+ */
+int program_to_async(const burst_t *prog, int count, burst_t *out, int max);
+
+#endif // MINIOS_PROGRAM_H
@@ -95,20 +95,21 @@ int scenario_build_interactive(PCB **out_tasks, int max_tasks, SchedulingPolicy
             io_choice = 0;
         }
 
+        int dev;
         switch (io_choice) {
-            case 1: p->io_device = IO_DEVICE_PRINTER;  break;
-            case 2: p->io_device = IO_DEVICE_KEYBOARD; break;
-            case 3: p->io_device = IO_DEVICE_MOUSE;    break;
-            case 4: p->io_device = IO_DEVICE_DISK;     break;
-            case 5: p->io_device = IO_DEVICE_SCREEN;   break;
-            case 6: p->io_device = IO_DEVICE_NETWORK;  break;
+            case 1: dev = IO_DEVICE_PRINTER;  break;
+            case 2: dev = IO_DEVICE_KEYBOARD; break;
+            case 3: dev = IO_DEVICE_MOUSE;    break;
+            case 4: dev = IO_DEVICE_DISK;     break;
+            case 5: dev = IO_DEVICE_SCREEN;   break;
+            case 6: dev = IO_DEVICE_NETWORK;  break;
             default:
-                p->io_device = -1;  // aucune I/O
+                dev = -1;  // aucune I/O
                 break;
         }
 
         /* SI UNE I/O EST PRÉVUE, DEMANDER DURÉE + MOMENT */
-        if (p->io_device != -1) {
+        if (dev != -1) {
             /* Durée de l'I/O */
             printf("Duree de l'I/O pour ce processus (en ticks) : ");
             int d = 0;
@@ -116,30 +117,26 @@ int scenario_build_interactive(PCB **out_tasks, int max_tasks, SchedulingPolicy
                 fprintf(stderr, "Duree invalide, 3 ticks utilises par defaut.\n");
                 d = 3;
             }
-            p->io_duration = d;
-
-            /* Moment de déclenchement (tick global) */
-            /* Moment de déclenchement (tick global) */
-            printf("Tick global auquel lancer l'I/O (>= 0) : ");
-            int t = 0;
-            if (scanf("%d", &t) != 1 || t < 0) {
-                fprintf(stderr, "Tick invalide, 3 utilise par defaut.\n");
-                t = 3;
-            }
 
-            /* On empêche une I/O avant l'arrivée du processus */
-            if (t < arrival) {
-                fprintf(stderr,
-                        "Tick d'I/O (%d) < arrival (%d), on decale a %d.\n",
-                        t, arrival, arrival);
-                t = arrival;
+            /* Moment de déclenchement : ticks de CPU effectués avant l'I/O */
+            printf("Ticks de CPU avant l'I/O (0 a %d) : ", burst - 1);
+            int k = 0;
+            if (scanf("%d", &k) != 1 || k < 0) {
+                fprintf(stderr, "Valeur invalide, 0 utilise par defaut.\n");
+                k = 0;
+            }
+            if (k > burst - 1) {
+                fprintf(stderr, "L'I/O doit preceder la fin du burst, on ramene a %d.\n",
+                        burst - 1);
+                k = burst - 1;
             }
 
-            p->io_start_time = t;
-
-        } else {
-            p->io_duration   = 0;
-            p->io_start_time = -1;  // aucune I/O prévue
+            const burst_t prog[] = {
+                { .kind = BURST_CPU, .duration = k },
+                { .kind = BURST_IO,  .arg = dev, .duration = d },
+                { .kind = BURST_CPU, .duration = burst - k },
+            };
+            process_set_program(p, prog, 3);
         }
 
         out_tasks[i] = p;
@@ -0,0 +1,315 @@
+#include "admission.h"
+
+#include <string.h>
+#include "scheduler.h"
+#include "../memory/memory.h"
+#include "../trace/logger.h"
+#include "../io/io.h"
+#include "../sync/mutex.h"
+#include "../sync/semaphore.h"
+
+static admission_order_t g_order  = ADMIT_FIFO;
+static oom_policy_t      g_policy = OOM_KILL_LARGEST_RSS;
+
+static unsigned long     g_seen_epoch = 0;     // dernière vague de mini_free vue
+static bool              g_dirty      = false; // nouvel arrivant en attente
+static admission_stats_t g_stats;
+
+/* ===================================================================== */
+/* OUTILS                                                                */
+/* ===================================================================== */
+
+/* Alloue la zone principale si besoin. true si le processus a sa mémoire. */
+static bool try_allocate(PCB *p) {
+    if (p->mem_size == 0 || p->mem_base != NULL) {
+        return true;
+    }
+
+    p->mem_base = mini_malloc_tagged(p->mem_size, p->pid, MEM_TAG_IMAGE);
+    if (p->mem_base == NULL) {
+        return false;
+    }
+    memory_handle_register(&p->mem_base);
+    return true;
+}
+
+static void park(PCB *p) {
+    PCBQueue *q = &global_scheduler.mem_wait_queue;
+
+    p->state          = BLOCKED;
+    p->mem_wait_since = global_scheduler.current_time;
+    pcb_queue_up(q, p);
+
+    g_stats.parked++;
+    if (q->size > g_stats.max_waiting) {
+        g_stats.max_waiting = q->size;
+    }
+    g_dirty = true;
+
+    TRACE_EVENT(TRACE_CAT_SCHED,
+            global_scheduler.current_time,
+            p->pid,
+            EV_STATE_CHANGE,
+            ST_BLOCKED,
+            RS_MEMORY,
+            -1,
+            Q_MEM_WAIT,
+            0
+    );
+}
+
+/* Demande impossible : le processus est terminé sans avoir tourné. */
+static void reject(PCB *p) {
+    g_stats.rejected++;
+
+    TRACE_EVENT(TRACE_CAT_SCHED,
+            global_scheduler.current_time,
+            p->pid,
+            EV_CREATE_FAIL_OOM,
+            ST_TERMINATED,
+            RS_NONE,
+            -1,
+            Q_NONE,
+            0
+    );
+
+    p->mem_size = 0;
+    p->killed   = true;
+    scheduler_terminate(p);
+}
+
+static void admit(PCB *p) {
+    g_stats.admitted_late++;
+    g_stats.wait_ticks += global_scheduler.current_time - p->mem_wait_since;
+    p->mem_wait_since = -1;
+    scheduler_add_ready(p);
+}
+
+/* Prochain candidat à l'admission selon l'ordre configuré. */
+static PCB *next_waiting(void) {
+    PCB *best = global_scheduler.mem_wait_queue.head;
+    if (g_order == ADMIT_PRIORITY) {
+        for (PCB *c = best; c; c = c->next) {
+            if (c->priority > best->priority) best = c;
+        }
+    }
+    return best;
+}
+
+/* Admet tout ce qui tient, dans l'ordre ; s'arrête au premier refus
+ * pour ne pas affamer les grosses demandes. */
+static int admit_waiting(void) {
+    int admitted = 0;
+    PCB *p;
+
+    while ((p = next_waiting()) != NULL) {
+        if (!try_allocate(p)) break;
+        pcb_queue_remove(&global_scheduler.mem_wait_queue, p);
+        admit(p);
+        admitted++;
+    }
+    return admitted;
+}
+
+/* Attendre bloquerait-il tout ? Oui si rien ne tourne, rien n'est prêt,
+ * aucun bloqué n'a de réveil daté, aucune I/O n'est en cours et aucun
+ * processus créé n'est encore en route (il pourrait libérer sa mémoire en
+ * terminant). */
+static bool deadlocked(void) {
+    for (int c = 0; c < global_scheduler.cpu_count; ++c) {
+        if (global_scheduler.running[c] != NULL) return false;
+    }
+
+    int in_system = global_scheduler.terminated_queue.size +
+                    global_scheduler.blocked_queue.size +
+                    global_scheduler.mem_wait_queue.size;
+
+    for (int i = 0; i < NUM_PRIORITIES; ++i) {
+        if (!pcb_queue_empty(&global_scheduler.ready_queues[i])) return false;
+    }
+
+    for (PCB *b = global_scheduler.blocked_queue.head; b; b = b->next) {
+        if (b->blocked_until < PCB_BLOCKED_FOREVER) return false;
+    }
+    if (io_pending()) return false;     // une fin d'I/O réveillera quelqu'un
+
+    return in_system >= global_scheduler.total_processes;
+}
+
+/* Compacte si l'espace libre total suffirait à la demande. */
+static bool compact_for(size_t need) {
+    memory_stats_t st;
+    memory_get_stats(&st);
+    if (st.free_bytes < need || st.largest_free >= need) {
+        return false;
+    }
+    memory_compact(NULL);
+    g_stats.compactions++;
+    return true;
+}
+
+/* true si a doit être tué plutôt que b selon la politique. */
+static bool worse_victim(PCB *a, size_t rss_a, PCB *b, size_t rss_b) {
+    switch (g_policy) {
+        case OOM_KILL_LOWEST_PRIORITY:
+            if (a->priority != b->priority) return a->priority < b->priority;
+            return rss_a > rss_b;
+        case OOM_KILL_YOUNGEST:
+            if (a->arrival_time != b->arrival_time) return a->arrival_time > b->arrival_time;
+            return a->pid > b->pid;
+        case OOM_KILL_LARGEST_RSS:
+        default:
+            if (rss_a != rss_b) return rss_a > rss_b;
+            return a->priority < b->priority;
+    }
+}
+
+static void consider(PCB *c, PCB **best, size_t *best_rss) {
+    size_t rss = memory_rss(c->pid);
+    if (rss == 0) return;   // le tuer ne libérerait rien
+    if (!*best || worse_victim(c, rss, *best, *best_rss)) {
+        *best     = c;
+        *best_rss = rss;
+    }
+}
+
+static PCB *pick_victim(void) {
+    PCB   *best = NULL;
+    size_t best_rss = 0;
+
+    for (int c = 0; c < global_scheduler.cpu_count; ++c) {
+        if (global_scheduler.running[c]) consider(global_scheduler.running[c], &best, &best_rss);
+    }
+    for (int i = 0; i < NUM_PRIORITIES; ++i) {
+        for (PCB *c = global_scheduler.ready_queues[i].head; c; c = c->next) {
+            consider(c, &best, &best_rss);
+        }
+    }
+    for (PCB *c = global_scheduler.blocked_queue.head; c; c = c->next) {
+        consider(c, &best, &best_rss);
+    }
+    return best;
+}
+
+/* Raison tracée pour une victime (libellé = oom_policy_to_str) */
+static trace_reason_t oom_policy_reason(oom_policy_t policy) {
+    switch (policy) {
+        case OOM_KILL_LOWEST_PRIORITY: return RS_OOM_LOWEST_PRIORITY;
+        case OOM_KILL_YOUNGEST:        return RS_OOM_YOUNGEST;
+        case OOM_KILL_LARGEST_RSS:     return RS_OOM_LARGEST_RSS;
+        default:                       return RS_UNKNOWN;
+    }
+}
+
+static void oom_kill(PCB *v) {
+    /* On le sort de toutes les files où il peut se trouver */
+    if (!pcb_queue_remove(&global_scheduler.blocked_queue, v)) {
+        for (int i = 0; i < NUM_PRIORITIES; ++i) {
+            if (pcb_queue_remove(&global_scheduler.ready_queues[i], v)) break;
+        }
+    }
+    if (v->waiting_on_mutex)     mutex_cancel_wait((Mutex *)v->waiting_on_mutex, v);
+    if (v->waiting_on_semaphore) semaphore_cancel_wait((Semaphore *)v->waiting_on_semaphore, v);
+    if (v->waiting_for_io || v->aio_inflight > 0) io_cancel(v);
+
+    g_stats.oom_kills++;
+
+    TRACE_EVENT(TRACE_CAT_SCHED,
+            global_scheduler.current_time,
+            v->pid,
+            EV_OOM_KILL,
+            ST_TERMINATED,
+            oom_policy_reason(g_policy),
+            -1,
+            Q_TERM,
+            0
+    );
+
+    v->killed = true;
+    scheduler_terminate(v);
+}
+
+/* ===================================================================== */
+/* API                                                                   */
+/* ===================================================================== */
+
+void admission_init(admission_order_t order, oom_policy_t policy) {
+    g_order      = order;
+    g_policy     = policy;
+    g_seen_epoch = memory_release_epoch();
+    g_dirty      = false;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void admission_submit(PCB *p) {
+    if (!p) return;
+
+    /* En FIFO strict, pas de dépassement des processus déjà en attente */
+    bool queue_busy = (g_order == ADMIT_FIFO) &&
+                      !pcb_queue_empty(&global_scheduler.mem_wait_queue) &&
+                      p->mem_size > 0 && p->mem_base == NULL;
+
+    if (!queue_busy && try_allocate(p)) {
+        scheduler_add_ready(p);
+        return;
+    }
+
+    if (p->mem_size > memory_max_alloc()) {
+        reject(p);   // ne tiendra jamais, même heap vide
+        return;
+    }
+
+    park(p);
+}
+
+void admission_poll(void) {
+    if (pcb_queue_empty(&global_scheduler.mem_wait_queue)) return;
+
+    unsigned long epoch = memory_release_epoch();
+    if (epoch != g_seen_epoch || g_dirty) {
+        g_seen_epoch = epoch;
+        g_dirty      = false;
+        admit_waiting();
+    }
+
+    while (!pcb_queue_empty(&global_scheduler.mem_wait_queue) && deadlocked()) {
+        PCB *w = next_waiting();
+
+        if (compact_for(w->mem_size) && admit_waiting() > 0) {
+            continue;
+        }
+
+        PCB *victim = (g_policy != OOM_KILL_NONE) ? pick_victim() : NULL;
+        if (victim) {
+            oom_kill(victim);
+        } else {
+            pcb_queue_remove(&global_scheduler.mem_wait_queue, w);
+            reject(w);
+        }
+
+        admit_waiting();
+        g_seen_epoch = memory_release_epoch();
+    }
+}
+
+void admission_get_stats(admission_stats_t *out) {
+    if (out) *out = g_stats;
+}
+
+const char *admission_order_to_str(admission_order_t order) {
+    switch (order) {
+        case ADMIT_FIFO:     return "fifo";
+        case ADMIT_PRIORITY: return "priority";
+        default:             return "?";
+    }
+}
+
+const char *oom_policy_to_str(oom_policy_t policy) {
+    switch (policy) {
+        case OOM_KILL_NONE:            return "none";
+        case OOM_KILL_LARGEST_RSS:     return "largest_rss";
+        case OOM_KILL_LOWEST_PRIORITY: return "lowest_priority";
+        case OOM_KILL_YOUNGEST:        return "youngest";
+        default:                       return "?";
+    }
+}
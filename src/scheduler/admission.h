@@ -0,0 +1,70 @@
+#ifndef MINIOS_ADMISSION_H
+#define MINIOS_ADMISSION_H
+
+#include <stdbool.h>
+#include "../process/process.h"
+
+/*
+ * Contrôle d'admission mémoire.
+ *
+ * Un processus dont la zone principale (mem_size) ne tient pas dans le
+ * heap au moment de son arrivée n'est plus tué : il attend dans
+ * global_scheduler.mem_wait_queue (état BLOCKED, raison "memory") et il
+ * est admis dès que des mini_free() ont libéré assez de place.
+ *
+ * Si plus rien ne peut libérer de mémoire (aucun processus exécutable,
+ * aucun réveil daté en attente), attendre serait un interblocage : on
+ * tente une compaction, puis l'OOM-killer choisit une victime selon la
+ * politique configurée.
+ */
+
+/* Ordre d'admission des processus en attente mémoire */
+typedef enum {
+    ADMIT_FIFO = 0,     // ordre d'arrivée strict (pas de dépassement)
+    ADMIT_PRIORITY      // priorité la plus haute d'abord, FIFO à priorité égale
+} admission_order_t;
+
+/* Choix de la victime quand l'attente bloquerait tout */
+typedef enum {
+    OOM_KILL_NONE = 0,        // pas de victime : le processus en attente est rejeté
+    OOM_KILL_LARGEST_RSS,     // celui qui occupe le plus de heap
+    OOM_KILL_LOWEST_PRIORITY, // la priorité la plus basse (puis le plus gros)
+    OOM_KILL_YOUNGEST         // le dernier arrivé
+} oom_policy_t;
+
+/* Compteurs d'admission (pour les stats de fin de simulation) */
+typedef struct admission_stats {
+    int  parked;          // processus mis en attente mémoire au moins une fois
+    int  admitted_late;   // admis après attente
+    long wait_ticks;      // somme des attentes (ticks)
+    int  max_waiting;     // taille max de la file d'attente
+    int  compactions;     // compactions déclenchées pour débloquer
+    int  oom_kills;       // victimes de l'OOM-killer
+    int  rejected;        // demandes impossibles (trop grosses / sans victime)
+} admission_stats_t;
+
+/**
+ * Configure l'admission (à appeler après scheduler_init).
+ */
+void admission_init(admission_order_t order, oom_policy_t policy);
+
+/**
+ * Soumet un processus arrivé (remplace scheduler_add_ready dans la
+ * boucle d'admission) :
+ *  - sa zone principale est déjà allouée ou il n'en demande pas -> READY ;
+ *  - sinon on tente l'allocation, et en cas d'échec il attend.
+ */
+void admission_submit(PCB *p);
+
+/**
+ * Point d'admission appelé à chaque tick par le scheduler : admet ce qui
+ * tient depuis les dernières libérations et traite l'interblocage.
+ */
+void admission_poll(void);
+
+void admission_get_stats(admission_stats_t *out);
+
+const char *admission_order_to_str(admission_order_t order);
+const char *oom_policy_to_str(oom_policy_t policy);
+
+#endif // MINIOS_ADMISSION_H
@@ -4,8 +4,10 @@
 
 #include <stdbool.h>
 #include "../process/process.h"
+#include "../trace/trace_event_types.h"
 
 #define NUM_PRIORITIES 3
+#define SCHED_MAX_CPUS 64
 
 typedef enum {
     SCHED_ROUND_ROBIN = 0,        // RR (préemptif)
@@ -29,8 +31,12 @@ typedef struct Scheduler {
     int current_time;   // horloge logique globale
     int rr_time_quantum;   // quantum (utilisé pour RR & HYBRID)
 
-    // Processus couramment en cours d’exécution (RUNNING) ou NULL si CPU idle
-    PCB *current;
+    // Processus en cours d’exécution (RUNNING) sur chaque CPU, NULL si idle
+    int  cpu_count;
+    PCB *running[SCHED_MAX_CPUS];
+
+    // Ticks de traitement d'interruption restant à chaque CPU (cf. scheduler_irq)
+    int  irq_work[SCHED_MAX_CPUS];
 
     // Files READY par priorité (on les utilise ou pas selon la politique)
     PCBQueue ready_queues[NUM_PRIORITIES];
@@ -38,12 +44,23 @@ typedef struct Scheduler {
     // File BLOCKED (tous les processus en attente I/O/mutex/semaphore)
     PCBQueue blocked_queue;
 
+    // File d'attente mémoire (processus arrivés dont la zone ne tient pas encore)
+    PCBQueue mem_wait_queue;
+
     // File TERMINATED (pour stats + traces)
     PCBQueue terminated_queue;
 
     // Statistiques basiques
     int context_switches;
     int total_processes;
+    int alloc_failures;   // étapes ALLOC de programmes refusées (heap plein)
+    long busy_ticks;      // ticks CPU consommés (tous CPU confondus)
+    int  finished;           // processus terminés (files de terminés vidées ou non)
+    int  completed;          // terminés au bout de leur travail (ni rejetés ni OOM-kill)
+    long turnaround_total;   // somme finish - arrival des complétés
+    long response_total;     // somme start - arrival des complétés élus
+    int  responded;          // complétés qui ont été élus au moins une fois
+    long irq_ticks;          // ticks CPU pris par les interruptions (tous CPU confondus)
 
 
 } Scheduler;
@@ -58,17 +75,22 @@ void pcb_queue_init(PCBQueue *q);   // Init de la queue
 void pcb_queue_up(PCBQueue *q, PCB *p); // Ajoute un PCB (fin de file car FIFO)
 PCB *pcb_queue_give(PCBQueue *q);  // Donne le premier PCB de la file au CPU
 bool pcb_queue_empty(PCBQueue *q); // Test si queue empty
+bool pcb_queue_remove(PCBQueue *q, PCB *p); // Retire p de la file (n'importe où), true si trouvé
 
 
 // Scheduler API
 
 void scheduler_init(SchedulingPolicy policy, int rr_time_quantum); // init du scheduler, choix quantum, CHOIX DE LA POLITIQUE...
+int  scheduler_set_cpu_count(int n);   // CPU simulés (1 par défaut, conservé par scheduler_init) ; -1 si hors bornes
+int  scheduler_cpu_of(const PCB *p);   // CPU où p s'exécute, -1 s'il n'est pas RUNNING
+int  scheduler_idle_cpu(void);         // premier CPU libre, -1 si tous occupés
 void scheduler_add_ready(PCB *p); // Passage à l'état ready (utile pour préemption)
-void scheduler_block(PCB *p, const char *reason, const char *queue_label);
+void scheduler_block(PCB *p, trace_reason_t reason, trace_queue_t queue); // BLOCKED, tracé dans la file queue (Q_BLOCKED, file d'un périphérique...)
 void scheduler_terminate(PCB *p); // Fin d'un process
+int  scheduler_irq(int ticks);    // Interruption de ticks ticks sur un CPU (le processus qui y tourne n'avance pas) ; retourne sa date de fin
 
 void scheduler_tick(void);
-PCB *scheduler_pick_next(void);  // Choisi le prochain process à RUNNING en fct de la politique actuelle
+PCB *scheduler_pick_next(void);  // Élit le prochain process sur le premier CPU libre en fct de la politique actuelle
 bool scheduler_is_finished(void); // Tout les process FINISHED
 
 #endif //MINIOS_SCHEDULER_H
\ No newline at end of file
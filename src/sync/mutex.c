@@ -31,7 +31,7 @@ static void remove_from_blocked_queue(PCB* p) {
 }
 
 static MutexWaitNode* mutex_alloc_node(PCB* p) {
-    MutexWaitNode* n = (MutexWaitNode*) mini_malloc(sizeof(MutexWaitNode));
+    MutexWaitNode* n = (MutexWaitNode*) mini_malloc_tagged(sizeof(MutexWaitNode), p->pid, MEM_TAG_SYNC);
     if (!n) return NULL;
     n->proc = p;
     n->next = NULL;
@@ -73,6 +73,14 @@ void mutex_init(Mutex* m) {
     m->wait_queue = NULL;
 }
 
+/* Table statique : tous les champs à 0 = mutex libre */
+static Mutex g_shared[MUTEX_SHARED_COUNT];
+
+Mutex* mutex_shared(int id) {
+    if (id < 0 || id >= MUTEX_SHARED_COUNT) return NULL;
+    return &g_shared[id];
+}
+
 /**
  * Version bloquante :
  * - si free => on prend et on continue
@@ -104,10 +112,10 @@ void mutex_lock(Mutex* m, PCB* current) {
     current->waiting_on_mutex = m;
 
     // Option : on met un "blocked_until" très loin pour éviter le réveil par I/O
-    current->blocked_until = 1000000000; // très loin
+    current->blocked_until = PCB_BLOCKED_FOREVER; // très loin
 
     // Dans les traces, on peut distinguer la raison
-    scheduler_block(current, "mutex", "BLOCKED_MUTEX");
+    scheduler_block(current, RS_MUTEX, Q_BLOCKED);
 
     // On maintient aussi une file d'attente par mutex
     mutex_queue_push(m, current);
@@ -143,14 +151,15 @@ void mutex_unlock(Mutex* m, PCB* current) {
         scheduler_add_ready(next);
 
         // Trace UNBLOCKED (optionnel mais propre)
-        trace_event(
+        TRACE_EVENT(TRACE_CAT_SYNC,
             global_scheduler.current_time,
             next->pid,
-            EVENT_UNBLOCKED,
-            "READY",
-            "mutex",
+            EV_UNBLOCKED,
+            ST_READY,
+            RS_MUTEX,
             -1,
-            "READY"
+            Q_READY,
+            0
         );
     } else {
         // Personne en attente : mutex libre
@@ -158,3 +167,26 @@ void mutex_unlock(Mutex* m, PCB* current) {
         m->owner  = NULL;
     }
 }
+
+void mutex_cancel_wait(Mutex* m, PCB* p) {
+    if (!m || !p) return;
+
+    /* Retrait de la file d'attente du mutex */
+    MutexWaitNode* prev = NULL;
+    MutexWaitNode* cur  = m->wait_queue;
+    while (cur) {
+        if (cur->proc == p) {
+            if (prev) prev->next = cur->next; else m->wait_queue = cur->next;
+            mutex_free_node(cur);
+            break;
+        }
+        prev = cur;
+        cur  = cur->next;
+    }
+
+    /* S'il le tenait, le mutex passe au suivant */
+    if (m->owner == p) {
+        mutex_unlock(m, p);
+    }
+    p->waiting_on_mutex = NULL;
+}
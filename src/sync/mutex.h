@@ -25,6 +25,15 @@ typedef struct Mutex {
  */
 void mutex_init(Mutex* m);
 
+/* Mutex partagés entre processus (étapes LOCK / UNLOCK des programmes) */
+#define MUTEX_SHARED_COUNT 16
+
+/**
+ * Mutex partagé n° id (libre au démarrage), NULL si id hors de
+ * [0, MUTEX_SHARED_COUNT).
+ */
+Mutex* mutex_shared(int id);
+
 /**
  * Prend le mutex de manière bloquante.
  * - Si le mutex est libre, current devient owner et continue.
@@ -47,4 +56,11 @@ void mutex_lock(Mutex* m, PCB* current);
  */
 void mutex_unlock(Mutex* m, PCB* current);
 
+/**
+ * Retire p du mutex (processus tué) :
+ * - s'il est dans la file d'attente, il en sort ;
+ * - s'il est owner, le mutex est libéré / transmis au suivant.
+ */
+void mutex_cancel_wait(Mutex* m, PCB* p);
+
 #endif // MINIOS_MUTEX_H
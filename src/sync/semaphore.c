@@ -30,7 +30,7 @@ static void remove_from_blocked_queue(PCB* p) {
 }
 
 static SemWaitNode* sem_alloc_node(PCB* p) {
-    SemWaitNode* n = (SemWaitNode*) mini_malloc(sizeof(SemWaitNode));
+    SemWaitNode* n = (SemWaitNode*) mini_malloc_tagged(sizeof(SemWaitNode), p->pid, MEM_TAG_SYNC);
     if (!n) return NULL;
     n->proc = p;
     n->next = NULL;
@@ -90,9 +90,9 @@ void semaphore_wait(Semaphore* s, PCB* current) {
 
     // Cas normal : plus de ressources et un processus réel -> on bloque
     current->waiting_on_semaphore = s;
-    current->blocked_until = 1000000000; // très loin
+    current->blocked_until = PCB_BLOCKED_FOREVER; // très loin
 
-    scheduler_block(current, "semaphore", "BLOCKED_SEM");
+    scheduler_block(current, RS_SEMAPHORE, Q_BLOCKED);
 
     sem_queue_push(s, current);
 }
@@ -110,17 +110,35 @@ void semaphore_signal(Semaphore* s) {
 
         scheduler_add_ready(next);
 
-        trace_event(
+        TRACE_EVENT(TRACE_CAT_SYNC,
             global_scheduler.current_time,
             next->pid,
-            EVENT_UNBLOCKED,
-            "READY",
-            "semaphore",
+            EV_UNBLOCKED,
+            ST_READY,
+            RS_SEMAPHORE,
             -1,
-            "READY"
+            Q_READY,
+            0
         );
     } else {
         // Personne en attente, on rend simplement une "place"
         s->value++;
     }
 }
+
+void semaphore_cancel_wait(Semaphore* s, PCB* p) {
+    if (!s || !p) return;
+
+    SemWaitNode* prev = NULL;
+    SemWaitNode* cur  = s->queue;
+    while (cur) {
+        if (cur->proc == p) {
+            if (prev) prev->next = cur->next; else s->queue = cur->next;
+            sem_free_node(cur);
+            break;
+        }
+        prev = cur;
+        cur  = cur->next;
+    }
+    p->waiting_on_semaphore = NULL;
+}
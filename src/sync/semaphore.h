@@ -42,4 +42,10 @@ void semaphore_wait(Semaphore* s, PCB* current);
  */
 void semaphore_signal(Semaphore* s);
 
+/**
+ * Retire p de la file d'attente du sémaphore (processus tué).
+ * Les ressources éventuellement prises ne sont pas rendues.
+ */
+void semaphore_cancel_wait(Semaphore* s, PCB* p);
+
 #endif // MINIOS_SEMAPHORE_H
@@ -1,42 +1,752 @@
+#define _POSIX_C_SOURCE 199309L
 
 #include "logger.h"
+#include "trace_format.h"
+#include "trace_compact.h"
+#include "trace_chrome.h"
 #include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
 #include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
 
-static FILE *trace_file = NULL;
+static FILE          *trace_file   = NULL;
+static trace_format_t trace_format = TRACE_FORMAT_CSV;
+
+static unsigned trace_mask        = TRACE_CAT_ALL;   // demandé par trace_set_mask
+unsigned        trace_active_mask = TRACE_CAT_NONE;  // 0 tant qu'aucune trace n'est ouverte
+
+/* Tampon de sortie binaire (le CSV passe par le tampon de stdio) */
+static unsigned char *bin_buf  = NULL;
+static size_t         bin_used = 0;
+
+/* Format compact : codeur delta/varint + niveau zlib demandé */
+static trace_cz_writer_t *cz_writer = NULL;
+static int                cz_level  = 0;
+
+/* Format Chrome / Perfetto : tranches reconstruites au fil de l'eau */
+static trace_chrome_writer_t *chrome_writer = NULL;
+
+/* ===================================================================== */
+/* LIBELLÉS D'EXPORT                                                     */
+/* ===================================================================== */
+
+static const char *const ev_names[EV_COUNT] = {
+    [EV_CREATE]          = "CREATE",
+    [EV_STATE_CHANGE]    = "STATE_CHANGE",
+    [EV_PREEMPTED]       = "PREEMPTED",
+    [EV_UNBLOCKED]       = "UNBLOCKED",
+    [EV_TERMINATED]      = "TERMINATED",
+    [EV_MEMORY]          = "MEMORY",
+    [EV_CREATE_FAIL_OOM] = "CREATE_FAIL_OOM",
+    [EV_OOM_KILL]        = "OOM_KILL",
+};
+
+static const char *const state_names[ST_COUNT] = {
+    [ST_NONE]       = "",
+    [ST_NEW]        = "NEW",
+    [ST_READY]      = "READY",
+    [ST_RUNNING]    = "RUNNING",
+    [ST_BLOCKED]    = "BLOCKED",
+    [ST_TERMINATED] = "TERMINATED",
+    [ST_ALLOC]      = "ALLOC",
+    [ST_FREE]       = "FREE",
+    [ST_COMPACT]    = "COMPACT",
+};
+
+static const char *const reason_names[RS_COUNT] = {
+    [RS_NONE]                = "",
+    [RS_VALUE]               = "",      // remplacé par arg à l'export
+    [RS_UNKNOWN]             = "unknown",
+    [RS_HIGHER_PRIORITY]     = "higher_priority_arrived",
+    [RS_TIMER]               = "timer",
+    [RS_QUANTUM]             = "quantum",
+    [RS_IO]                  = "io",
+    [RS_MUTEX]               = "mutex",
+    [RS_SEMAPHORE]           = "semaphore",
+    [RS_MEMORY]              = "memory",
+    [RS_OOM_LARGEST_RSS]     = "largest_rss",
+    [RS_OOM_LOWEST_PRIORITY] = "lowest_priority",
+    [RS_OOM_YOUNGEST]        = "youngest",
+    [RS_IO_QUEUE]            = "io_queue",
+    [RS_AIO_WAIT]            = "aio_wait",
+};
+
+static const char *const queue_names[Q_COUNT] = {
+    [Q_NONE]     = "",
+    [Q_NEW]      = "NEW",
+    [Q_READY]    = "READY",
+    [Q_CPU]      = "CPU",
+    [Q_BLOCKED]  = "BLOCKED",
+    [Q_TERM]     = "TERM",
+    [Q_MEM]      = "MEM",
+    [Q_MEM_WAIT] = "MEM_WAIT",
+    [Q_IO_PRINTER]  = "IO_PRINTER",
+    [Q_IO_KEYBOARD] = "IO_KEYBOARD",
+    [Q_IO_MOUSE]    = "IO_MOUSE",
+    [Q_IO_DISK]     = "IO_DISK",
+    [Q_IO_SCREEN]   = "IO_SCREEN",
+    [Q_IO_NETWORK]  = "IO_NETWORK",
+};
+
+static const char *const *const domain_names[TRACE_DOMAIN_COUNT] = {
+    ev_names, state_names, reason_names, queue_names
+};
+static const unsigned domain_sizes[TRACE_DOMAIN_COUNT] = {
+    EV_COUNT, ST_COUNT, RS_COUNT, Q_COUNT
+};
+
+const char *trace_ev_name(unsigned code) {
+    return (code < EV_COUNT && ev_names[code]) ? ev_names[code] : "";
+}
+
+const char *trace_state_name(unsigned code) {
+    return (code < ST_COUNT && state_names[code]) ? state_names[code] : "";
+}
+
+const char *trace_reason_name(unsigned code) {
+    return (code < RS_COUNT && reason_names[code]) ? reason_names[code] : "";
+}
+
+const char *trace_queue_name(unsigned code) {
+    return (code < Q_COUNT && queue_names[code]) ? queue_names[code] : "";
+}
+
+/* ===================================================================== */
+/* SORTIE BINAIRE TAMPONNÉE                                              */
+/* ===================================================================== */
+
+static void bin_drain(void) {
+    if (bin_used == 0 || !trace_file) return;
+    if (fwrite(bin_buf, 1, bin_used, trace_file) != bin_used) {
+        perror("Erreur ecriture trace");
+    }
+    bin_used = 0;
+}
+
+static void bin_write(const trace_rec_t *r) {
+    if (bin_used + TRACE_BIN_RECORD_SIZE > TRACE_BUFFER_SIZE) {
+        bin_drain();
+    }
+    memcpy(bin_buf + bin_used, r, TRACE_BIN_RECORD_SIZE);
+    bin_used += TRACE_BIN_RECORD_SIZE;
+}
+
+/* ===================================================================== */
+/* API                                                                   */
+/* ===================================================================== */
+
+static bool has_suffix(const char *s, const char *suffix) {
+    size_t ls = s ? strlen(s) : 0, lx = strlen(suffix);
+    return ls >= lx && strcmp(s + ls - lx, suffix) == 0;
+}
+
+static trace_format_t format_for(const char *filename) {
+    if (has_suffix(filename, ".mtrace")) return TRACE_FORMAT_BINARY;
+    if (has_suffix(filename, ".ctrace")) return TRACE_FORMAT_COMPACT;
+    if (has_suffix(filename, ".json"))   return TRACE_FORMAT_CHROME;
+    return TRACE_FORMAT_CSV;
+}
 
 void trace_init(const char *filename) {
-    trace_file = fopen(filename, "w");
+    trace_init_format(filename, format_for(filename));
+}
+
+void trace_set_compression(int level) {
+    cz_level = (level < 0) ? 0 : (level > 9 ? 9 : level);
+}
+
+/* Table des libellés : { domaine, code, longueur, texte } */
+static size_t build_label_table(unsigned char *table) {
+    size_t table_len = 0;
+    for (unsigned d = 0; d < TRACE_DOMAIN_COUNT; ++d) {
+        for (unsigned c = 0; c < domain_sizes[d]; ++c) {
+            const char *name = domain_names[d][c] ? domain_names[d][c] : "";
+            size_t      len  = strlen(name);
+            table[table_len++] = (unsigned char)d;
+            table[table_len++] = (unsigned char)c;
+            table[table_len++] = (unsigned char)len;
+            memcpy(table + table_len, name, len);
+            table_len += len;
+        }
+    }
+    return table_len;
+}
+
+/* Ouvre le fichier et le codeur du format : 0, ou -1 (message sur stderr) */
+static int sink_open(const char *filename, trace_format_t format) {
+    trace_format = format;
+    trace_file   = fopen(filename, (format == TRACE_FORMAT_CSV || format == TRACE_FORMAT_CHROME) ? "w" : "wb");
     if (!trace_file) {
-        perror("Erreur ouverture trace.csv");
-        exit(1);
+        perror("Erreur ouverture trace");
+        return -1;
     }
 
-    // En-tête du fichier CSV
-    fprintf(trace_file, "time,pid,event,state,reason,cpu,queue\n");
-    fflush(trace_file);
+    if (format == TRACE_FORMAT_CSV) {
+        // Gros tampon stdio : plus de fflush par événement
+        setvbuf(trace_file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+        // En-tête du fichier CSV
+        fprintf(trace_file, "time,pid,event,state,reason,cpu,queue\n");
+        return 0;
+    }
+
+    if (format == TRACE_FORMAT_CHROME) {
+        setvbuf(trace_file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+        chrome_writer = trace_chrome_writer_open(trace_file);
+        if (!chrome_writer) {
+            fprintf(stderr, "Erreur : codeur de trace Chrome\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    unsigned char table[4096];
+    size_t        table_len = build_label_table(table);
+
+    if (format == TRACE_FORMAT_COMPACT) {
+        setvbuf(trace_file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+        cz_writer = trace_cz_writer_open(trace_file, cz_level, table, (uint32_t)table_len);
+        if (!cz_writer) {
+            fprintf(stderr, "Erreur : codeur de trace compacte\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    bin_buf = malloc(TRACE_BUFFER_SIZE);
+    if (!bin_buf) {
+        fprintf(stderr, "Erreur : tampon de trace\n");
+        return -1;
+    }
+    bin_used = 0;
+
+    trace_bin_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_BIN_MAGIC, 4);
+    h.version        = TRACE_BIN_VERSION;
+    h.endian_tag     = TRACE_BIN_ENDIAN_TAG;
+    h.record_size    = TRACE_BIN_RECORD_SIZE;
+    h.schema_version = TRACE_SCHEMA_VERSION;
+    h.table_bytes    = (uint32_t)table_len;
+    fwrite(&h, sizeof(h), 1, trace_file);
+    fwrite(table, 1, table_len, trace_file);
+    return 0;
 }
 
-void trace_event(int time, int pid, const char *event,
-                 const char *state, const char *reason,
-                 int cpu, const char *queue)
-{
-    if (!trace_file) return;
+/* Encodage + écriture d'un événement (thread de simulation en mode
+ * synchrone, thread d'écriture en mode asynchrone). */
+static void sink_event(const trace_rec_t *r) {
+    if (trace_format == TRACE_FORMAT_BINARY) {
+        bin_write(r);
+        return;
+    }
+    if (trace_format == TRACE_FORMAT_COMPACT) {
+        trace_cz_writer_put(cz_writer, r);
+        return;
+    }
+    if (trace_format == TRACE_FORMAT_CHROME) {
+        trace_chrome_writer_put(chrome_writer, r);
+        return;
+    }
 
-    fprintf(trace_file, "%d,%d,%s,%s,%s,%d,%s\n",
-            time, pid,
-            event,
-            state ? state : "",
-            reason ? reason : "",
-            cpu,
-            queue ? queue : "");
+    if (r->reason == RS_VALUE) {
+        fprintf(trace_file, "%d,%d,%s,%s,%" PRId64 ",%d,%s\n",
+                r->time, r->pid,
+                trace_ev_name(r->event),
+                trace_state_name(r->state),
+                r->arg,
+                r->cpu,
+                trace_queue_name(r->queue));
+    } else {
+        fprintf(trace_file, "%d,%d,%s,%s,%s,%d,%s\n",
+                r->time, r->pid,
+                trace_ev_name(r->event),
+                trace_state_name(r->state),
+                trace_reason_name(r->reason),
+                r->cpu,
+                trace_queue_name(r->queue));
+    }
+}
 
+static void sink_flush(void) {
+    if (trace_format == TRACE_FORMAT_BINARY)  bin_drain();
+    if (trace_format == TRACE_FORMAT_COMPACT) trace_cz_writer_flush(cz_writer);
     fflush(trace_file);
 }
 
-void trace_close() {
+static void sink_close(void) {
     if (trace_file) {
+        sink_flush();
+        trace_cz_writer_close(cz_writer);           // NULL hors format compact
+        trace_chrome_writer_close(chrome_writer);   // NULL hors format Chrome
         fclose(trace_file);
         trace_file = NULL;
     }
+    cz_writer     = NULL;
+    chrome_writer = NULL;
+    free(bin_buf);
+    bin_buf  = NULL;
+    bin_used = 0;
+}
+
+void trace_init_format(const char *filename, trace_format_t format) {
+    trace_close();   // arrête aussi un éventuel thread d'écriture / enregistreur
+
+    if (sink_open(filename, format) < 0) {
+        sink_close();
+        exit(1);
+    }
+    trace_active_mask = trace_mask;
+}
+
+/* ===================================================================== */
+/* MODE ASYNCHRONE : ANNEAU SPSC + THREAD D'ÉCRITURE                     */
+/* ===================================================================== */
+
+#define CACHE_LINE 64
+
+/* head n'est écrit que par le producteur, tail que par le consommateur :
+ * chacun sur sa ligne de cache pour éviter le faux partage. */
+static struct {
+    trace_rec_t *slots;
+    size_t       mask;
+    char         pad0[CACHE_LINE];
+    size_t       head;          // prochain slot écrit (producteur)
+    char         pad1[CACHE_LINE - sizeof(size_t)];
+    size_t       tail;          // prochain slot lu (consommateur)
+    char         pad2[CACHE_LINE - sizeof(size_t)];
+} ring;
+
+static bool                async_on      = false;
+static trace_full_policy_t async_policy  = TRACE_FULL_BLOCK;
+static pthread_t           async_thread;
+static int                 async_stop    = 0;   // demandé par trace_close
+static unsigned long       flush_req     = 0;   // demandes de trace_flush
+static unsigned long       flush_done    = 0;   // traitées par le thread
+static trace_async_stats_t async_stats;
+
+/* Attente courte quand l'anneau est vide (consommateur) ou plein (producteur) */
+static void async_pause(void) {
+    struct timespec ts = { 0, 50 * 1000 };   // 50 µs
+    nanosleep(&ts, NULL);
+}
+
+static void *async_writer_main(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        size_t tail = ring.tail;
+        size_t head = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+
+        if (tail != head) {
+            /* On traite tout ce qui est disponible avant de publier tail */
+            while (tail != head) {
+                sink_event(&ring.slots[tail & ring.mask]);
+                tail++;
+            }
+            __atomic_store_n(&ring.tail, tail, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        /* Anneau vide : flush demandé ? arrêt demandé ? */
+        unsigned long req = __atomic_load_n(&flush_req, __ATOMIC_ACQUIRE);
+        if (req != flush_done) {
+            /* head relu après req : rien n'a pu être poussé avant la demande
+             * sans être déjà écrit */
+            if (__atomic_load_n(&ring.head, __ATOMIC_ACQUIRE) != tail) continue;
+            sink_flush();
+            __atomic_store_n(&flush_done, req, __ATOMIC_RELEASE);
+            continue;
+        }
+        if (__atomic_load_n(&async_stop, __ATOMIC_ACQUIRE)) {
+            if (__atomic_load_n(&ring.head, __ATOMIC_ACQUIRE) != tail) continue;
+            break;
+        }
+        async_pause();
+    }
+    return NULL;
+}
+
+static void async_push(const trace_rec_t *rec) {
+    size_t head = ring.head;
+    size_t cap  = ring.mask + 1;
+
+    if (head - __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE) >= cap) {
+        if (async_policy == TRACE_FULL_DROP) {
+            async_stats.dropped++;
+            return;
+        }
+        async_stats.full_waits++;
+        while (head - __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE) >= cap) {
+            async_pause();
+        }
+    }
+
+    ring.slots[head & ring.mask] = *rec;
+    __atomic_store_n(&ring.head, head + 1, __ATOMIC_RELEASE);
+
+    async_stats.pushed++;
+    size_t used = head + 1 - __atomic_load_n(&ring.tail, __ATOMIC_RELAXED);
+    if (used > async_stats.high_water) async_stats.high_water = used;
+}
+
+/* Attend que le thread d'écriture ait tout écrit et flushé */
+static void async_sync(void) {
+    unsigned long req = __atomic_add_fetch(&flush_req, 1, __ATOMIC_ACQ_REL);
+    while (__atomic_load_n(&flush_done, __ATOMIC_ACQUIRE) < req) {
+        async_pause();
+    }
+}
+
+static void async_shutdown(void) {
+    if (!async_on) return;
+    __atomic_store_n(&async_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(async_thread, NULL);
+    async_on = false;
+    free(ring.slots);
+    ring.slots = NULL;
+}
+
+int trace_start_async(size_t capacity, trace_full_policy_t policy) {
+    if (!trace_file || async_on) return -1;
+
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;   // puissance de 2 (masque)
+
+    ring.slots = malloc(cap * sizeof(trace_rec_t));
+    if (!ring.slots) {
+        fprintf(stderr, "[TRACE] anneau de %zu enregistrements impossible à allouer\n", cap);
+        return -1;
+    }
+    ring.mask = cap - 1;
+    ring.head = 0;
+    ring.tail = 0;
+
+    async_policy = policy;
+    async_stop   = 0;
+    flush_req    = 0;
+    flush_done   = 0;
+    memset(&async_stats, 0, sizeof(async_stats));
+    async_stats.capacity = cap;
+
+    if (pthread_create(&async_thread, NULL, async_writer_main, NULL) != 0) {
+        fprintf(stderr, "[TRACE] thread d'écriture impossible, trace synchrone\n");
+        free(ring.slots);
+        ring.slots = NULL;
+        return -1;
+    }
+    async_on = true;
+    return 0;
+}
+
+void trace_get_async_stats(trace_async_stats_t *out) {
+    if (out) *out = async_stats;
+}
+
+/* ===================================================================== */
+/* FLIGHT RECORDER : ANNEAU EN MÉMOIRE + DUMPS SUR DÉCLENCHEUR            */
+/* ===================================================================== */
+
+/* Dernier état vu d'un processus (pour les seuils de latence / blocage) */
+typedef struct flight_proc {
+    uint8_t state;
+    bool    reported;   // blocage en cours déjà signalé par trace_flight_tick
+    int     since;
+} flight_proc_t;
+
+static struct {
+    bool                  on;
+    char                  path[512];    // modèle des dumps (extension = format)
+    trace_format_t        format;
+    trace_flight_config_t cfg;
+    trace_rec_t          *slots;
+    size_t                mask;
+    size_t                head;         // événements enregistrés depuis l'ouverture
+    flight_proc_t        *procs;        // indexé par PID
+    int                   nprocs;
+    bool                  pending;      // déclenché, dump après post_left événements
+    size_t                post_left;
+    char                  why[128];
+    trace_flight_stats_t  stats;
+} flight;
+
+void trace_flight_default_config(trace_flight_config_t *cfg) {
+    if (!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->capacity    = TRACE_FLIGHT_DEFAULT_CAPACITY;
+    cfg->on_oom      = true;
+    cfg->post_events = 256;
+    cfg->max_dumps   = 16;
+}
+
+/* "flight.mtrace" -> "flight-003.mtrace" */
+static void flight_dump_name(char *out, size_t size, unsigned long n) {
+    const char *dot   = strrchr(flight.path, '.');
+    const char *slash = strrchr(flight.path, '/');
+    if (!dot || (slash && dot < slash)) dot = flight.path + strlen(flight.path);
+
+    snprintf(out, size, "%.*s-%03lu%s", (int)(dot - flight.path), flight.path, n, dot);
+}
+
+/* Écrit le contenu de l'anneau (du plus ancien au plus récent) */
+static int flight_write(const char *why) {
+    char name[sizeof(flight.path) + 16];
+    flight_dump_name(name, sizeof(name), flight.stats.dumps + 1);
+
+    if (sink_open(name, flight.format) < 0) {
+        sink_close();
+        return -1;
+    }
+
+    size_t cap   = flight.mask + 1;
+    size_t first = flight.head > cap ? flight.head - cap : 0;
+    for (size_t i = first; i < flight.head; ++i) {
+        sink_event(&flight.slots[i & flight.mask]);
+    }
+    sink_close();
+
+    flight.stats.dumps++;
+    fprintf(stderr, "[TRACE] flight recorder : %s -> %s (%zu événements)\n",
+            why, name, flight.head - first);
+    return 0;
+}
+
+/* Un déclencheur pendant qu'un dump attend ses événements "après" est
+ * compté mais couvert par ce dump */
+static void flight_trigger(const char *why) {
+    flight.stats.triggers++;
+    if (flight.pending) return;
+    if (flight.cfg.max_dumps > 0 && flight.stats.dumps >= (unsigned long)flight.cfg.max_dumps)
+        return;
+
+    snprintf(flight.why, sizeof(flight.why), "%s", why);
+    flight.pending   = true;
+    flight.post_left = flight.cfg.post_events;
+}
+
+static flight_proc_t *flight_proc(int pid) {
+    if (pid < 0) return NULL;
+    if (pid >= flight.nprocs) {
+        int n = flight.nprocs ? flight.nprocs : 64;
+        while (n <= pid) n *= 2;
+        flight_proc_t *t = realloc(flight.procs, (size_t)n * sizeof(*t));
+        if (!t) return NULL;
+        memset(t + flight.nprocs, 0, (size_t)(n - flight.nprocs) * sizeof(*t));
+        flight.procs  = t;
+        flight.nprocs = n;
+    }
+    return &flight.procs[pid];
+}
+
+/* Seuils de l'enregistreur, évalués sur chaque transition ; l'état suivi
+ * des processus est tenu à jour même quand un dump est en attente */
+static void flight_check(const trace_rec_t *r) {
+    char why[128];
+
+    if (flight.cfg.on_oom && (r->event == EV_OOM_KILL || r->event == EV_CREATE_FAIL_OOM)) {
+        snprintf(why, sizeof(why), "%s P%d à t=%d", trace_ev_name(r->event), r->pid, r->time);
+        flight_trigger(why);
+        return;
+    }
+    if (r->event == EV_MEMORY) return;
+
+    flight_proc_t *p = flight_proc(r->pid);
+    if (!p || p->state == r->state) return;
+
+    int waited = r->time - p->since;
+    if (flight.cfg.latency_threshold > 0 && p->state == ST_READY && r->state == ST_RUNNING &&
+        waited >= flight.cfg.latency_threshold) {
+        snprintf(why, sizeof(why), "latence P%d = %d ticks à t=%d", r->pid, waited, r->time);
+        flight_trigger(why);
+    } else if (flight.cfg.block_threshold > 0 && p->state == ST_BLOCKED && !p->reported &&
+               waited >= flight.cfg.block_threshold) {
+        snprintf(why, sizeof(why), "P%d bloqué %d ticks à t=%d", r->pid, waited, r->time);
+        flight_trigger(why);
+    }
+
+    p->state    = r->state;
+    p->since    = r->time;
+    p->reported = false;
+}
+
+void trace_flight_tick(int now) {
+    if (!flight.on || flight.cfg.block_threshold <= 0) return;
+
+    for (int pid = 0; pid < flight.nprocs; ++pid) {
+        flight_proc_t *p = &flight.procs[pid];
+        if (p->state != ST_BLOCKED || p->reported) continue;
+        if (now - p->since < flight.cfg.block_threshold) continue;
+
+        /* Dump immédiat : un système bloqué ne produira peut-être plus
+         * aucun événement pour compléter le contexte "après" */
+        char why[128];
+        snprintf(why, sizeof(why), "P%d bloqué depuis %d ticks à t=%d", pid, now - p->since, now);
+        p->reported = true;
+        flight.stats.triggers++;
+        if (flight.pending) continue;   // dans l'anneau du dump en attente
+        if (flight.cfg.max_dumps > 0 && flight.stats.dumps >= (unsigned long)flight.cfg.max_dumps)
+            continue;
+        flight_write(why);
+    }
+}
+
+static void flight_record(const trace_rec_t *r) {
+    flight.slots[flight.head & flight.mask] = *r;
+    flight.head++;
+    flight.stats.recorded++;
+
+    bool was_pending = flight.pending;
+    flight_check(r);
+    if (was_pending && flight.post_left > 0) {
+        flight.post_left--;
+    }
+
+    if (flight.pending && flight.post_left == 0) {
+        flight.pending = false;
+        flight_write(flight.why);
+    }
+}
+
+static void flight_shutdown(void) {
+    if (!flight.on) return;
+    if (flight.pending) {
+        flight.pending = false;
+        flight_write(flight.why);   // moins d'événements "après" que prévu
+    }
+    free(flight.slots);
+    free(flight.procs);
+    flight.slots  = NULL;
+    flight.procs  = NULL;
+    flight.nprocs = 0;
+    flight.on     = false;
+}
+
+int trace_init_flight(const char *path, const trace_flight_config_t *cfg) {
+    trace_close();
+
+    trace_flight_config_t c;
+    if (cfg) c = *cfg;
+    else     trace_flight_default_config(&c);
+    if (c.capacity == 0) c.capacity = TRACE_FLIGHT_DEFAULT_CAPACITY;
+
+    size_t cap = 1;
+    while (cap < c.capacity) cap <<= 1;   // puissance de 2 (masque)
+    // Le déclencheur doit rester dans l'anneau au moment du dump
+    if (c.post_events > cap / 2) c.post_events = cap / 2;
+
+    if (!path || strlen(path) >= sizeof(flight.path)) {
+        fprintf(stderr, "[TRACE] flight recorder : chemin de dump invalide\n");
+        return -1;
+    }
+    flight.slots = malloc(cap * sizeof(trace_rec_t));
+    if (!flight.slots) {
+        fprintf(stderr, "[TRACE] anneau de %zu enregistrements impossible à allouer\n", cap);
+        return -1;
+    }
+
+    strcpy(flight.path, path);
+    flight.format  = format_for(path);
+    flight.cfg     = c;
+    flight.mask    = cap - 1;
+    flight.head    = 0;
+    flight.pending = false;
+    memset(&flight.stats, 0, sizeof(flight.stats));
+    flight.on      = true;
+
+    trace_active_mask = trace_mask;
+    return 0;
+}
+
+int trace_flight_dump(const char *why) {
+    if (!flight.on) return -1;
+    flight.stats.triggers++;
+    flight.pending = false;   // ce dump couvre un éventuel déclencheur en attente
+    return flight_write(why ? why : "dump explicite");
+}
+
+void trace_get_flight_stats(trace_flight_stats_t *out) {
+    if (out) *out = flight.stats;
+}
+
+/* ===================================================================== */
+/* ÉVÉNEMENTS                                                            */
+/* ===================================================================== */
+
+void trace_event(int time, int pid, trace_ev_t event, trace_state_t state,
+                 trace_reason_t reason, int cpu, trace_queue_t queue, int64_t arg)
+{
+    if (!trace_file && !flight.on) return;
+
+    trace_rec_t r;
+    r.time     = time;
+    r.pid      = pid;
+    r.cpu      = (int16_t)cpu;
+    r.event    = (uint8_t)event;
+    r.state    = (uint8_t)state;
+    r.reason   = (uint8_t)reason;
+    r.queue    = (uint8_t)queue;
+    r.reserved = 0;
+    r.arg      = arg;
+
+    if (flight.on) {
+        flight_record(&r);
+    } else if (async_on) {
+        async_push(&r);
+    } else {
+        sink_event(&r);
+    }
+}
+
+void trace_flush(void) {
+    if (!trace_file) return;
+    if (async_on) {
+        async_sync();
+    } else {
+        sink_flush();
+    }
+}
+
+void trace_set_mask(unsigned mask) {
+    trace_mask = mask & TRACE_CAT_ALL;
+    if (trace_file || flight.on) trace_active_mask = trace_mask;
+}
+
+unsigned trace_get_mask(void) {
+    return trace_mask;
+}
+
+int trace_parse_mask(const char *spec) {
+    static const struct { const char *name; unsigned bit; } cats[] = {
+        { "sched", TRACE_CAT_SCHED }, { "mem",  TRACE_CAT_MEM  },
+        { "io",    TRACE_CAT_IO    }, { "sync", TRACE_CAT_SYNC },
+        { "all",   TRACE_CAT_ALL   }, { "none", TRACE_CAT_NONE },
+    };
+    unsigned mask = 0;
+
+    if (!spec) return -1;
+    while (*spec) {
+        size_t len = strcspn(spec, ",");
+        bool   found = false;
+        for (size_t i = 0; i < sizeof(cats) / sizeof(cats[0]); ++i) {
+            if (strlen(cats[i].name) == len && strncmp(spec, cats[i].name, len) == 0) {
+                mask |= cats[i].bit;
+                found = true;
+                break;
+            }
+        }
+        if (!found && len > 0) return -1;
+        spec += len;
+        if (*spec == ',') spec++;
+    }
+    return (int)mask;
+}
+
+void trace_close() {
+    trace_active_mask = TRACE_CAT_NONE;
+    async_shutdown();    // le thread vide l'anneau avant de s'arrêter
+    flight_shutdown();   // écrit un éventuel dump en attente
+    sink_close();
 }
@@ -1,19 +1,154 @@
-
 #ifndef MINIOS_LOGGER_H
 #define MINIOS_LOGGER_H
 
 #include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "trace_event_types.h"
+
+/* Format du fichier de trace */
+typedef enum {
+    TRACE_FORMAT_CSV = 0,   // texte, schéma time,pid,event,state,reason,cpu,queue
+    TRACE_FORMAT_BINARY,    // enregistrements fixes (cf. trace_format.h)
+    TRACE_FORMAT_COMPACT,   // blocs delta/varint, zlib en option (.ctrace)
+    TRACE_FORMAT_CHROME     // JSON Chrome Trace Event pour Perfetto (.json)
+} trace_format_t;
+
+/*
+ * Catégories d'événements.
+ *
+ * TRACE_EVENT(cat, ...) n'appelle trace_event que si la catégorie est
+ * compilée (MINIOS_TRACE_CATEGORIES, option CMake du même nom) ET activée
+ * au runtime (trace_set_mask). Une catégorie non compilée disparaît du
+ * binaire ; une catégorie masquée coûte un test de bit. Un calcul coûteux
+ * d'argument se met derrière TRACE_ENABLED(cat).
+ */
+#define TRACE_CAT_SCHED  0x1u   // transitions d'état, création, terminaison
+#define TRACE_CAT_MEM    0x2u   // ALLOC / FREE / COMPACT du heap simulé
+#define TRACE_CAT_IO     0x4u   // fins d'I/O
+#define TRACE_CAT_SYNC   0x8u   // réveils mutex / sémaphore
+#define TRACE_CAT_ALL    0xFu
+#define TRACE_CAT_NONE   0x0u
+
+#ifndef MINIOS_TRACE_CATEGORIES
+#define MINIOS_TRACE_CATEGORIES TRACE_CAT_ALL
+#endif
+
+/* Masque effectif : celui de trace_set_mask si une trace est ouverte, 0 sinon */
+extern unsigned trace_active_mask;
+
+#define TRACE_ENABLED(cat) \
+    ((((unsigned)(MINIOS_TRACE_CATEGORIES) & (cat)) != 0) && ((trace_active_mask & (cat)) != 0))
+
+#define TRACE_EVENT(cat, ...) \
+    do { if (TRACE_ENABLED(cat)) trace_event(__VA_ARGS__); } while (0)
 
-// Initialise le fichier trace.csv
+/* Taille du tampon d'écriture (les événements ne sont plus flushés un par un) */
+#define TRACE_BUFFER_SIZE (1u << 20)
+
+/* Mode asynchrone : comportement quand l'anneau est plein */
+typedef enum {
+    TRACE_FULL_BLOCK = 0,   // la simulation attend le thread d'écriture
+    TRACE_FULL_DROP         // l'événement est perdu (compté dans dropped)
+} trace_full_policy_t;
+
+#define TRACE_ASYNC_DEFAULT_CAPACITY (1u << 16)   // enregistrements
+
+typedef struct trace_async_stats {
+    size_t        capacity;     // taille de l'anneau (puissance de 2)
+    unsigned long pushed;       // événements confiés au thread d'écriture
+    unsigned long dropped;      // perdus (TRACE_FULL_DROP)
+    unsigned long full_waits;   // attentes sur anneau plein (TRACE_FULL_BLOCK)
+    size_t        high_water;   // occupation maximale observée
+} trace_async_stats_t;
+
+// Initialise le fichier de trace : binaire si le nom finit par ".mtrace",
+// compact pour ".ctrace", JSON Chrome/Perfetto pour ".json", CSV sinon
 void trace_init(const char *filename);
 
-// Enregistre un événement dans trace.csv
+// Initialise le fichier de trace dans le format demandé
+void trace_init_format(const char *filename, trace_format_t format);
+
+// Niveau zlib des traces compactes ouvertes ensuite (0 = aucun, défaut ;
+// 1..9 si miniOS est compilé avec zlib)
+void trace_set_compression(int level);
+
+// Passe en mode asynchrone (après trace_init) : trace_event ne fait plus
+// que déposer l'enregistrement dans un anneau sans verrou lu par un thread
+// d'écriture, qui encode et écrit le fichier. Un seul thread producteur à
+// la fois.
+// Retourne 0, ou -1 si le mode ne peut pas être activé (trace synchrone).
+int trace_start_async(size_t capacity, trace_full_policy_t policy);
+
+// Compteurs du mode asynchrone (valides jusqu'au prochain trace_start_async)
+void trace_get_async_stats(trace_async_stats_t *out);
+
+/*
+ * Flight recorder : au lieu d'écrire la trace, trace_event garde les
+ * `capacity` derniers événements dans un anneau en mémoire. Sur un
+ * déclencheur, l'anneau (contexte avant + post_events événements après)
+ * est écrit dans un fichier "<chemin>-NNN.<ext>", au format choisi par
+ * l'extension comme pour trace_init. Coût par événement : une copie de
+ * 24 octets et quelques comparaisons.
+ */
+#define TRACE_FLIGHT_DEFAULT_CAPACITY (1u << 16)   // enregistrements
+
+typedef struct trace_flight_config {
+    size_t capacity;            // événements conservés (arrondi à une puissance de 2)
+    int    latency_threshold;   // attente READY -> RUNNING, en ticks (0 = ignoré)
+    int    block_threshold;     // durée en BLOCKED, en ticks (0 = ignoré), cf. trace_flight_tick
+    bool   on_oom;              // OOM_KILL et CREATE_FAIL_OOM
+    size_t post_events;         // événements enregistrés après le déclencheur
+    int    max_dumps;           // 0 = illimité
+} trace_flight_config_t;
+
+typedef struct trace_flight_stats {
+    unsigned long recorded;     // événements passés par l'anneau
+    unsigned long triggers;     // déclencheurs (y compris ignorés)
+    unsigned long dumps;        // fichiers écrits
+} trace_flight_stats_t;
+
+// Défauts : 64k événements, OOM seul, 256 événements après, 16 dumps max
+void trace_flight_default_config(trace_flight_config_t *cfg);
+
+// Ouvre la trace en mode flight recorder (remplace trace_init ; cfg NULL =
+// défauts). Retourne 0, ou -1 (message sur stderr).
+int trace_init_flight(const char *path, const trace_flight_config_t *cfg);
+
+// Déclencheur explicite : écrit l'anneau tout de suite. 0, ou -1 si le mode
+// n'est pas actif ou si l'écriture échoue.
+int trace_flight_dump(const char *why);
+
+void trace_get_flight_stats(trace_flight_stats_t *out);
+
+// Seuil de blocage vu du temps qui passe (appelé à chaque tick par le
+// scheduler) : un processus qui ne se réveille jamais (interblocage,
+// réveil perdu) déclenche aussi un dump, écrit tout de suite, une fois
+// par période bloquée.
+void trace_flight_tick(int now);
+
+// Catégories à enregistrer (TRACE_CAT_*, défaut TRACE_CAT_ALL), avant ou
+// après trace_init
+void trace_set_mask(unsigned mask);
+unsigned trace_get_mask(void);
+
+// "sched,mem" / "all" / "none" -> masque ; -1 si un nom est inconnu
+int trace_parse_mask(const char *spec);
+
+// Enregistre un événement (sans filtre : préférer TRACE_EVENT).
+// arg : payload numérique, exporté comme raison quand reason == RS_VALUE
 void trace_event(int time, int pid,
-                 const char *event,
-                 const char *state,
-                 const char *reason,
+                 trace_ev_t event,
+                 trace_state_t state,
+                 trace_reason_t reason,
                  int cpu,
-                 const char *queue);
+                 trace_queue_t queue,
+                 int64_t arg);
+
+// Vide le tampon dans le fichier (fait aussi par trace_close) ; en mode
+// asynchrone, attend d'abord que le thread d'écriture ait tout traité
+void trace_flush(void);
 
 // Ferme le fichier
 void trace_close();
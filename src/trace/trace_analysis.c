@@ -0,0 +1,283 @@
+#include "trace_analysis.h"
+#include "logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+/* Dernier événement (hors MEMORY) d'un processus : début de l'intervalle */
+typedef struct proc_cursor {
+    uint8_t  state;
+    uint8_t  reason;
+    int      time;
+    int64_t  arg;
+} proc_cursor_t;
+
+/* Processus vivant : curseur et cumuls */
+typedef struct proc_slot {
+    bool               used;
+    proc_cursor_t      cur;
+    trace_proc_stats_t st;
+} proc_slot_t;
+
+struct trace_analyzer {
+    FILE               *intervals;
+    FILE               *memory;
+    FILE               *stats;
+    proc_slot_t        *procs;        // hash pid -> processus vivant (adressage ouvert)
+    size_t              capacity;     // puissance de 2
+    size_t              live;
+    trace_summary_t     sum;
+    long                turnaround;   // cumuls des processus terminés normalement
+    long                response;
+    long                ready;
+    int                 completed;
+    int                 responded;    // complétés qui ont été élus
+    int64_t             heap;
+    int                 mem_time;     // point mémoire en attente (même tick)
+    bool                mem_pending;
+};
+
+static size_t proc_slot(const trace_analyzer_t *a, int pid) {
+    uint32_t h = (uint32_t)pid * 2654435761u;
+    return (size_t)(h ^ (h >> 16)) & (a->capacity - 1);
+}
+
+static bool grow(trace_analyzer_t *a) {
+    size_t       cap  = a->capacity ? a->capacity * 2 : 64;
+    proc_slot_t *old  = a->procs;
+    size_t       ncap = a->capacity;
+
+    proc_slot_t *tab = calloc(cap, sizeof(*tab));
+    if (!tab) return false;
+
+    a->procs    = tab;
+    a->capacity = cap;
+    for (size_t i = 0; i < ncap; ++i) {
+        if (!old[i].used) continue;
+        size_t j = proc_slot(a, old[i].st.pid);
+        while (tab[j].used) j = (j + 1) & (cap - 1);
+        tab[j] = old[i];
+    }
+    free(old);
+    return true;
+}
+
+/* Processus pid, créé au premier événement (NULL si plus de mémoire) */
+static proc_slot_t *proc_get(trace_analyzer_t *a, int pid) {
+    if (a->capacity) {
+        size_t j = proc_slot(a, pid);
+        while (a->procs[j].used) {
+            if (a->procs[j].st.pid == pid) return &a->procs[j];
+            j = (j + 1) & (a->capacity - 1);
+        }
+    }
+    if ((a->live + 1) * 10 > a->capacity * 7 && !grow(a)) return NULL;
+
+    size_t j = proc_slot(a, pid);
+    while (a->procs[j].used) j = (j + 1) & (a->capacity - 1);
+
+    proc_slot_t *p = &a->procs[j];
+    memset(p, 0, sizeof(*p));
+    p->used           = true;
+    p->st.pid         = pid;
+    p->st.arrival     = -1;
+    p->st.finish      = -1;
+    p->st.first_start = -1;
+    p->st.first_run   = -1;
+    a->live++;
+    return p;
+}
+
+/* Suppression par décalage arrière (pas de tombstones en sondage linéaire) */
+static void proc_remove(trace_analyzer_t *a, proc_slot_t *p) {
+    size_t mask = a->capacity - 1;
+    size_t hole = (size_t)(p - a->procs);
+    size_t j    = hole;
+    a->live--;
+
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!a->procs[j].used) break;
+        size_t home = proc_slot(a, a->procs[j].st.pid);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            a->procs[hole] = a->procs[j];
+            hole = j;
+        }
+    }
+    a->procs[hole].used = false;
+}
+
+static void emit_interval(trace_analyzer_t *a, proc_slot_t *p, int end) {
+    trace_proc_stats_t  *s   = &p->st;
+    const proc_cursor_t *c   = &p->cur;
+    long                 dur = end - c->time;
+
+    if (s->first_start < 0) s->first_start = c->time;
+    s->last_end = end;
+    a->sum.intervals++;
+
+    switch (c->state) {
+        case ST_RUNNING:
+            s->running += dur;
+            a->sum.busy += dur;
+            break;
+        case ST_READY:   s->ready   += dur; break;
+        case ST_BLOCKED: s->blocked += dur; break;
+        default: break;
+    }
+
+    if (!a->intervals) return;
+    if (c->reason == RS_VALUE) {
+        fprintf(a->intervals, "%d,%s,%d,%d,%ld,%" PRId64 "\n",
+                s->pid, trace_state_name(c->state), c->time, end, dur, c->arg);
+    } else {
+        fprintf(a->intervals, "%d,%s,%d,%d,%ld,%s\n",
+                s->pid, trace_state_name(c->state), c->time, end, dur,
+                trace_reason_name(c->reason));
+    }
+}
+
+/* Verse les cumuls d'un processus dans le résumé et écrit sa ligne */
+static void retire(trace_analyzer_t *a, const trace_proc_stats_t *s) {
+    a->sum.switches += s->switches;
+    if (s->terminated && !s->killed) {
+        a->completed++;
+        a->turnaround += s->finish - s->arrival;
+        a->ready      += s->ready;
+        if (s->first_run >= 0) {
+            a->responded++;
+            a->response += s->first_run - s->arrival;
+        }
+    }
+
+    if (!a->stats || s->first_start < 0) return;   // aucun intervalle (comme le Gantt)
+    fprintf(a->stats, "%d,%ld,%ld,%ld,%d,%d,%ld\n",
+            s->pid, s->running, s->ready, s->blocked,
+            s->first_run >= 0 ? s->first_run - s->arrival : 0,
+            (s->finish >= 0 ? s->finish : s->last_end) - s->arrival, s->switches);
+}
+
+static void flush_memory(trace_analyzer_t *a) {
+    if (a->mem_pending && a->memory)
+        fprintf(a->memory, "%d,%" PRId64 "\n", a->mem_time, a->heap);
+    a->mem_pending = false;
+}
+
+static void put_memory(trace_analyzer_t *a, const trace_rec_t *r) {
+    if (r->state != ST_ALLOC && r->state != ST_FREE) return;
+
+    if (a->mem_pending && r->time != a->mem_time) flush_memory(a);
+
+    if (r->state == ST_ALLOC) {
+        a->heap += r->arg;
+    } else {
+        a->heap = (a->heap > r->arg) ? a->heap - r->arg : 0;
+    }
+    if (a->heap > a->sum.heap_peak) a->sum.heap_peak = a->heap;
+
+    a->mem_time    = r->time;
+    a->mem_pending = true;
+}
+
+/* ===================================================================== */
+/* API                                                                   */
+/* ===================================================================== */
+
+trace_analyzer_t *trace_analyzer_create(FILE *intervals, FILE *memory, FILE *stats) {
+    trace_analyzer_t *a = calloc(1, sizeof(*a));
+    if (!a) return NULL;
+
+    a->intervals = intervals;
+    a->memory    = memory;
+    a->stats     = stats;
+    if (intervals) fprintf(intervals, "pid,state,start,end,duration,reason\n");
+    if (memory)    fprintf(memory, "time,bytes\n");
+    if (stats)     fprintf(stats, "pid,execution,attente,blocage,reponse,turnaround,switches\n");
+    return a;
+}
+
+void trace_analyzer_put(trace_analyzer_t *a, const trace_rec_t *r) {
+    a->sum.events++;
+    if (r->time > a->sum.makespan) a->sum.makespan = r->time;
+    if (r->cpu + 1 > a->sum.cpus)  a->sum.cpus     = r->cpu + 1;
+
+    if (r->event == EV_MEMORY) {
+        put_memory(a, r);
+        return;
+    }
+    if (r->pid < 0) return;
+
+    proc_slot_t *p = proc_get(a, r->pid);
+    if (!p) return;
+
+    trace_proc_stats_t *s = &p->st;
+    if (s->arrival < 0) {
+        s->arrival = r->time;
+        a->sum.processes++;
+    } else if (r->time > p->cur.time) {
+        emit_interval(a, p, r->time);
+    }
+
+    if (r->state == ST_RUNNING) {
+        s->switches++;
+        if (s->first_run < 0) s->first_run = r->time;
+    }
+    if (r->state == ST_TERMINATED && !s->terminated) {
+        s->terminated = true;
+        s->finish     = r->time;
+        a->sum.terminated++;
+    }
+    if (r->event == EV_OOM_KILL) a->sum.oom_kills++;
+    if (r->event == EV_OOM_KILL || r->event == EV_CREATE_FAIL_OOM) s->killed = true;
+
+    p->cur.state  = r->state;
+    p->cur.reason = r->reason;
+    p->cur.time   = r->time;
+    p->cur.arg    = r->arg;
+
+    // Plus aucun événement après TERMINATED : le processus quitte la table
+    if (r->event == EV_TERMINATED) {
+        retire(a, s);
+        proc_remove(a, p);
+    }
+}
+
+/* Processus vivants en fin de trace : par PID, cases vides à la fin */
+static int cmp_slot(const void *x, const void *y) {
+    const proc_slot_t *p = x, *q = y;
+    if (p->used != q->used) return p->used ? -1 : 1;
+    return (p->st.pid > q->st.pid) - (p->st.pid < q->st.pid);
+}
+
+void trace_analyzer_finish(trace_analyzer_t *a, trace_summary_t *out) {
+    flush_memory(a);
+
+    // La table n'est plus consultée : on peut la trier sur place
+    if (a->capacity) qsort(a->procs, a->capacity, sizeof(*a->procs), cmp_slot);
+    for (size_t i = 0; i < a->live; ++i) retire(a, &a->procs[i].st);
+    a->live = 0;
+    memset(a->procs, 0, a->capacity * sizeof(*a->procs));
+
+    if (a->completed > 0) {
+        a->sum.avg_turnaround = (double)a->turnaround / a->completed;
+        a->sum.avg_ready      = (double)a->ready / a->completed;
+    }
+    if (a->responded > 0) {
+        a->sum.avg_response = (double)a->response / a->responded;
+    }
+    int cpus = a->sum.cpus > 0 ? a->sum.cpus : 1;
+    a->sum.cpu_util = a->sum.makespan > 0
+                    ? (double)a->sum.busy / ((double)a->sum.makespan * cpus) : 0.0;
+
+    if (a->intervals) fflush(a->intervals);
+    if (a->memory)    fflush(a->memory);
+    if (a->stats)     fflush(a->stats);
+    if (out) *out = a->sum;
+}
+
+void trace_analyzer_free(trace_analyzer_t *a) {
+    if (!a) return;
+    free(a->procs);
+    free(a);
+}
@@ -0,0 +1,82 @@
+#ifndef MINIOS_TRACE_ANALYSIS_H
+#define MINIOS_TRACE_ANALYSIS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "trace_event_types.h"
+
+/*
+ * Analyse d'une trace en un seul passage : table des intervalles du Gantt,
+ * courbe mémoire et statistiques par processus, calculées au fil des
+ * événements. Un processus est retiré dès son événement TERMINATED (sa
+ * ligne de stats est écrite, ses cumuls versés au résumé) : la mémoire est
+ * proportionnelle au nombre de processus vivants à la fois, pas à la trace.
+ *
+ * Les intervalles suivent la règle de gantt_plotly.py : pour un PID, deux
+ * événements consécutifs (hors MEMORY) délimitent un intervalle dans l'état
+ * du premier, s'il n'est pas vide.
+ *
+ * Le résumé compte comme le simulateur (--stats) : un changement de
+ * contexte par passage en RUNNING (même de durée nulle), arrivée = premier
+ * événement du PID (CREATE), fin = TERMINATED ; turnaround et réponse
+ * moyens portent sur les processus terminés normalement (ni rejetés, ni
+ * OOM-kill), la réponse sur ceux d'entre eux qui ont été élus.
+ */
+
+/* Cumuls d'un processus (ticks) */
+typedef struct trace_proc_stats {
+    int  pid;
+    int  arrival;        // premier événement
+    int  finish;         // passage en TERMINATED (-1 = pas terminé)
+    int  first_start;    // début du premier intervalle (-1 = aucun)
+    int  last_end;       // fin du dernier intervalle
+    int  first_run;      // premier passage RUNNING (-1 = jamais élu)
+    long running;
+    long ready;
+    long blocked;
+    long switches;       // passages en RUNNING
+    bool terminated;
+    bool killed;         // CREATE_FAIL_OOM ou OOM_KILL
+} trace_proc_stats_t;
+
+typedef struct trace_summary {
+    long    events;
+    long    intervals;
+    int     processes;      // PID vus (hors -1)
+    int     terminated;
+    int     oom_kills;
+    int     makespan;       // dernier temps vu
+    int     cpus;           // plus grand id CPU + 1 (CPU jamais élus non vus)
+    long    busy;           // ticks RUNNING cumulés
+    double  cpu_util;       // busy / (makespan * cpus), interruptions comprises
+    long    switches;
+    double  avg_turnaround; // moyennes sur les processus terminés normalement
+    double  avg_response;
+    double  avg_ready;
+    int64_t heap_peak;      // octets
+} trace_summary_t;
+
+typedef struct trace_analyzer trace_analyzer_t;
+
+/**
+ * intervals : CSV pid,state,start,end,duration,reason (NULL = non écrit)
+ * memory    : CSV time,bytes à chaque changement du heap (NULL = non écrit)
+ * stats     : CSV pid,execution,attente,blocage,reponse,turnaround,switches,
+ *             une ligne par processus dans l'ordre des terminaisons, puis
+ *             les processus encore vivants (NULL = non écrit)
+ * NULL si plus de mémoire.
+ */
+trace_analyzer_t *trace_analyzer_create(FILE *intervals, FILE *memory, FILE *stats);
+
+/** Événements dans l'ordre de la trace. */
+void trace_analyzer_put(trace_analyzer_t *a, const trace_rec_t *r);
+
+/**
+ * Termine les sorties (dernier point mémoire, processus encore vivants)
+ * et calcule le résumé.
+ */
+void trace_analyzer_finish(trace_analyzer_t *a, trace_summary_t *out);
+
+void trace_analyzer_free(trace_analyzer_t *a);
+
+#endif // MINIOS_TRACE_ANALYSIS_H
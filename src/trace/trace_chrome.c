@@ -0,0 +1,234 @@
+#include "trace_chrome.h"
+#include "logger.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+/* Groupes ("pid" au sens Chrome) */
+#define CHROME_GROUP_CPU   0
+#define CHROME_GROUP_PROC  1
+#define CHROME_GROUP_MEM   2
+
+#define CHROME_MAX_CPUS    256
+
+/* État courant d'un processus : la tranche [since, maintenant) est ouverte */
+typedef struct chrome_proc {
+    uint8_t  state;      // ST_NONE = processus pas encore vu
+    uint8_t  reason;     // raison de l'entrée dans l'état
+    uint8_t  queue;
+    bool     named;      // métadonnée thread_name déjà écrite
+    int16_t  cpu;        // CPU si RUNNING, -1 sinon
+    int      since;
+    unsigned flow;       // flèche de réveil en attente (0 = aucune)
+} chrome_proc_t;
+
+struct trace_chrome_writer {
+    FILE          *file;
+    bool           first;        // pas de virgule avant le premier événement
+    chrome_proc_t *procs;        // indexé par PID
+    int            nprocs;
+    int            last_time;
+    unsigned       next_flow;
+    int64_t        heap_used;    // octets alloués (compteur "heap")
+    bool           cpu_named[CHROME_MAX_CPUS];
+};
+
+static inline long long ts_us(int time) {
+    return (long long)time * TRACE_CHROME_US_PER_TICK;
+}
+
+/* Début d'un événement JSON (séparateur compris) */
+static void begin(trace_chrome_writer_t *w) {
+    fputs(w->first ? "\n" : ",\n", w->file);
+    w->first = false;
+}
+
+static void meta_name(trace_chrome_writer_t *w, const char *kind,
+                      int group, int tid, const char *name, int num)
+{
+    begin(w);
+    fprintf(w->file, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                     "\"args\":{\"name\":\"%s",
+            kind, group, tid, name);
+    if (num >= 0) fprintf(w->file, " %d", num);
+    fputs("\"}}", w->file);
+}
+
+static void meta_sort(trace_chrome_writer_t *w, int group) {
+    begin(w);
+    fprintf(w->file, "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,"
+                     "\"args\":{\"sort_index\":%d}}",
+            group, group);
+}
+
+static chrome_proc_t *proc_get(trace_chrome_writer_t *w, int pid) {
+    if (pid < 0) return NULL;
+    if (pid >= w->nprocs) {
+        int n = w->nprocs ? w->nprocs : 64;
+        while (n <= pid) n *= 2;
+        chrome_proc_t *t = realloc(w->procs, (size_t)n * sizeof(*t));
+        if (!t) return NULL;
+        memset(t + w->nprocs, 0, (size_t)(n - w->nprocs) * sizeof(*t));
+        w->procs  = t;
+        w->nprocs = n;
+    }
+
+    chrome_proc_t *p = &w->procs[pid];
+    if (!p->named) {
+        meta_name(w, "thread_name", CHROME_GROUP_PROC, pid, "PID", pid);
+        p->named = true;
+        p->cpu   = -1;
+    }
+    return p;
+}
+
+static void name_cpu(trace_chrome_writer_t *w, int cpu) {
+    if (cpu < 0 || cpu >= CHROME_MAX_CPUS || w->cpu_named[cpu]) return;
+    meta_name(w, "thread_name", CHROME_GROUP_CPU, cpu, "CPU", cpu);
+    w->cpu_named[cpu] = true;
+}
+
+/* Écrit la tranche ouverte de p (et sa tranche CPU) jusqu'à time */
+static void close_slice(trace_chrome_writer_t *w, chrome_proc_t *p, int pid, int time) {
+    if (p->state == ST_NONE || p->state == ST_TERMINATED) return;
+    if (time <= p->since) return;   // tranche vide : transitions au même tick
+
+    long long ts  = ts_us(p->since);
+    long long dur = ts_us(time) - ts;
+
+    begin(w);
+    fprintf(w->file, "{\"name\":\"%s\",\"cat\":\"state\",\"ph\":\"X\",\"ts\":%lld,"
+                     "\"dur\":%lld,\"pid\":%d,\"tid\":%d,"
+                     "\"args\":{\"reason\":\"%s\",\"queue\":\"%s\"}}",
+            trace_state_name(p->state), ts, dur, CHROME_GROUP_PROC, pid,
+            trace_reason_name(p->reason), trace_queue_name(p->queue));
+
+    if (p->state == ST_RUNNING && p->cpu >= 0) {
+        begin(w);
+        fprintf(w->file, "{\"name\":\"P%d\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%lld,"
+                         "\"dur\":%lld,\"pid\":%d,\"tid\":%d,\"args\":{\"pid\":%d}}",
+                pid, ts, dur, CHROME_GROUP_CPU, p->cpu, pid);
+    }
+}
+
+static void instant(trace_chrome_writer_t *w, const trace_rec_t *r, int group, int tid,
+                    const char *scope)
+{
+    begin(w);
+    fprintf(w->file, "{\"name\":\"%s\",\"cat\":\"event\",\"ph\":\"i\",\"s\":\"%s\","
+                     "\"ts\":%lld,\"pid\":%d,\"tid\":%d,\"args\":{",
+            r->event == EV_MEMORY ? trace_state_name(r->state) : trace_ev_name(r->event),
+            scope, ts_us(r->time), group, tid);
+    if (r->reason == RS_VALUE)
+        fprintf(w->file, "\"value\":%" PRId64 "}}", r->arg);
+    else
+        fprintf(w->file, "\"reason\":\"%s\"}}", trace_reason_name(r->reason));
+}
+
+static void put_memory(trace_chrome_writer_t *w, const trace_rec_t *r) {
+    if (r->state == ST_COMPACT) {
+        instant(w, r, CHROME_GROUP_MEM, 0, "p");
+        return;
+    }
+
+    w->heap_used += (r->state == ST_FREE) ? -r->arg : r->arg;
+    begin(w);
+    fprintf(w->file, "{\"name\":\"heap\",\"ph\":\"C\",\"ts\":%lld,\"pid\":%d,"
+                     "\"args\":{\"octets\":%" PRId64 "}}",
+            ts_us(r->time), CHROME_GROUP_MEM, w->heap_used);
+
+    if (r->pid >= 0 && proc_get(w, r->pid))
+        instant(w, r, CHROME_GROUP_PROC, r->pid, "t");
+}
+
+/* ===================================================================== */
+/* API                                                                   */
+/* ===================================================================== */
+
+trace_chrome_writer_t *trace_chrome_writer_open(FILE *f) {
+    trace_chrome_writer_t *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+
+    w->file      = f;
+    w->first     = true;
+    w->next_flow = 1;
+
+    fputs("{\"traceEvents\":[", f);
+    meta_name(w, "process_name", CHROME_GROUP_CPU,  0, "CPU", -1);
+    meta_name(w, "process_name", CHROME_GROUP_PROC, 0, "Processus", -1);
+    meta_name(w, "process_name", CHROME_GROUP_MEM,  0, "Mémoire", -1);
+    meta_sort(w, CHROME_GROUP_CPU);
+    meta_sort(w, CHROME_GROUP_PROC);
+    meta_sort(w, CHROME_GROUP_MEM);
+    return w;
+}
+
+void trace_chrome_writer_put(trace_chrome_writer_t *w, const trace_rec_t *r) {
+    if (!w) return;
+    if (r->time > w->last_time) w->last_time = r->time;
+
+    if (r->event == EV_MEMORY) {
+        put_memory(w, r);
+        return;
+    }
+
+    chrome_proc_t *p = proc_get(w, r->pid);
+    if (!p) return;
+
+    /* Fin de vie : instantané sur la piste du processus */
+    if (r->state == ST_TERMINATED) {
+        close_slice(w, p, r->pid, r->time);
+        instant(w, r, CHROME_GROUP_PROC, r->pid, "t");
+        p->state = ST_TERMINATED;
+        p->flow  = 0;
+        return;
+    }
+
+    /* Réveil : départ de la flèche, dans la tranche READY qui commence */
+    if (r->event == EV_UNBLOCKED) {
+        p->flow = w->next_flow++;
+        begin(w);
+        fprintf(w->file, "{\"name\":\"réveil\",\"cat\":\"wakeup\",\"ph\":\"s\",\"id\":%u,"
+                         "\"ts\":%lld,\"pid\":%d,\"tid\":%d}",
+                p->flow, ts_us(r->time), CHROME_GROUP_PROC, r->pid);
+    }
+
+    bool same = (p->state == r->state) &&
+                (r->state != ST_RUNNING || p->cpu == r->cpu);
+    if (same) return;   // pas de changement visible : la tranche continue
+
+    close_slice(w, p, r->pid, r->time);
+    p->state  = r->state;
+    p->reason = (r->reason == RS_VALUE) ? RS_NONE : r->reason;
+    p->queue  = r->queue;
+    p->since  = r->time;
+    p->cpu    = (r->state == ST_RUNNING) ? r->cpu : -1;
+
+    if (r->state == ST_RUNNING && p->cpu >= 0) {
+        name_cpu(w, p->cpu);
+        if (p->flow) {
+            begin(w);
+            fprintf(w->file, "{\"name\":\"réveil\",\"cat\":\"wakeup\",\"ph\":\"f\",\"bp\":\"e\","
+                             "\"id\":%u,\"ts\":%lld,\"pid\":%d,\"tid\":%d}",
+                    p->flow, ts_us(r->time), CHROME_GROUP_CPU, p->cpu);
+            p->flow = 0;
+        }
+    }
+}
+
+void trace_chrome_writer_close(trace_chrome_writer_t *w) {
+    if (!w) return;
+
+    for (int pid = 0; pid < w->nprocs; ++pid)
+        close_slice(w, &w->procs[pid], pid, w->last_time);
+
+    fprintf(w->file,
+            "\n],\n\"displayTimeUnit\":\"ms\",\n"
+            "\"otherData\":{\"source\":\"miniOS\",\"schema_version\":%d,\"us_per_tick\":%d}}\n",
+            TRACE_SCHEMA_VERSION, TRACE_CHROME_US_PER_TICK);
+
+    free(w->procs);
+    free(w);
+}
@@ -0,0 +1,40 @@
+#ifndef MINIOS_TRACE_CHROME_H
+#define MINIOS_TRACE_CHROME_H
+
+#include <stdio.h>
+#include "trace_event_types.h"
+
+/*
+ * Export au format Chrome Trace Event (JSON), lisible par Perfetto
+ * (ui.perfetto.dev) et chrome://tracing sans prétraitement.
+ *
+ * Les événements miniOS sont des changements d'état ; le codeur garde
+ * l'état courant de chaque processus et écrit des tranches complètes
+ * ("ph":"X") au fil de l'eau :
+ *  - "CPU"       : une piste par CPU, tranches "P<pid>" pendant RUNNING
+ *  - "Processus" : une piste par PID, une tranche par état (NEW, READY,
+ *                  RUNNING, BLOCKED) avec la raison en argument
+ *  - "Mémoire"   : compteur d'octets alloués, compactions en instantanés
+ * Un réveil (UNBLOCKED) ouvre une flèche ("ph":"s"/"f") qui aboutit à la
+ * tranche CPU où le processus reprend la main.
+ *
+ * 1 tick de simulation = TRACE_CHROME_US_PER_TICK µs dans le visualiseur.
+ */
+
+#define TRACE_CHROME_US_PER_TICK 1000   // 1 tick affiché comme 1 ms
+
+typedef struct trace_chrome_writer trace_chrome_writer_t;
+
+/** Écrit l'en-tête JSON dans f. NULL si plus de mémoire. */
+trace_chrome_writer_t *trace_chrome_writer_open(FILE *f);
+
+/** Événements à temps croissants (ordre d'émission de la simulation). */
+void trace_chrome_writer_put(trace_chrome_writer_t *w, const trace_rec_t *r);
+
+/**
+ * Ferme les tranches encore ouvertes au dernier temps vu, termine le
+ * document JSON et libère le codeur (le FILE reste ouvert).
+ */
+void trace_chrome_writer_close(trace_chrome_writer_t *w);
+
+#endif // MINIOS_TRACE_CHROME_H
@@ -0,0 +1,339 @@
+#include "trace_compact.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef MINIOS_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/* ===================================================================== */
+/* VARINTS                                                               */
+/* ===================================================================== */
+
+/* Un varint 64 bits tient sur 10 octets ; un événement au plus sur ~40 */
+#define CZ_EVENT_MAX_BYTES 48
+
+static inline uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline unsigned char *put_varint(unsigned char *p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static int get_varint(const unsigned char *buf, size_t len, size_t *pos, uint64_t *out) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pos >= len) return -1;
+        unsigned char c = buf[(*pos)++];
+        v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            *out = v;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* ===================================================================== */
+/* ÉCRITURE                                                              */
+/* ===================================================================== */
+
+#define CZ_HASH_SLOTS 512   // puissance de 2, > 2 x TRACE_CZ_TUPLE_MAX
+
+struct trace_cz_writer {
+    FILE          *file;
+    int            zlib_level;
+
+    unsigned char *raw;           // bloc en cours (non compressé)
+    size_t         raw_cap;
+    size_t         raw_len;
+    unsigned char *out;           // tampon de compression
+    size_t         out_cap;
+
+    uint32_t       count;
+    int32_t        first_time;
+    int32_t        prev_time;
+
+    int            ntuples;
+    uint64_t       hash_key[CZ_HASH_SLOTS];   // clé du tuple + 1 (0 = vide)
+    uint8_t        hash_id[CZ_HASH_SLOTS];
+};
+
+static uint64_t tuple_key(const trace_rec_t *r) {
+    return (uint64_t)r->event
+         | (uint64_t)r->state  << 8
+         | (uint64_t)r->reason << 16
+         | (uint64_t)r->queue  << 24
+         | (uint64_t)(uint16_t)r->cpu << 32
+         | (uint64_t)(r->arg != 0) << 48;
+}
+
+trace_cz_writer_t *trace_cz_writer_open(FILE *f, int zlib_level,
+                                        const unsigned char *table,
+                                        uint32_t table_bytes)
+{
+#ifndef MINIOS_HAVE_ZLIB
+    if (zlib_level > 0) {
+        fprintf(stderr, "[TRACE] miniOS compilé sans zlib : trace compacte non compressée\n");
+        zlib_level = 0;
+    }
+#endif
+    if (zlib_level > 9) zlib_level = 9;
+
+    trace_cz_writer_t *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+
+    w->file       = f;
+    w->zlib_level = zlib_level;
+    w->raw_cap    = (size_t)TRACE_CZ_SYNC_INTERVAL * CZ_EVENT_MAX_BYTES;
+    w->raw        = malloc(w->raw_cap);
+    if (!w->raw) {
+        free(w);
+        return NULL;
+    }
+#ifdef MINIOS_HAVE_ZLIB
+    if (zlib_level > 0) {
+        w->out_cap = compressBound((uLong)w->raw_cap);
+        w->out     = malloc(w->out_cap);
+        if (!w->out) {
+            free(w->raw);
+            free(w);
+            return NULL;
+        }
+    }
+#endif
+
+    trace_cz_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_CZ_MAGIC, 4);
+    h.version        = TRACE_CZ_VERSION;
+    h.endian_tag     = TRACE_BIN_ENDIAN_TAG;
+    h.schema_version = TRACE_SCHEMA_VERSION;
+    h.flags          = zlib_level > 0 ? TRACE_CZ_FLAG_ZLIB : 0;
+    h.table_bytes    = table_bytes;
+    fwrite(&h, sizeof(h), 1, f);
+    fwrite(table, 1, table_bytes, f);
+
+    return w;
+}
+
+void trace_cz_writer_flush(trace_cz_writer_t *w) {
+    if (!w || w->count == 0) return;
+
+    trace_cz_block_header_t bh;
+    bh.magic        = TRACE_CZ_BLOCK_MAGIC;
+    bh.raw_bytes    = (uint32_t)w->raw_len;
+    bh.count        = w->count;
+    bh.first_time   = w->first_time;
+    bh.last_time    = w->prev_time;
+
+    const unsigned char *payload = w->raw;
+    size_t               stored  = w->raw_len;
+#ifdef MINIOS_HAVE_ZLIB
+    if (w->zlib_level > 0) {
+        uLongf dlen = (uLongf)w->out_cap;
+        if (compress2(w->out, &dlen, w->raw, (uLong)w->raw_len, w->zlib_level) == Z_OK) {
+            payload = w->out;
+            stored  = dlen;
+        } else {
+            fprintf(stderr, "[TRACE] échec zlib, bloc perdu\n");
+            stored = 0;
+        }
+    }
+#endif
+    bh.stored_bytes = (uint32_t)stored;
+
+    if (stored > 0) {
+        fwrite(&bh, sizeof(bh), 1, w->file);
+        fwrite(payload, 1, stored, w->file);
+    }
+
+    /* Point de synchronisation : le bloc suivant repart de zéro */
+    w->raw_len = 0;
+    w->count   = 0;
+    w->ntuples = 0;
+    memset(w->hash_key, 0, sizeof(w->hash_key));
+}
+
+void trace_cz_writer_put(trace_cz_writer_t *w, const trace_rec_t *r) {
+    if (w->count == 0) {
+        w->first_time = r->time;
+        w->prev_time  = r->time;
+    }
+
+    unsigned char *p   = w->raw + w->raw_len;
+    uint64_t       key = tuple_key(r);
+
+    /* Tuple connu ? */
+    uint32_t h = (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 55) & (CZ_HASH_SLOTS - 1);
+    while (w->hash_key[h] && w->hash_key[h] != key + 1) {
+        h = (h + 1) & (CZ_HASH_SLOTS - 1);
+    }
+
+    if (w->hash_key[h]) {
+        p = put_varint(p, w->hash_id[h]);
+    } else {
+        p = put_varint(p, (uint64_t)w->ntuples);   // = définition
+        *p++ = r->event;
+        *p++ = r->state;
+        *p++ = r->reason;
+        *p++ = r->queue;
+        p = put_varint(p, zigzag(r->cpu));
+        *p++ = (unsigned char)(r->arg != 0);
+        if (w->ntuples < TRACE_CZ_TUPLE_MAX) {
+            w->hash_key[h] = key + 1;
+            w->hash_id[h]  = (uint8_t)w->ntuples++;
+        }
+    }
+
+    p = put_varint(p, zigzag((int64_t)r->time - w->prev_time));
+    p = put_varint(p, zigzag(r->pid));
+    if (r->arg != 0) {
+        p = put_varint(p, zigzag(r->arg));
+    }
+
+    w->raw_len   = (size_t)(p - w->raw);
+    w->prev_time = r->time;
+    w->count++;
+
+    if (w->count >= TRACE_CZ_SYNC_INTERVAL) {
+        trace_cz_writer_flush(w);
+    }
+}
+
+void trace_cz_writer_close(trace_cz_writer_t *w) {
+    if (!w) return;
+    trace_cz_writer_flush(w);
+    free(w->raw);
+    free(w->out);
+    free(w);
+}
+
+/* ===================================================================== */
+/* LECTURE                                                               */
+/* ===================================================================== */
+
+static int ensure(unsigned char **buf, size_t *cap, size_t need) {
+    if (*cap >= need) return 0;
+    unsigned char *n = realloc(*buf, need);
+    if (!n) return -1;
+    *buf = n;
+    *cap = need;
+    return 0;
+}
+
+int trace_cz_read_block(FILE *f, unsigned flags, trace_cz_block_t *b) {
+    size_t n = fread(&b->hdr, 1, sizeof(b->hdr), f);
+    if (n == 0) return 0;
+    if (n != sizeof(b->hdr) || b->hdr.magic != TRACE_CZ_BLOCK_MAGIC) return -1;
+
+    if (ensure(&b->raw, &b->raw_cap, b->hdr.raw_bytes ? b->hdr.raw_bytes : 1) != 0) return -1;
+
+    if (flags & TRACE_CZ_FLAG_ZLIB) {
+#ifdef MINIOS_HAVE_ZLIB
+        if (ensure(&b->stored, &b->stored_cap, b->hdr.stored_bytes ? b->hdr.stored_bytes : 1) != 0) return -1;
+        if (fread(b->stored, 1, b->hdr.stored_bytes, f) != b->hdr.stored_bytes) return -1;
+        uLongf dlen = b->hdr.raw_bytes;
+        if (uncompress(b->raw, &dlen, b->stored, b->hdr.stored_bytes) != Z_OK ||
+            dlen != b->hdr.raw_bytes) {
+            return -1;
+        }
+#else
+        fprintf(stderr, "trace compressée zlib : miniOS compilé sans zlib\n");
+        return -1;
+#endif
+    } else {
+        if (b->hdr.stored_bytes != b->hdr.raw_bytes) return -1;
+        if (fread(b->raw, 1, b->hdr.raw_bytes, f) != b->hdr.raw_bytes) return -1;
+    }
+
+    b->pos       = 0;
+    b->decoded   = 0;
+    b->prev_time = b->hdr.first_time;
+    b->ntuples   = 0;
+    return 1;
+}
+
+int trace_cz_skip_block_before(FILE *f, int32_t time) {
+    trace_cz_block_header_t bh;
+    long start = ftell(f);
+
+    size_t n = fread(&bh, 1, sizeof(bh), f);
+    if (n == 0) return 0;
+    if (n != sizeof(bh) || bh.magic != TRACE_CZ_BLOCK_MAGIC) return -1;
+
+    if (bh.last_time < time) {
+        return fseek(f, (long)bh.stored_bytes, SEEK_CUR) == 0 ? 1 : -1;
+    }
+    return fseek(f, start, SEEK_SET) == 0 ? 0 : -1;
+}
+
+int trace_cz_block_next(trace_cz_block_t *b, trace_rec_t *out) {
+    if (b->decoded >= b->hdr.count) return 0;
+
+    const unsigned char *raw = b->raw;
+    size_t               len = b->hdr.raw_bytes;
+    uint64_t             v;
+    trace_cz_tuple_t     t;
+
+    if (get_varint(raw, len, &b->pos, &v) != 0) return -1;
+    if (v < (uint64_t)b->ntuples) {
+        t = b->tuples[v];
+    } else if (v == (uint64_t)b->ntuples) {
+        if (b->pos + 4 > len) return -1;
+        t.event  = raw[b->pos++];
+        t.state  = raw[b->pos++];
+        t.reason = raw[b->pos++];
+        t.queue  = raw[b->pos++];
+        if (get_varint(raw, len, &b->pos, &v) != 0) return -1;
+        t.cpu = (int16_t)unzigzag(v);
+        if (b->pos >= len) return -1;
+        t.has_arg = raw[b->pos++];
+        if (b->ntuples < TRACE_CZ_TUPLE_MAX) {
+            b->tuples[b->ntuples++] = t;
+        }
+    } else {
+        return -1;
+    }
+
+    if (get_varint(raw, len, &b->pos, &v) != 0) return -1;
+    b->prev_time = (int32_t)(b->prev_time + unzigzag(v));
+
+    memset(out, 0, sizeof(*out));
+    out->time   = b->prev_time;
+    out->event  = t.event;
+    out->state  = t.state;
+    out->reason = t.reason;
+    out->queue  = t.queue;
+    out->cpu    = t.cpu;
+
+    if (get_varint(raw, len, &b->pos, &v) != 0) return -1;
+    out->pid = (int32_t)unzigzag(v);
+
+    if (t.has_arg) {
+        if (get_varint(raw, len, &b->pos, &v) != 0) return -1;
+        out->arg = unzigzag(v);
+    }
+
+    b->decoded++;
+    return 1;
+}
+
+void trace_cz_block_free(trace_cz_block_t *b) {
+    free(b->raw);
+    free(b->stored);
+    b->raw    = NULL;
+    b->stored = NULL;
+    b->raw_cap = b->stored_cap = 0;
+}
@@ -0,0 +1,72 @@
+#ifndef MINIOS_TRACE_COMPACT_H
+#define MINIOS_TRACE_COMPACT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "trace_event_types.h"
+#include "trace_format.h"
+
+/*
+ * Codage / décodage des blocs du format compact (.ctrace, cf.
+ * trace_format.h). Utilisé par logger.c (écriture) et trace_reader.c.
+ */
+
+/* Table des tuples d'un bloc (partagée par le codeur et le décodeur) */
+typedef struct trace_cz_tuple {
+    uint8_t event, state, reason, queue;
+    int16_t cpu;
+    uint8_t has_arg;
+} trace_cz_tuple_t;
+
+/* ---- Écriture ---- */
+
+typedef struct trace_cz_writer trace_cz_writer_t;
+
+/**
+ * Écrit l'en-tête + la table des libellés dans f et prépare le codeur.
+ * zlib_level : 0 = pas de compression, 1..9 = niveau zlib (ignoré avec un
+ * avertissement si miniOS est compilé sans zlib). NULL si plus de mémoire.
+ */
+trace_cz_writer_t *trace_cz_writer_open(FILE *f, int zlib_level,
+                                        const unsigned char *table,
+                                        uint32_t table_bytes);
+
+void trace_cz_writer_put(trace_cz_writer_t *w, const trace_rec_t *r);
+
+/** Termine le bloc en cours (point de synchronisation) et l'écrit. */
+void trace_cz_writer_flush(trace_cz_writer_t *w);
+
+/** Flush + libération (le FILE reste ouvert). */
+void trace_cz_writer_close(trace_cz_writer_t *w);
+
+/* ---- Lecture ---- */
+
+typedef struct trace_cz_block {
+    trace_cz_block_header_t hdr;
+    unsigned char   *raw;          // charge utile décompressée
+    size_t           raw_cap;
+    unsigned char   *stored;       // tampon de lecture (zlib)
+    size_t           stored_cap;
+    size_t           pos;          // position de décodage dans raw
+    uint32_t         decoded;      // événements déjà rendus
+    int32_t          prev_time;
+    int              ntuples;
+    trace_cz_tuple_t tuples[TRACE_CZ_TUPLE_MAX];
+} trace_cz_block_t;
+
+/**
+ * Lit le bloc suivant de f. flags : ceux de l'en-tête du fichier.
+ * 1 si un bloc est prêt, 0 en fin de fichier, -1 si corrompu/tronqué.
+ */
+int trace_cz_read_block(FILE *f, unsigned flags, trace_cz_block_t *b);
+
+/** Saute le bloc suivant sans le décoder si last_time < time.
+ *  1 si un bloc a été sauté, 0 sinon (bloc suivant à lire), -1 si erreur. */
+int trace_cz_skip_block_before(FILE *f, int32_t time);
+
+/** Événement suivant du bloc : 1, 0 si le bloc est épuisé, -1 si corrompu. */
+int trace_cz_block_next(trace_cz_block_t *b, trace_rec_t *out);
+
+void trace_cz_block_free(trace_cz_block_t *b);
+
+#endif // MINIOS_TRACE_COMPACT_H
@@ -1,16 +1,104 @@
-
-// TEMPORAIRE
-
 #ifndef MINIOS_TRACE_EVENT_TYPES_H
 #define MINIOS_TRACE_EVENT_TYPES_H
 
-// Tous les types d'événements utiles pour les stats + graphiques
-#define EVENT_CREATE        "CREATE"
-#define EVENT_STATE_CHANGE  "STATE_CHANGE"
-#define EVENT_BLOCKED       "BLOCKED"
-#define EVENT_UNBLOCKED     "UNBLOCKED"
-#define EVENT_TERMINATE     "TERMINATED"
-#define EVENT_SCHED_SELECT  "SCHED_SELECT"
-#define EVENT_CONTEXT_SWITCH "CONTEXT_SWITCH"
+#include <stdint.h>
+
+/*
+ * Schéma des événements de trace.
+ *
+ * Un événement = 4 codes (event, state, reason, queue) + cpu + un payload
+ * numérique 'arg'. Les libellés ne servent qu'à l'export (CSV, en-tête des
+ * traces binaires) : l'enregistrement lui-même ne manipule aucune chaîne.
+ *
+ * Règle de compatibilité : on AJOUTE des codes en fin d'enum, on ne
+ * renumérote jamais. Tout changement de sens d'un code existant ou du
+ * format des enregistrements incrémente TRACE_SCHEMA_VERSION.
+ */
+#define TRACE_SCHEMA_VERSION 2
+
+typedef enum {
+    EV_CREATE = 0,
+    EV_STATE_CHANGE,
+    EV_PREEMPTED,
+    EV_UNBLOCKED,
+    EV_TERMINATED,
+    EV_MEMORY,
+    EV_CREATE_FAIL_OOM,
+    EV_OOM_KILL,
+    EV_COUNT
+} trace_ev_t;
+
+/* État après l'événement (pour EV_MEMORY : l'opération sur le heap) */
+typedef enum {
+    ST_NONE = 0,
+    ST_NEW,
+    ST_READY,
+    ST_RUNNING,
+    ST_BLOCKED,
+    ST_TERMINATED,
+    ST_ALLOC,
+    ST_FREE,
+    ST_COMPACT,
+    ST_COUNT
+} trace_state_t;
+
+typedef enum {
+    RS_NONE = 0,
+    RS_VALUE,               // la raison est 'arg' (taille, coût en ticks...)
+    RS_UNKNOWN,
+    RS_HIGHER_PRIORITY,     // préemption par un plus prioritaire
+    RS_TIMER,
+    RS_QUANTUM,
+    RS_IO,
+    RS_MUTEX,
+    RS_SEMAPHORE,
+    RS_MEMORY,              // attente d'admission mémoire
+    RS_OOM_LARGEST_RSS,     // politiques de l'OOM-killer
+    RS_OOM_LOWEST_PRIORITY,
+    RS_OOM_YOUNGEST,
+    RS_IO_QUEUE,            // requête I/O en file, tous les canaux du périphérique occupés
+    RS_AIO_WAIT,            // WAIT sur des I/O asynchrones
+    RS_COUNT
+} trace_reason_t;
+
+typedef enum {
+    Q_NONE = 0,
+    Q_NEW,
+    Q_READY,
+    Q_CPU,
+    Q_BLOCKED,
+    Q_TERM,
+    Q_MEM,
+    Q_MEM_WAIT,
+    Q_IO_PRINTER,           // périphériques : même ordre que io_device_t
+    Q_IO_KEYBOARD,
+    Q_IO_MOUSE,
+    Q_IO_DISK,
+    Q_IO_SCREEN,
+    Q_IO_NETWORK,
+    Q_COUNT
+} trace_queue_t;
+
+/* File du périphérique dev (io_device_t) */
+#define Q_IO_FIRST Q_IO_PRINTER
+
+/* Enregistrement en mémoire (et sur disque, format binaire v2) */
+typedef struct trace_rec {
+    int32_t  time;
+    int32_t  pid;
+    int16_t  cpu;
+    uint8_t  event;        // trace_ev_t
+    uint8_t  state;        // trace_state_t
+    uint8_t  reason;       // trace_reason_t
+    uint8_t  queue;        // trace_queue_t
+    uint16_t reserved;
+    int64_t  arg;          // payload numérique (cf. RS_VALUE)
+} trace_rec_t;
+
+/* Libellés d'export ("" pour un code hors schéma) */
+const char *trace_ev_name(unsigned code);
+const char *trace_state_name(unsigned code);
+const char *trace_reason_name(unsigned code);
+const char *trace_queue_name(unsigned code);
 
 #endif //MINIOS_TRACE_EVENT_TYPES_H
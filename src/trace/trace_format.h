@@ -0,0 +1,149 @@
+#ifndef MINIOS_TRACE_FORMAT_H
+#define MINIOS_TRACE_FORMAT_H
+
+#include <stdint.h>
+#include "trace_event_types.h"
+
+/*
+ * Format binaire des traces (.mtrace), version 2.
+ *
+ *   [en-tête 16 octets] [table des libellés] [trace_rec_t] [trace_rec_t] ...
+ *
+ * Les enregistrements sont les trace_rec_t du schéma (trace_event_types.h),
+ * écrits tels quels. La table des libellés recopie les noms de tous les
+ * codes connus de l'émetteur : un lecteur plus ancien que le schéma sait
+ * donc quand même afficher les codes ajoutés depuis.
+ *
+ * Table : suite d'entrées { u8 domaine, u8 code, u8 longueur, texte }.
+ *
+ * Les entiers sont écrits dans l'ordre natif de l'hôte : le lecteur
+ * (trace_reader) refuse un fichier dont l'en-tête ne correspond pas.
+ */
+
+#define TRACE_BIN_MAGIC        "MTRC"
+#define TRACE_BIN_VERSION      2
+#define TRACE_BIN_ENDIAN_TAG   0x0102     // relu 0x0201 sur un hôte d'endianness opposée
+
+/* Domaines de la table des libellés */
+enum {
+    TRACE_DOMAIN_EVENT = 0,
+    TRACE_DOMAIN_STATE,
+    TRACE_DOMAIN_REASON,
+    TRACE_DOMAIN_QUEUE,
+    TRACE_DOMAIN_COUNT
+};
+
+typedef struct trace_bin_header {
+    char     magic[4];
+    uint16_t version;          // format de fichier (TRACE_BIN_VERSION)
+    uint16_t endian_tag;
+    uint16_t record_size;      // sizeof(trace_rec_t)
+    uint16_t schema_version;   // TRACE_SCHEMA_VERSION de l'émetteur
+    uint32_t table_bytes;      // taille de la table qui suit l'en-tête
+} trace_bin_header_t;
+
+#define TRACE_BIN_RECORD_SIZE  24
+
+typedef char trace_bin_header_size_check[(sizeof(trace_bin_header_t) == 16) ? 1 : -1];
+typedef char trace_bin_record_size_check[(sizeof(trace_rec_t) == TRACE_BIN_RECORD_SIZE) ? 1 : -1];
+
+/*
+ * Format compact (.ctrace), version 1 : flux de blocs indépendants.
+ *
+ *   [en-tête 16 octets] [table des libellés] [bloc] [bloc] ...
+ *   bloc = [en-tête de bloc 24 octets] [charge utile, éventuellement zlib]
+ *
+ * Chaque bloc est un point de synchronisation : l'état du codeur (temps
+ * précédent, table des tuples) repart de zéro, on peut donc sauter des
+ * blocs entiers (first_time / last_time) ou reprendre la lecture après
+ * une troncature.
+ *
+ * Dans la charge utile, chaque événement s'écrit en varints LEB128 :
+ *   tuple   : indice dans la table des tuples du bloc ; s'il vaut le
+ *             nombre de tuples connus, suit une définition
+ *             { event, state, reason, queue (1 octet chacun),
+ *               cpu (zigzag), has_arg (1 octet) }
+ *             ajoutée à la table tant qu'elle a moins de TRACE_CZ_TUPLE_MAX
+ *             entrées ;
+ *   dt      : zigzag(time - time précédent), first_time pour le 1er ;
+ *   pid     : zigzag(pid) ;
+ *   arg     : zigzag(arg), seulement si le tuple a has_arg.
+ */
+
+#define TRACE_CZ_MAGIC          "MTRZ"
+#define TRACE_CZ_VERSION        1
+#define TRACE_CZ_FLAG_ZLIB      0x0001
+#define TRACE_CZ_BLOCK_MAGIC    0x4B4C424Du   // "MBLK" (petit-boutiste)
+#define TRACE_CZ_SYNC_INTERVAL  4096          // événements par bloc
+#define TRACE_CZ_TUPLE_MAX      255
+
+typedef struct trace_cz_header {
+    char     magic[4];
+    uint16_t version;          // TRACE_CZ_VERSION
+    uint16_t endian_tag;
+    uint16_t schema_version;   // TRACE_SCHEMA_VERSION de l'émetteur
+    uint16_t flags;            // TRACE_CZ_FLAG_*
+    uint32_t table_bytes;      // table des libellés (même forme qu'en v2)
+} trace_cz_header_t;
+
+typedef struct trace_cz_block_header {
+    uint32_t magic;            // TRACE_CZ_BLOCK_MAGIC
+    uint32_t stored_bytes;     // taille de la charge utile dans le fichier
+    uint32_t raw_bytes;        // taille après décompression
+    uint32_t count;            // nombre d'événements du bloc
+    int32_t  first_time;
+    int32_t  last_time;
+} trace_cz_block_header_t;
+
+typedef char trace_cz_header_size_check[(sizeof(trace_cz_header_t) == 16) ? 1 : -1];
+typedef char trace_cz_block_size_check[(sizeof(trace_cz_block_header_t) == 24) ? 1 : -1];
+
+/*
+ * Index de trace (<trace>.idx), version 1 : construit en un passage par
+ * trace_index_build, pour lire une tranche de temps ou un PID sans
+ * parcourir toute la trace.
+ *
+ *   [en-tête 40 octets] [blocs] [répertoire des PID] [listes de blocs]
+ *
+ * Un bloc couvre au moins TRACE_IDX_BLOCK_EVENTS événements consécutifs et
+ * commence à un point de reprise du lecteur (trace_reader_tell : début de
+ * bloc pour .ctrace, n'importe quel enregistrement ou ligne sinon). Pour
+ * chaque PID, la liste (u32 croissants) des blocs où il apparaît.
+ * trace_size / trace_mtime détectent un index périmé.
+ */
+
+#define TRACE_IDX_MAGIC         "MTRX"
+#define TRACE_IDX_VERSION       1
+#define TRACE_IDX_BLOCK_EVENTS  4096
+
+typedef struct trace_idx_header {
+    char     magic[4];
+    uint16_t version;          // TRACE_IDX_VERSION
+    uint16_t endian_tag;       // TRACE_BIN_ENDIAN_TAG
+    uint32_t block_events;
+    uint32_t nblocks;
+    uint32_t npids;
+    uint32_t reserved;
+    int64_t  trace_size;       // octets de la trace indexée
+    int64_t  trace_mtime;      // date de modification (secondes)
+} trace_idx_header_t;
+
+typedef struct trace_idx_block {
+    int64_t  offset;           // point de reprise (trace_reader_seek_pos)
+    int32_t  first_time;
+    int32_t  last_time;
+    uint32_t count;            // événements du bloc
+    uint32_t reserved;
+} trace_idx_block_t;
+
+typedef struct trace_idx_pid {
+    int32_t  pid;
+    uint32_t nblocks;          // longueur de la liste
+    uint64_t postings;         // position de la liste dans l'index
+} trace_idx_pid_t;
+
+typedef char trace_idx_header_size_check[(sizeof(trace_idx_header_t) == 40) ? 1 : -1];
+typedef char trace_idx_block_size_check[(sizeof(trace_idx_block_t) == 24) ? 1 : -1];
+typedef char trace_idx_pid_size_check[(sizeof(trace_idx_pid_t) == 16) ? 1 : -1];
+
+#endif // MINIOS_TRACE_FORMAT_H
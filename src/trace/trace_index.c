@@ -0,0 +1,384 @@
+#include "trace_index.h"
+#include "trace_format.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+struct trace_index {
+    trace_reader_t    *reader;
+    FILE              *file;        // index (listes lues à la demande)
+    trace_idx_header_t hdr;
+    trace_idx_block_t *blocks;
+    trace_idx_pid_t   *pids;        // triés par PID
+    int32_t           *max_last;    // max(last_time) des blocs 0..b
+    int32_t           *min_first;   // min(first_time) des blocs b..fin
+    trace_query_t     *query;       // requête ouverte
+};
+
+struct trace_query {
+    trace_index_t *ix;
+    int            from, to, pid;
+    uint32_t      *list;            // blocs du PID (NULL = tous)
+    uint32_t       nlist;
+    uint32_t       cursor;          // position dans list, ou bloc suivant
+    uint32_t       start;           // premier bloc utile
+    uint32_t       remaining;       // événements restants du bloc en cours
+    unsigned       blocks_read;
+};
+
+static void index_path_of(const char *trace_path, char *out, size_t size) {
+    snprintf(out, size, "%s.idx", trace_path);
+}
+
+static int trace_stat(const char *path, int64_t *size, int64_t *mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) return -1;
+    *size  = (int64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return 0;
+}
+
+/* ===================================================================== */
+/* CONSTRUCTION                                                          */
+/* ===================================================================== */
+
+/* Liste des blocs d'un PID pendant la construction */
+typedef struct posting {
+    uint32_t *blocks;
+    uint32_t  n, cap;
+} posting_t;
+
+static int posting_add(posting_t *p, uint32_t block) {
+    if (p->n > 0 && p->blocks[p->n - 1] == block) return 0;
+    if (p->n == p->cap) {
+        uint32_t  cap = p->cap ? p->cap * 2 : 16;
+        uint32_t *b   = realloc(p->blocks, cap * sizeof(*b));
+        if (!b) return -1;
+        p->blocks = b;
+        p->cap    = cap;
+    }
+    p->blocks[p->n++] = block;
+    return 0;
+}
+
+int trace_index_build(const char *trace_path, const char *index_path) {
+    char default_path[1024];
+    if (!index_path) {
+        index_path_of(trace_path, default_path, sizeof(default_path));
+        index_path = default_path;
+    }
+
+    trace_idx_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_IDX_MAGIC, 4);
+    h.version      = TRACE_IDX_VERSION;
+    h.endian_tag   = TRACE_BIN_ENDIAN_TAG;
+    h.block_events = TRACE_IDX_BLOCK_EVENTS;
+    if (trace_stat(trace_path, &h.trace_size, &h.trace_mtime) != 0) {
+        perror(trace_path);
+        return -1;
+    }
+
+    trace_reader_t *r = trace_reader_open(trace_path);
+    if (!r) return -1;
+
+    trace_idx_block_t *blocks  = NULL;
+    uint32_t           nblocks = 0, cap_blocks = 0;
+    posting_t         *post    = NULL;    // indexé par pid + 1 (pid -1 inclus)
+    int                npost   = 0;
+    int                rc, err = 0;
+    trace_entry_t      e;
+
+    for (;;) {
+        long pos = trace_reader_tell(r);
+        if ((rc = trace_reader_next(r, &e)) <= 0) break;
+
+        trace_idx_block_t *cur = nblocks ? &blocks[nblocks - 1] : NULL;
+        if (!cur || (cur->count >= TRACE_IDX_BLOCK_EVENTS && pos >= 0)) {
+            if (nblocks == cap_blocks) {
+                cap_blocks = cap_blocks ? cap_blocks * 2 : 256;
+                trace_idx_block_t *b = realloc(blocks, cap_blocks * sizeof(*b));
+                if (!b) { err = 1; break; }
+                blocks = b;
+            }
+            cur = &blocks[nblocks++];
+            memset(cur, 0, sizeof(*cur));
+            cur->offset     = pos;
+            cur->first_time = e.time;
+            cur->last_time  = e.time;
+        }
+        cur->count++;
+        if (e.time < cur->first_time) cur->first_time = e.time;
+        if (e.time > cur->last_time)  cur->last_time  = e.time;
+
+        if (e.pid < -1) continue;
+        if (e.pid + 1 >= npost) {
+            int n = npost ? npost : 64;
+            while (n <= e.pid + 1) n *= 2;
+            posting_t *p = realloc(post, (size_t)n * sizeof(*p));
+            if (!p) { err = 1; break; }
+            memset(p + npost, 0, (size_t)(n - npost) * sizeof(*p));
+            post  = p;
+            npost = n;
+        }
+        if (posting_add(&post[e.pid + 1], nblocks - 1) != 0) { err = 1; break; }
+    }
+    trace_reader_close(r);
+
+    FILE *f = NULL;
+    if (rc < 0) {
+        fprintf(stderr, "%s : trace illisible, index non écrit\n", trace_path);
+        err = 1;
+    } else if (err) {
+        fprintf(stderr, "[TRACE] index : plus de mémoire\n");
+    } else if (!(f = fopen(index_path, "wb"))) {
+        perror(index_path);
+        err = 1;
+    }
+
+    if (!err) {
+        for (int i = 0; i < npost; ++i) {
+            if (post[i].n) h.npids++;
+        }
+        h.nblocks = nblocks;
+
+        /* Listes après l'en-tête, les blocs et le répertoire */
+        uint64_t at = sizeof(h) + (uint64_t)nblocks * sizeof(trace_idx_block_t)
+                    + (uint64_t)h.npids * sizeof(trace_idx_pid_t);
+
+        fwrite(&h, sizeof(h), 1, f);
+        fwrite(blocks, sizeof(*blocks), nblocks, f);
+        for (int i = 0; i < npost; ++i) {
+            if (!post[i].n) continue;
+            trace_idx_pid_t d = { i - 1, post[i].n, at };
+            fwrite(&d, sizeof(d), 1, f);
+            at += (uint64_t)post[i].n * sizeof(uint32_t);
+        }
+        for (int i = 0; i < npost; ++i) {
+            if (post[i].n) fwrite(post[i].blocks, sizeof(uint32_t), post[i].n, f);
+        }
+        if (fclose(f) != 0) {
+            perror(index_path);
+            err = 1;
+        }
+    }
+
+    for (int i = 0; i < npost; ++i) free(post[i].blocks);
+    free(post);
+    free(blocks);
+    return err ? -1 : 0;
+}
+
+/* ===================================================================== */
+/* OUVERTURE                                                             */
+/* ===================================================================== */
+
+/* Charge l'index s'il correspond à la trace ; -1 sinon (ix inchangé) */
+static int load(trace_index_t *ix, const char *trace_path, const char *index_path) {
+    int64_t size, mtime;
+    if (trace_stat(trace_path, &size, &mtime) != 0) return -1;
+
+    FILE *f = fopen(index_path, "rb");
+    if (!f) return -1;
+
+    trace_idx_header_t h;
+    if (fread(&h, sizeof(h), 1, f) != 1 ||
+        memcmp(h.magic, TRACE_IDX_MAGIC, 4) != 0 ||
+        h.version != TRACE_IDX_VERSION || h.endian_tag != TRACE_BIN_ENDIAN_TAG ||
+        h.trace_size != size || h.trace_mtime != mtime) {
+        fclose(f);
+        return -1;
+    }
+
+    size_t nb = h.nblocks ? h.nblocks : 1, np = h.npids ? h.npids : 1;
+    ix->blocks    = malloc(nb * sizeof(*ix->blocks));
+    ix->pids      = malloc(np * sizeof(*ix->pids));
+    ix->max_last  = malloc(nb * sizeof(*ix->max_last));
+    ix->min_first = malloc(nb * sizeof(*ix->min_first));
+    if (!ix->blocks || !ix->pids || !ix->max_last || !ix->min_first ||
+        fread(ix->blocks, sizeof(*ix->blocks), h.nblocks, f) != h.nblocks ||
+        fread(ix->pids, sizeof(*ix->pids), h.npids, f) != h.npids) {
+        free(ix->blocks);
+        free(ix->pids);
+        free(ix->max_last);
+        free(ix->min_first);
+        ix->blocks = NULL;
+        ix->pids   = NULL;
+        ix->max_last = ix->min_first = NULL;
+        fclose(f);
+        return -1;
+    }
+
+    /* Bornes cumulées : recherche correcte même si les temps reculent */
+    for (uint32_t b = 0; b < h.nblocks; ++b) {
+        int32_t last = ix->blocks[b].last_time;
+        ix->max_last[b] = (b > 0 && ix->max_last[b - 1] > last) ? ix->max_last[b - 1] : last;
+    }
+    for (uint32_t b = h.nblocks; b-- > 0;) {
+        int32_t first = ix->blocks[b].first_time;
+        ix->min_first[b] = (b + 1 < h.nblocks && ix->min_first[b + 1] < first)
+                         ? ix->min_first[b + 1] : first;
+    }
+
+    ix->file = f;
+    ix->hdr  = h;
+    return 0;
+}
+
+trace_index_t *trace_index_open(const char *trace_path) {
+    char index_path[1024];
+    index_path_of(trace_path, index_path, sizeof(index_path));
+
+    trace_index_t *ix = calloc(1, sizeof(*ix));
+    if (!ix) return NULL;
+
+    if (load(ix, trace_path, index_path) != 0) {
+        if (trace_index_build(trace_path, index_path) != 0 ||
+            load(ix, trace_path, index_path) != 0) {
+            fprintf(stderr, "%s : index inutilisable\n", index_path);
+            free(ix);
+            return NULL;
+        }
+    }
+
+    ix->reader = trace_reader_open(trace_path);
+    if (!ix->reader) {
+        trace_index_close(ix);
+        return NULL;
+    }
+    return ix;
+}
+
+void trace_index_close(trace_index_t *ix) {
+    if (!ix) return;
+    trace_query_close(ix->query);
+    trace_reader_close(ix->reader);
+    if (ix->file) fclose(ix->file);
+    free(ix->blocks);
+    free(ix->pids);
+    free(ix->max_last);
+    free(ix->min_first);
+    free(ix);
+}
+
+unsigned trace_index_block_count(const trace_index_t *ix) {
+    return ix ? ix->hdr.nblocks : 0;
+}
+
+int trace_index_first_time(const trace_index_t *ix) {
+    return (ix && ix->hdr.nblocks) ? ix->min_first[0] : 0;
+}
+
+int trace_index_last_time(const trace_index_t *ix) {
+    return (ix && ix->hdr.nblocks) ? ix->max_last[ix->hdr.nblocks - 1] : 0;
+}
+
+/* ===================================================================== */
+/* REQUÊTES                                                              */
+/* ===================================================================== */
+
+static const trace_idx_pid_t *find_pid(const trace_index_t *ix, int pid) {
+    uint32_t lo = 0, hi = ix->hdr.npids;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (ix->pids[mid].pid < pid) lo = mid + 1;
+        else                         hi = mid;
+    }
+    return (lo < ix->hdr.npids && ix->pids[lo].pid == pid) ? &ix->pids[lo] : NULL;
+}
+
+trace_query_t *trace_query_open(trace_index_t *ix, int from, int to, int pid) {
+    if (!ix) return NULL;
+    trace_query_close(ix->query);
+
+    trace_query_t *q = calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    q->ix   = ix;
+    q->from = from;
+    q->to   = to;
+    q->pid  = pid;
+
+    /* Premier bloc qui peut contenir un temps >= from */
+    uint32_t lo = 0, hi = ix->hdr.nblocks;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (ix->max_last[mid] < from) lo = mid + 1;
+        else                          hi = mid;
+    }
+    q->start  = lo;
+    q->cursor = lo;
+
+    if (pid != TRACE_QUERY_ALL_PIDS) {
+        const trace_idx_pid_t *d = find_pid(ix, pid);
+        q->cursor = 0;
+        if (d) {
+            q->list = malloc(d->nblocks * sizeof(uint32_t));
+            if (!q->list ||
+                fseek(ix->file, (long)d->postings, SEEK_SET) != 0 ||
+                fread(q->list, sizeof(uint32_t), d->nblocks, ix->file) != d->nblocks) {
+                free(q->list);
+                free(q);
+                return NULL;
+            }
+            q->nlist = d->nblocks;
+        }
+    }
+
+    ix->query = q;
+    return q;
+}
+
+/* Bloc suivant à lire ; -1 quand plus aucun ne peut recouper [from, to] */
+static long next_block(trace_query_t *q) {
+    const trace_index_t *ix = q->ix;
+
+    for (;;) {
+        uint32_t b;
+        if (q->pid != TRACE_QUERY_ALL_PIDS) {
+            if (q->cursor >= q->nlist) return -1;
+            b = q->list[q->cursor++];
+            if (b < q->start) continue;
+        } else {
+            if (q->cursor >= ix->hdr.nblocks) return -1;
+            b = q->cursor++;
+        }
+
+        if (ix->min_first[b] > q->to) return -1;
+        if (ix->blocks[b].first_time <= q->to && ix->blocks[b].last_time >= q->from)
+            return b;
+    }
+}
+
+int trace_query_next(trace_query_t *q, trace_entry_t *out) {
+    if (!q || q->from > q->to) return 0;
+
+    for (;;) {
+        while (q->remaining > 0) {
+            int rc = trace_reader_next(q->ix->reader, out);
+            if (rc <= 0) return -1;   // l'index annonçait plus d'événements
+            q->remaining--;
+
+            if (out->time < q->from || out->time > q->to) continue;
+            if (q->pid != TRACE_QUERY_ALL_PIDS && out->pid != q->pid) continue;
+            return 1;
+        }
+
+        long b = next_block(q);
+        if (b < 0) return 0;
+        if (trace_reader_seek_pos(q->ix->reader, (long)q->ix->blocks[b].offset) != 0) return -1;
+        q->remaining = q->ix->blocks[b].count;
+        q->blocks_read++;
+    }
+}
+
+unsigned trace_query_blocks_read(const trace_query_t *q) {
+    return q ? q->blocks_read : 0;
+}
+
+void trace_query_close(trace_query_t *q) {
+    if (!q) return;
+    if (q->ix->query == q) q->ix->query = NULL;
+    free(q->list);
+    free(q);
+}
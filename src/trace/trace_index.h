@@ -0,0 +1,52 @@
+#ifndef MINIOS_TRACE_INDEX_H
+#define MINIOS_TRACE_INDEX_H
+
+#include "trace_reader.h"
+
+/*
+ * Index d'une trace (.csv / .mtrace / .ctrace) : blocs d'événements
+ * repérés par leur intervalle de temps + liste des blocs de chaque PID
+ * (format dans trace_format.h). Une requête ne lit que les blocs qui
+ * recoupent la tranche demandée.
+ */
+
+typedef struct trace_index trace_index_t;
+typedef struct trace_query trace_query_t;
+
+/**
+ * Construit l'index de trace_path en un passage. index_path NULL =
+ * "<trace_path>.idx". 0, ou -1 (message sur stderr).
+ */
+int trace_index_build(const char *trace_path, const char *index_path);
+
+/**
+ * Ouvre la trace et son index "<trace_path>.idx" ; l'index est (re)construit
+ * s'il manque ou ne correspond plus à la trace. NULL si erreur.
+ */
+trace_index_t *trace_index_open(const char *trace_path);
+
+void trace_index_close(trace_index_t *ix);
+
+/** Nombre de blocs de l'index / bornes de temps de la trace. */
+unsigned trace_index_block_count(const trace_index_t *ix);
+int      trace_index_first_time(const trace_index_t *ix);
+int      trace_index_last_time(const trace_index_t *ix);
+
+#define TRACE_QUERY_ALL_PIDS  (-2)   // (-1 est le PID des événements système)
+
+/**
+ * Événements de temps dans [from, to] (bornes incluses), d'un seul PID ou
+ * de tous (TRACE_QUERY_ALL_PIDS). Une seule requête ouverte à la fois par
+ * index : en ouvrir une nouvelle ferme la précédente.
+ */
+trace_query_t *trace_query_open(trace_index_t *ix, int from, int to, int pid);
+
+/** 1 si out est rempli, 0 à la fin, -1 si la trace est illisible. */
+int trace_query_next(trace_query_t *q, trace_entry_t *out);
+
+/** Blocs lus par la requête (pour mesurer la sélectivité). */
+unsigned trace_query_blocks_read(const trace_query_t *q);
+
+void trace_query_close(trace_query_t *q);
+
+#endif // MINIOS_TRACE_INDEX_H
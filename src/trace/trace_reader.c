@@ -0,0 +1,386 @@
+#include "trace_reader.h"
+#include "trace_format.h"
+#include "trace_compact.h"
+#include "trace_chrome.h"
+#include "logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define NAMES_PER_DOMAIN 256   // codes sur 8 bits
+
+struct trace_reader {
+    FILE  *file;
+    int    schema_version;
+    long   data_start;                                    // 1er enregistrement / bloc
+    int    compact;                                       // format .ctrace
+    int    csv;                                           // CSV texte (schéma compilé)
+    int    has_peek;                                      // enregistrement déjà lu (seek CSV)
+    trace_rec_t peek;
+    char   line[256];
+    unsigned         cz_flags;
+    trace_cz_block_t blk;                                 // bloc compact en cours
+    char  *names[TRACE_DOMAIN_COUNT][NAMES_PER_DOMAIN];   // NULL = inconnu
+    char   number[24];                                    // reason numérique formatée
+};
+
+static int read_table(trace_reader_t *r, uint32_t bytes) {
+    unsigned char *table = malloc(bytes ? bytes : 1);
+    if (!table) return -1;
+    if (bytes && fread(table, 1, bytes, r->file) != bytes) {
+        free(table);
+        return -1;
+    }
+
+    uint32_t pos = 0;
+    while (pos + 3 <= bytes) {
+        unsigned dom  = table[pos];
+        unsigned code = table[pos + 1];
+        unsigned len  = table[pos + 2];
+        pos += 3;
+        if (dom >= TRACE_DOMAIN_COUNT || pos + len > bytes) break;
+
+        free(r->names[dom][code]);
+        r->names[dom][code] = malloc(len + 1);
+        if (!r->names[dom][code]) break;
+        memcpy(r->names[dom][code], table + pos, len);
+        r->names[dom][code][len] = '\0';
+        pos += len;
+    }
+    free(table);
+    return pos == bytes ? 0 : -1;
+}
+
+/* CSV : pas de table dans le fichier, les libellés sont ceux du schéma
+ * compilé (le CSV n'est lisible qu'avec le schéma qui l'a produit). */
+static int schema_table(trace_reader_t *r) {
+    const char *(*const name_of[TRACE_DOMAIN_COUNT])(unsigned) = {
+        trace_ev_name, trace_state_name, trace_reason_name, trace_queue_name,
+    };
+    const unsigned count[TRACE_DOMAIN_COUNT] = { EV_COUNT, ST_COUNT, RS_COUNT, Q_COUNT };
+
+    for (int d = 0; d < TRACE_DOMAIN_COUNT; ++d) {
+        for (unsigned c = 0; c < count[d]; ++c) {
+            r->names[d][c] = strdup(name_of[d](c));
+            if (!r->names[d][c]) return -1;
+        }
+    }
+    return 0;
+}
+
+static trace_reader_t *open_csv(const char *path, FILE *f) {
+    trace_reader_t *r = calloc(1, sizeof(*r));
+    if (!r) {
+        fclose(f);
+        return NULL;
+    }
+    r->file           = f;
+    r->schema_version = TRACE_SCHEMA_VERSION;
+    r->csv            = 1;
+    setvbuf(f, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+    if (schema_table(r) != 0) {
+        trace_reader_close(r);
+        return NULL;
+    }
+    rewind(f);
+    if (!fgets(r->line, sizeof(r->line), f) ||
+        strncmp(r->line, "time,pid,event,state,reason,cpu,queue", 37) != 0) {
+        fprintf(stderr, "%s : pas une trace miniOS\n", path);
+        trace_reader_close(r);
+        return NULL;
+    }
+    r->data_start = ftell(f);
+    return r;
+}
+
+trace_reader_t *trace_reader_open(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+
+    /* Les deux formats ont un en-tête de 16 octets, reconnu à sa signature */
+    union {
+        trace_bin_header_t bin;
+        trace_cz_header_t  cz;
+    } h;
+    if (fread(&h, sizeof(h), 1, f) != 1 ||
+        (memcmp(h.bin.magic, TRACE_BIN_MAGIC, 4) != 0 &&
+         memcmp(h.bin.magic, TRACE_CZ_MAGIC, 4) != 0)) {
+        return open_csv(path, f);   // sinon : CSV (en-tête vérifié)
+    }
+
+    int      compact = memcmp(h.bin.magic, TRACE_CZ_MAGIC, 4) == 0;
+    uint32_t table_bytes;
+    int      schema;
+
+    if (compact) {
+        if (h.cz.endian_tag != TRACE_BIN_ENDIAN_TAG || h.cz.version != TRACE_CZ_VERSION) {
+            fprintf(stderr, "%s : trace compacte version %u non supportée\n",
+                    path, (unsigned)h.cz.version);
+            fclose(f);
+            return NULL;
+        }
+        table_bytes = h.cz.table_bytes;
+        schema      = h.cz.schema_version;
+    } else {
+        if (h.bin.endian_tag != TRACE_BIN_ENDIAN_TAG ||
+            h.bin.version != TRACE_BIN_VERSION ||
+            h.bin.record_size != TRACE_BIN_RECORD_SIZE) {
+            fprintf(stderr, "%s : version %u / enregistrements de %u octets non supportés\n",
+                    path, (unsigned)h.bin.version, (unsigned)h.bin.record_size);
+            fclose(f);
+            return NULL;
+        }
+        table_bytes = h.bin.table_bytes;
+        schema      = h.bin.schema_version;
+    }
+
+    trace_reader_t *r = calloc(1, sizeof(*r));
+    if (!r) {
+        fclose(f);
+        return NULL;
+    }
+    r->file           = f;
+    r->schema_version = schema;
+    r->compact        = compact;
+    r->cz_flags       = compact ? h.cz.flags : 0;
+    setvbuf(f, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+    if (read_table(r, table_bytes) != 0) {
+        fprintf(stderr, "%s : table des libellés illisible\n", path);
+        trace_reader_close(r);
+        return NULL;
+    }
+    r->data_start = ftell(f);
+    return r;
+}
+
+int trace_reader_schema_version(const trace_reader_t *r) {
+    return r ? r->schema_version : 0;
+}
+
+static const char *lookup(trace_reader_t *r, unsigned dom, unsigned code) {
+    const char *s = r->names[dom][code & (NAMES_PER_DOMAIN - 1)];
+    return s ? s : "";
+}
+
+/* Code d'un libellé du schéma ; -1 si inconnu */
+static int code_of(trace_reader_t *r, unsigned dom, const char *name) {
+    for (int c = 0; c < NAMES_PER_DOMAIN; ++c) {
+        if (r->names[dom][c] && strcmp(r->names[dom][c], name) == 0) return c;
+    }
+    return -1;
+}
+
+/* Ligne CSV suivante -> enregistrement (reason numérique = RS_VALUE + arg) */
+static int next_csv(trace_reader_t *r, trace_rec_t *rec) {
+    if (!fgets(r->line, sizeof(r->line), r->file)) return ferror(r->file) ? -1 : 0;
+    r->line[strcspn(r->line, "\r\n")] = '\0';
+
+    char *field[7];
+    char *p = r->line;
+    for (int i = 0; i < 7; ++i) {
+        field[i] = p;
+        p = strchr(p, ',');
+        if (!p && i < 6) return -1;   // colonnes manquantes
+        if (p) *p++ = '\0';
+    }
+
+    int ev = code_of(r, TRACE_DOMAIN_EVENT, field[2]);
+    int st = code_of(r, TRACE_DOMAIN_STATE, field[3]);
+    int q  = code_of(r, TRACE_DOMAIN_QUEUE, field[6]);
+    if (ev < 0 || st < 0 || q < 0) return -1;
+
+    char   *end;
+    int64_t value = strtoll(field[4], &end, 10);
+    int     rs;
+    if (field[4][0] != '\0' && *end == '\0') {
+        rs = RS_VALUE;
+    } else {
+        rs    = code_of(r, TRACE_DOMAIN_REASON, field[4]);
+        value = 0;
+        if (rs < 0) return -1;
+    }
+
+    memset(rec, 0, sizeof(*rec));
+    rec->time   = (int32_t)strtol(field[0], NULL, 10);
+    rec->pid    = (int32_t)strtol(field[1], NULL, 10);
+    rec->cpu    = (int16_t)strtol(field[5], NULL, 10);
+    rec->event  = (uint8_t)ev;
+    rec->state  = (uint8_t)st;
+    rec->reason = (uint8_t)rs;
+    rec->queue  = (uint8_t)q;
+    rec->arg    = value;
+    return 1;
+}
+
+/* Enregistrement suivant d'une trace compacte, bloc après bloc */
+static int next_compact(trace_reader_t *r, trace_rec_t *rec) {
+    for (;;) {
+        int rc = trace_cz_block_next(&r->blk, rec);
+        if (rc != 0) return rc;
+
+        rc = trace_cz_read_block(r->file, r->cz_flags, &r->blk);
+        if (rc <= 0) return rc;
+    }
+}
+
+int trace_reader_next(trace_reader_t *r, trace_entry_t *out) {
+    if (r->has_peek) {
+        out->rec    = r->peek;
+        r->has_peek = 0;
+    } else if (r->csv) {
+        int rc = next_csv(r, &out->rec);
+        if (rc <= 0) return rc;
+    } else if (r->compact) {
+        int rc = next_compact(r, &out->rec);
+        if (rc <= 0) return rc;
+    } else {
+        size_t n = fread(&out->rec, 1, sizeof(out->rec), r->file);
+        if (n == 0) return 0;
+        if (n != sizeof(out->rec)) return -1;   // enregistrement tronqué
+    }
+
+    const trace_rec_t *rec = &out->rec;
+
+    out->time  = rec->time;
+    out->pid   = rec->pid;
+    out->cpu   = rec->cpu;
+    out->event = lookup(r, TRACE_DOMAIN_EVENT, rec->event);
+    out->state = lookup(r, TRACE_DOMAIN_STATE, rec->state);
+    out->queue = lookup(r, TRACE_DOMAIN_QUEUE, rec->queue);
+
+    if (rec->reason == RS_VALUE) {
+        snprintf(r->number, sizeof(r->number), "%" PRId64, rec->arg);
+        out->reason = r->number;
+    } else {
+        out->reason = lookup(r, TRACE_DOMAIN_REASON, rec->reason);
+    }
+    return 1;
+}
+
+int trace_reader_seek_time(trace_reader_t *r, int time) {
+    if (!r) return -1;
+
+    if (r->csv) {
+        /* Pas d'index : lecture jusqu'au premier événement >= time, gardé
+         * pour le prochain trace_reader_next */
+        if (r->has_peek && r->peek.time >= time) return 0;
+        int rc;
+        while ((rc = next_csv(r, &r->peek)) == 1) {
+            if (r->peek.time >= time) {
+                r->has_peek = 1;
+                return 0;
+            }
+        }
+        r->has_peek = 0;
+        return rc < 0 ? -1 : 0;
+    }
+
+    if (r->compact) {
+        /* Bloc en cours déjà dépassé : on l'abandonne */
+        if (r->blk.decoded < r->blk.hdr.count && r->blk.hdr.last_time < time) {
+            r->blk.decoded = r->blk.hdr.count;
+        }
+        if (r->blk.decoded < r->blk.hdr.count) return 0;
+
+        int rc;
+        while ((rc = trace_cz_skip_block_before(r->file, time)) == 1) {}
+        return rc < 0 ? -1 : 0;
+    }
+
+    /* Enregistrements fixes, temps croissants : recherche dichotomique */
+    if (fseek(r->file, 0, SEEK_END) != 0) return -1;
+    long lo = 0;
+    long hi = (ftell(r->file) - r->data_start) / TRACE_BIN_RECORD_SIZE;
+    while (lo < hi) {
+        long        mid = lo + (hi - lo) / 2;
+        trace_rec_t rec;
+        if (fseek(r->file, r->data_start + mid * TRACE_BIN_RECORD_SIZE, SEEK_SET) != 0 ||
+            fread(&rec, sizeof(rec), 1, r->file) != 1) {
+            return -1;
+        }
+        if (rec.time < time) lo = mid + 1;
+        else                 hi = mid;
+    }
+    return fseek(r->file, r->data_start + lo * TRACE_BIN_RECORD_SIZE, SEEK_SET) == 0 ? 0 : -1;
+}
+
+long trace_reader_tell(trace_reader_t *r) {
+    if (!r || r->has_peek) return -1;
+    if (r->compact && r->blk.decoded < r->blk.hdr.count) return -1;
+    return ftell(r->file);
+}
+
+int trace_reader_seek_pos(trace_reader_t *r, long pos) {
+    if (!r || pos < r->data_start) return -1;
+    r->has_peek    = 0;
+    r->blk.decoded = r->blk.hdr.count;   // bloc compact en cours abandonné
+    return fseek(r->file, pos, SEEK_SET) == 0 ? 0 : -1;
+}
+
+void trace_reader_close(trace_reader_t *r) {
+    if (!r) return;
+    trace_cz_block_free(&r->blk);
+    for (int d = 0; d < TRACE_DOMAIN_COUNT; ++d) {
+        for (int c = 0; c < NAMES_PER_DOMAIN; ++c) {
+            free(r->names[d][c]);
+        }
+    }
+    fclose(r->file);
+    free(r);
+}
+
+long trace_convert_to_csv(const char *bin_path, FILE *csv) {
+    trace_reader_t *r = trace_reader_open(bin_path);
+    if (!r) return -1;
+
+    fprintf(csv, "time,pid,event,state,reason,cpu,queue\n");
+
+    trace_entry_t e;
+    long count = 0;
+    int  rc;
+    while ((rc = trace_reader_next(r, &e)) == 1) {
+        fprintf(csv, "%d,%d,%s,%s,%s,%d,%s\n",
+                e.time, e.pid, e.event, e.state, e.reason, e.cpu, e.queue);
+        count++;
+    }
+    trace_reader_close(r);
+
+    if (rc < 0) {
+        fprintf(stderr, "%s : trace tronquée après %ld événements\n", bin_path, count);
+        return -1;
+    }
+    return count;
+}
+
+long trace_convert_to_chrome(const char *bin_path, FILE *json) {
+    trace_reader_t *r = trace_reader_open(bin_path);
+    if (!r) return -1;
+
+    trace_chrome_writer_t *w = trace_chrome_writer_open(json);
+    if (!w) {
+        trace_reader_close(r);
+        return -1;
+    }
+
+    trace_entry_t e;
+    long count = 0;
+    int  rc;
+    while ((rc = trace_reader_next(r, &e)) == 1) {
+        trace_chrome_writer_put(w, &e.rec);
+        count++;
+    }
+    trace_chrome_writer_close(w);   // JSON valide même si la trace est tronquée
+    trace_reader_close(r);
+
+    if (rc < 0) {
+        fprintf(stderr, "%s : trace tronquée après %ld événements\n", bin_path, count);
+        return -1;
+    }
+    return count;
+}
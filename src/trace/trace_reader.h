@@ -0,0 +1,81 @@
+#ifndef MINIOS_TRACE_READER_H
+#define MINIOS_TRACE_READER_H
+
+#include <stdio.h>
+#include "trace_event_types.h"
+
+/*
+ * Lecture séquentielle d'une trace : enregistrements fixes (.mtrace) ou
+ * blocs compacts (.ctrace), reconnus à l'en-tête (cf. trace_format.h), ou
+ * CSV à défaut.
+ * Les libellés des traces binaires viennent de la table du fichier (et non
+ * du schéma compilé) : une trace produite par un miniOS plus récent reste
+ * lisible. Le CSV est relu avec le schéma compilé.
+ */
+
+typedef struct trace_reader trace_reader_t;
+
+/* Un événement décodé : l'enregistrement brut + ses libellés. Les chaînes
+ * appartiennent au lecteur et restent valides jusqu'au prochain
+ * trace_reader_next (reason) ou jusqu'à trace_reader_close (les autres). */
+typedef struct trace_entry {
+    trace_rec_t rec;
+    int         time;
+    int         pid;
+    int         cpu;
+    const char *event;
+    const char *state;
+    const char *reason;
+    const char *queue;
+} trace_entry_t;
+
+/**
+ * Ouvre une trace (binaire ou CSV). NULL (message sur stderr) si le fichier
+ * est absent ou n'est pas une trace miniOS lisible sur cet hôte.
+ */
+trace_reader_t *trace_reader_open(const char *path);
+
+/** TRACE_SCHEMA_VERSION de l'émetteur de la trace ouverte. */
+int trace_reader_schema_version(const trace_reader_t *r);
+
+/**
+ * Lit l'événement suivant : 1 si out est rempli, 0 en fin de fichier,
+ * -1 si le fichier est tronqué ou incohérent.
+ */
+int trace_reader_next(trace_reader_t *r, trace_entry_t *out);
+
+/**
+ * Avance jusqu'aux événements de temps >= time (traces à temps croissants).
+ * Exact pour .mtrace et CSV (lecture linéaire) ; pour .ctrace, saute les
+ * blocs entièrement antérieurs (granularité d'un point de synchronisation).
+ * 0, ou -1 si erreur.
+ */
+int trace_reader_seek_time(trace_reader_t *r, int time);
+
+/**
+ * Point de reprise : position du prochain événement, à repasser à
+ * trace_reader_seek_pos. -1 si la lecture n'est pas à un point de
+ * synchronisation (.ctrace au milieu d'un bloc).
+ */
+long trace_reader_tell(trace_reader_t *r);
+
+/** Reprend la lecture à une position rendue par trace_reader_tell. 0 / -1. */
+int trace_reader_seek_pos(trace_reader_t *r, long pos);
+
+void trace_reader_close(trace_reader_t *r);
+
+/**
+ * Écrit une trace binaire (.mtrace ou .ctrace) au format CSV habituel
+ * (time,pid,event,state,reason,cpu,queue).
+ * Retourne le nombre d'événements convertis, ou -1 en cas d'erreur.
+ */
+long trace_convert_to_csv(const char *bin_path, FILE *csv);
+
+/**
+ * Écrit une trace (binaire ou CSV) au format JSON Chrome Trace Event (cf.
+ * trace_chrome.h), pour Perfetto / chrome://tracing.
+ * Retourne le nombre d'événements convertis, ou -1 en cas d'erreur.
+ */
+long trace_convert_to_chrome(const char *bin_path, FILE *json);
+
+#endif // MINIOS_TRACE_READER_H
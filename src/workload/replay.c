@@ -0,0 +1,245 @@
+#include "replay.h"
+#include "../trace/trace_reader.h"
+#include "../io/io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Reconstruction d'un processus de la trace */
+typedef struct replay_proc {
+    bool     seen;
+    bool     done;
+    bool     arrived;      // arrivée vue (premier événement après CREATE)
+    int      pid;          // PID d'origine (départage à arrivée égale)
+    int      arrival;
+    size_t   mem_size;
+    int      run_since;    // début de la tranche RUNNING ouverte (-1 = aucune)
+    int      io_since;     // début de l'I/O en cours (-1 = aucune)
+    int      io_device;    // périphérique de l'I/O en cours
+    int      cpu_acc;      // CPU de la rafale en cours
+    burst_t *bursts;
+    int      nbursts;
+    int      cap;
+} replay_proc_t;
+
+typedef struct replay_ctx {
+    replay_proc_t  *procs;       // indexés par PID, puis triés par arrivée
+    int             nprocs;
+    int             cursor;
+    ProcessPriority prio;
+    workload_source_t src;
+} replay_ctx_t;
+
+static bool push_burst(replay_proc_t *p, int kind, int arg, int duration) {
+    if (duration <= 0) return true;
+
+    if (p->nbursts == p->cap) {
+        int      n = p->cap ? p->cap * 2 : 8;
+        burst_t *t = realloc(p->bursts, (size_t)n * sizeof(*t));
+        if (!t) return false;
+        p->bursts = t;
+        p->cap    = n;
+    }
+    p->bursts[p->nbursts++] = (burst_t){ .kind = kind, .arg = arg, .duration = duration };
+    return true;
+}
+
+static bool flush_cpu(replay_proc_t *p) {
+    int d = p->cpu_acc;
+    p->cpu_acc = 0;
+    return push_burst(p, BURST_CPU, 0, d);
+}
+
+static replay_proc_t *proc_get(replay_ctx_t *c, int pid) {
+    if (pid >= c->nprocs) {
+        int n = c->nprocs ? c->nprocs : 64;
+        while (n <= pid) n *= 2;
+        replay_proc_t *t = realloc(c->procs, (size_t)n * sizeof(*t));
+        if (!t) return NULL;
+        memset(t + c->nprocs, 0, (size_t)(n - c->nprocs) * sizeof(*t));
+        for (int i = c->nprocs; i < n; ++i) {
+            t[i].pid       = i;
+            t[i].run_since = -1;
+            t[i].io_since  = -1;
+        }
+        c->procs  = t;
+        c->nprocs = n;
+    }
+    return &c->procs[pid];
+}
+
+/* Ferme les tranches ouvertes à time (avant un changement d'état) */
+static bool close_spans(replay_proc_t *p, int time) {
+    if (p->run_since >= 0) {
+        p->cpu_acc  += time - p->run_since;
+        p->run_since = -1;
+    }
+    if (p->io_since >= 0) {
+        int d = time - p->io_since;
+        p->io_since = -1;
+        return push_burst(p, BURST_IO, p->io_device, d);
+    }
+    return true;
+}
+
+static bool finish(replay_proc_t *p, int time) {
+    bool ok = close_spans(p, time) && flush_cpu(p);
+    p->done = true;
+    return ok;
+}
+
+/* Zone principale pas encore attribuée : ALLOC anonyme (traces anciennes,
+ * juste avant le CREATE du même tick) */
+typedef struct pending_alloc {
+    int    time;
+    size_t size;
+} pending_alloc_t;
+
+static bool put(replay_ctx_t *c, const trace_rec_t *r, pending_alloc_t *anon) {
+    if (r->event == EV_MEMORY) {
+        if (r->state != ST_ALLOC) return true;
+        if (r->pid < 0) {
+            anon->time = r->time;
+            anon->size = (size_t)r->arg;
+            return true;
+        }
+        replay_proc_t *p = proc_get(c, r->pid);
+        if (!p) return false;
+        if (p->mem_size == 0 && !p->done) p->mem_size = (size_t)r->arg;
+        return true;
+    }
+    if (r->pid < 0) return true;
+
+    replay_proc_t *p = proc_get(c, r->pid);
+    if (!p) return false;
+    if (p->done) return true;
+
+    if (!p->seen) {
+        p->seen    = true;
+        p->arrival = r->time;
+        if (p->mem_size == 0 && anon->size > 0 && anon->time == r->time) {
+            p->mem_size = anon->size;
+        }
+        anon->size = 0;
+    }
+    // Admission (READY, attente mémoire ou rejet) = arrivée
+    if (!p->arrived && r->event != EV_CREATE) {
+        p->arrived = true;
+        p->arrival = r->time;
+    }
+
+    if (r->state == ST_TERMINATED || r->event == EV_OOM_KILL ||
+        r->event == EV_CREATE_FAIL_OOM) {
+        return finish(p, r->time);
+    }
+    if (!close_spans(p, r->time)) return false;
+
+    if (r->state == ST_RUNNING) {
+        p->run_since = r->time;
+    } else if (r->state == ST_BLOCKED && r->reason == RS_IO) {
+        // Début du service ; file Q_IO_* = périphérique (traces anciennes : disque)
+        if (!flush_cpu(p)) return false;
+        p->io_since  = r->time;
+        p->io_device = (r->queue >= Q_IO_FIRST && r->queue < Q_IO_FIRST + IO_DEVICE_COUNT)
+                     ? (int)(r->queue - Q_IO_FIRST) : IO_DEVICE_DISK;
+    } else if (r->state == ST_BLOCKED && r->reason == RS_IO_QUEUE) {
+        // Attente d'un canal libre : due à la contention, pas à la charge
+        if (!flush_cpu(p)) return false;
+    }
+    return true;
+}
+
+static int by_arrival(const void *a, const void *b) {
+    const replay_proc_t *x = a, *y = b;
+    if (x->arrival != y->arrival) return (x->arrival < y->arrival) ? -1 : 1;
+    return (x->pid < y->pid) ? -1 : (x->pid > y->pid);
+}
+
+static int replay_next(workload_source_t *src, workload_spec_t *out) {
+    replay_ctx_t *c = src->ctx;
+    if (c->cursor >= c->nprocs) return 0;
+
+    replay_proc_t *p = &c->procs[c->cursor++];
+    out->arrival     = p->arrival;
+    out->priority    = c->prio;
+    out->mem_size    = p->mem_size;
+    out->bursts      = p->bursts;
+    out->burst_count = p->nbursts;
+    return 1;
+}
+
+static void replay_close(workload_source_t *src) {
+    replay_ctx_t *c = src->ctx;
+    for (int i = 0; i < c->nprocs; ++i) free(c->procs[i].bursts);
+    free(c->procs);
+    free(c);
+}
+
+/* ===================================================================== */
+/* API                                                                   */
+/* ===================================================================== */
+
+workload_source_t *workload_replay_open(const char *trace_path, ProcessPriority prio) {
+    trace_reader_t *rd = trace_reader_open(trace_path);
+    if (!rd) return NULL;
+
+    replay_ctx_t *c = calloc(1, sizeof(*c));
+    if (!c) {
+        trace_reader_close(rd);
+        return NULL;
+    }
+    c->prio = prio;
+
+    pending_alloc_t anon = { 0, 0 };
+    trace_entry_t   e;
+    int             r = 0, last = 0;
+    bool            ok = true;
+
+    while (ok && (r = trace_reader_next(rd, &e)) == 1) {
+        last = e.rec.time;
+        ok   = put(c, &e.rec, &anon);
+    }
+    trace_reader_close(rd);
+
+    if (!ok || r < 0) {
+        fprintf(stderr, "replay: %s : %s\n", trace_path,
+                ok ? "trace illisible" : "plus de memoire");
+        workload_source_t tmp = { .ctx = c };
+        replay_close(&tmp);
+        return NULL;
+    }
+
+    /* Processus encore vivants en fin de trace ; tassement des PID vus */
+    int n = 0;
+    for (int i = 0; i < c->nprocs; ++i) {
+        replay_proc_t *p = &c->procs[i];
+        if (!p->seen) {
+            free(p->bursts);
+            continue;
+        }
+        if (!p->done) ok = finish(p, last) && ok;
+        bool ran = false;
+        for (int k = 0; k < p->nbursts; ++k) ran = ran || p->bursts[k].kind == BURST_CPU;
+        if (!ran) {
+            p->nbursts = 0;
+            ok = push_burst(p, BURST_CPU, 0, 1) && ok;   // rejet mémoire : jamais élu
+        }
+        c->procs[n++] = *p;
+    }
+    c->nprocs = n;
+    qsort(c->procs, (size_t)n, sizeof(*c->procs), by_arrival);
+
+    if (!ok) {
+        fprintf(stderr, "replay: %s : plus de memoire\n", trace_path);
+        workload_source_t tmp = { .ctx = c };
+        replay_close(&tmp);
+        return NULL;
+    }
+
+    c->src.name  = "replay";
+    c->src.next  = replay_next;
+    c->src.close = replay_close;
+    c->src.ctx   = c;
+    return &c->src;
+}
@@ -0,0 +1,30 @@
+#ifndef MINIOS_REPLAY_H
+#define MINIOS_REPLAY_H
+
+#include "workload.h"
+
+/*
+ * Rejeu d'une trace (.csv / .mtrace / .ctrace) comme charge : pour chaque
+ * PID on reconstruit l'arrivée (premier événement après CREATE : le
+ * scénario interactif crée tous les PCB à t=0), la taille mémoire (premier
+ * ALLOC), et la suite de rafales CPU (durées RUNNING) / I/O (BLOCKED raison io).
+ * Les attentes dues à l'ordonnancement (timer, quantum, mutex, sémaphore,
+ * mémoire, file d'un périphérique occupé) ne font pas partie de la charge
+ * et sont ignorées : la trace peut ainsi être rejouée sous une autre
+ * politique ou avec d'autres nombres de canaux.
+ *
+ * Le périphérique d'une I/O est lu dans la file de l'événement (Q_IO_*) ;
+ * les traces qui ne le donnent pas (file BLOCKED) sont rejouées sur
+ * IO_DEVICE_DISK. Les I/O asynchrones (SUBMIT) ne changent pas l'état du
+ * processus et n'apparaissent donc pas : seuls leurs WAIT (aio_wait) sont
+ * vus, et ignorés comme les autres attentes. Un processus qui n'a jamais
+ * tourné (rejet mémoire) est rejoué avec une rafale CPU d'un tick.
+ */
+
+/**
+ * Lit toute la trace et prépare les descriptions (priorité commune prio,
+ * la trace ne la contenant pas). NULL (message sur stderr) si erreur.
+ */
+workload_source_t *workload_replay_open(const char *trace_path, ProcessPriority prio);
+
+#endif // MINIOS_REPLAY_H
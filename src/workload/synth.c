@@ -0,0 +1,246 @@
+#include "synth.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define SYNTH_TWO_PI 6.283185307179586
+
+typedef struct synth_ctx {
+    workload_synth_config_t cfg;
+    uint64_t          rng;
+    long              generated;
+    double            clock;       // instant de la dernière arrivée (ticks, réel)
+    bool              on;          // BURSTY : dans une rafale
+    double            phase_end;   // BURSTY : fin de la période courante
+    burst_t          *prog;        // 2 * io_phases + 1 étapes
+    workload_source_t src;
+} synth_ctx_t;
+
+/* ===================================================================== */
+/* GÉNÉRATEUR PSEUDO-ALÉATOIRE (xorshift64*, comme les benchs)           */
+/* ===================================================================== */
+
+static uint64_t rng_next(synth_ctx_t *c) {
+    c->rng ^= c->rng >> 12;
+    c->rng ^= c->rng << 25;
+    c->rng ^= c->rng >> 27;
+    return c->rng * 0x2545F4914F6CDD1Dull;
+}
+
+/* Uniforme dans [0, 1). */
+static double rng_unit(synth_ctx_t *c) {
+    return (double)(rng_next(c) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double rng_exp(synth_ctx_t *c, double mean) {
+    return -mean * log(1.0 - rng_unit(c));
+}
+
+/* Normale centrée réduite (Box-Muller) */
+static double rng_normal(synth_ctx_t *c) {
+    double u = 1.0 - rng_unit(c);   // ]0, 1]
+    double v = rng_unit(c);
+    return sqrt(-2.0 * log(u)) * cos(SYNTH_TWO_PI * v);
+}
+
+static double sample(synth_ctx_t *c, const synth_dist_t *d) {
+    double x;
+    switch (d->kind) {
+        case SYNTH_DIST_EXPONENTIAL: x = rng_exp(c, d->a);                             break;
+        case SYNTH_DIST_PARETO:      x = d->b / pow(1.0 - rng_unit(c), 1.0 / d->a);    break;
+        case SYNTH_DIST_LOGNORMAL:   x = exp(d->a + d->b * rng_normal(c));             break;
+        case SYNTH_DIST_FIXED:
+        default:                     x = d->a;                                          break;
+    }
+    if (d->max > 0 && x > d->max) x = d->max;
+    return x;
+}
+
+/* Entier >= 1 (durées en ticks) */
+static int sample_ticks(synth_ctx_t *c, const synth_dist_t *d) {
+    double x = ceil(sample(c, d));
+    return x < 1.0 ? 1 : (x > 1e9 ? 1000000000 : (int)x);
+}
+
+/* Indice tiré selon des poids (somme > 0), -1 si u tombe après les poids */
+static int pick(synth_ctx_t *c, const double *w, int n, double total) {
+    double u = rng_unit(c) * total;
+    for (int i = 0; i < n; ++i) {
+        if (u < w[i]) return i;
+        u -= w[i];
+    }
+    return -1;
+}
+
+/* ===================================================================== */
+/* ARRIVÉES                                                              */
+/* ===================================================================== */
+
+static double next_arrival(synth_ctx_t *c) {
+    const workload_synth_config_t *g = &c->cfg;
+
+    if (g->arrival == SYNTH_ARRIVAL_POISSON) {
+        c->clock += rng_exp(c, 1.0 / g->rate);
+        return c->clock;
+    }
+
+    /* On/off : processus sans mémoire, on peut retirer l'écart à chaque
+     * changement de période */
+    for (;;) {
+        double rate = c->on ? g->rate : g->idle_rate;
+        double t    = (rate > 0) ? c->clock + rng_exp(c, 1.0 / rate) : INFINITY;
+
+        if (t < c->phase_end) {
+            c->clock = t;
+            return t;
+        }
+        c->clock     = c->phase_end;
+        c->on        = !c->on;
+        c->phase_end = c->clock + rng_exp(c, c->on ? g->mean_on : g->mean_off);
+    }
+}
+
+/* ===================================================================== */
+/* SOURCE                                                                */
+/* ===================================================================== */
+
+static int synth_next(workload_source_t *src, workload_spec_t *out) {
+    synth_ctx_t                   *c = src->ctx;
+    const workload_synth_config_t *g = &c->cfg;
+
+    if (g->count > 0 && c->generated >= g->count) return 0;
+
+    double t = next_arrival(c);
+    if (t >= 2147483647.0 || (g->horizon > 0 && t > g->horizon)) return 0;
+    c->generated++;
+
+    /* Ordre des tirages fixe : la suite ne dépend que de la graine */
+    int    cpu  = sample_ticks(c, &g->cpu);
+    double mem  = sample(c, &g->mem);
+    int    prio = pick(c, g->prio_mix, 3, g->prio_mix[0] + g->prio_mix[1] + g->prio_mix[2]);
+    int    dev  = pick(c, g->io_mix, IO_DEVICE_COUNT, 1.0);
+
+    int n = 0;
+    if (dev >= 0 && cpu >= 2) {
+        int ios = 1 + (int)(rng_next(c) % (uint64_t)g->io_phases);
+        if (ios > cpu - 1) ios = cpu - 1;
+
+        /* CPU réparti en ios + 1 rafales, I/O entre chacune */
+        for (int k = 0; k <= ios; ++k) {
+            int share = cpu / (ios + 1) + (k < cpu % (ios + 1) ? 1 : 0);
+            c->prog[n++] = (burst_t){ .kind = BURST_CPU, .duration = share };
+            if (k < ios) c->prog[n++] = (burst_t){ .kind = BURST_IO, .arg = dev,
+                                                     .duration = sample_ticks(c, &g->io) };
+        }
+    } else {
+        c->prog[n++] = (burst_t){ .kind = BURST_CPU, .duration = cpu };
+    }
+
+    out->arrival     = (int)t;
+    out->priority    = (ProcessPriority)(prio < 0 ? PRIORITY_MEDIUM : prio);
+    out->mem_size    = mem > 0 ? (size_t)mem : 0;
+    out->bursts      = c->prog;
+    out->burst_count = n;
+    return 1;
+}
+
+static void synth_close(workload_source_t *src) {
+    synth_ctx_t *c = src->ctx;
+    free(c->prog);
+    free(c);
+}
+
+static bool dist_valid(const synth_dist_t *d) {
+    switch (d->kind) {
+        case SYNTH_DIST_FIXED:       return d->a >= 0;
+        case SYNTH_DIST_EXPONENTIAL: return d->a > 0;
+        case SYNTH_DIST_PARETO:      return d->a > 0 && d->b > 0;
+        case SYNTH_DIST_LOGNORMAL:   return d->b >= 0;
+        default:                     return false;
+    }
+}
+
+/* ===================================================================== */
+/* API                                                                   */
+/* ===================================================================== */
+
+void workload_synth_default_config(workload_synth_config_t *cfg) {
+    *cfg = (workload_synth_config_t){
+        .seed      = 42,
+        .count     = 1000,
+        .horizon   = 0,
+        .arrival   = SYNTH_ARRIVAL_POISSON,
+        .rate      = 0.2,
+        .idle_rate = 0.02,
+        .mean_on   = 50.0,
+        .mean_off  = 200.0,
+        .cpu       = { SYNTH_DIST_PARETO, 1.5, 2.0, 200.0 },
+        .io_phases = 4,
+        .io        = { SYNTH_DIST_LOGNORMAL, 1.5, 0.5, 50.0 },
+        .mem       = { SYNTH_DIST_LOGNORMAL, 13.8, 1.0, 16.0 * 1024 * 1024 },
+        .prio_mix  = { 0.25, 0.5, 0.25 },
+    };
+    cfg->io_mix[IO_DEVICE_DISK]     = 0.20;
+    cfg->io_mix[IO_DEVICE_NETWORK]  = 0.10;
+    cfg->io_mix[IO_DEVICE_KEYBOARD] = 0.05;
+}
+
+workload_source_t *workload_synth_open(const workload_synth_config_t *cfg) {
+    workload_synth_config_t def;
+    if (!cfg) {
+        workload_synth_default_config(&def);
+        cfg = &def;
+    }
+
+    double io_total = 0, prio_total = 0;
+    bool   mix_ok   = true;
+    for (int d = 0; d < IO_DEVICE_COUNT; ++d) {
+        mix_ok    = mix_ok && cfg->io_mix[d] >= 0;
+        io_total += cfg->io_mix[d];
+    }
+    for (int i = 0; i < 3; ++i) {
+        mix_ok      = mix_ok && cfg->prio_mix[i] >= 0;
+        prio_total += cfg->prio_mix[i];
+    }
+
+    const char *err = NULL;
+    if (cfg->count < 0 || cfg->horizon < 0)          err = "count / horizon negatifs";
+    else if (!(cfg->rate > 0))                       err = "rate doit etre > 0";
+    else if (cfg->arrival == SYNTH_ARRIVAL_BURSTY &&
+             (cfg->idle_rate < 0 || !(cfg->mean_on > 0) || !(cfg->mean_off > 0)))
+                                                     err = "parametres on/off invalides";
+    else if (cfg->arrival != SYNTH_ARRIVAL_POISSON &&
+             cfg->arrival != SYNTH_ARRIVAL_BURSTY)   err = "processus d'arrivee inconnu";
+    else if (!dist_valid(&cfg->cpu) || !dist_valid(&cfg->io) || !dist_valid(&cfg->mem))
+                                                     err = "distribution invalide";
+    else if (!mix_ok || io_total > 1.0 + 1e-9 || !(prio_total > 0))
+                                                     err = "melange io / priorites invalide";
+    else if (cfg->io_phases < 1)                     err = "io_phases doit etre >= 1";
+    else if (cfg->io_phases > SYNTH_MAX_IO_PHASES)   err = "io_phases trop grand pour un programme";
+    if (err) {
+        fprintf(stderr, "synth: %s\n", err);
+        return NULL;
+    }
+
+    synth_ctx_t *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->prog = malloc((size_t)(2 * cfg->io_phases + 1) * sizeof(burst_t));
+    if (!c->prog) {
+        free(c);
+        return NULL;
+    }
+
+    c->cfg = *cfg;
+    c->rng = cfg->seed ? cfg->seed : 0x9E3779B97F4A7C15ull;   // xorshift : état non nul
+    if (cfg->arrival == SYNTH_ARRIVAL_BURSTY) {
+        c->on        = true;
+        c->phase_end = rng_exp(c, cfg->mean_on);
+    }
+
+    c->src.name  = "synth";
+    c->src.next  = synth_next;
+    c->src.close = synth_close;
+    c->src.ctx   = c;
+    return &c->src;
+}
@@ -0,0 +1,70 @@
+#ifndef MINIOS_SYNTH_H
+#define MINIOS_SYNTH_H
+
+#include <stdint.h>
+#include "workload.h"
+#include "../io/io.h"
+#include "../process/program.h"
+
+/*
+ * Charge synthétique, générée au fil des arrivées (aucun fichier
+ * intermédiaire) et entièrement déterminée par la graine : deux runs de
+ * même configuration produisent exactement les mêmes processus.
+ */
+
+/* Un processus IO-bound a 2 * io_phases + 1 étapes (CPU / IO alternés) */
+#define SYNTH_MAX_IO_PHASES ((PROGRAM_MAX_STEPS - 1) / 2)
+
+typedef enum {
+    SYNTH_ARRIVAL_POISSON = 0,  // inter-arrivées exponentielles, débit rate
+    SYNTH_ARRIVAL_BURSTY        // on/off : rate pendant les rafales, idle_rate entre
+} synth_arrival_t;
+
+typedef enum {
+    SYNTH_DIST_FIXED = 0,       // a
+    SYNTH_DIST_EXPONENTIAL,     // moyenne a
+    SYNTH_DIST_PARETO,          // alpha = a, minimum xm = b (queue lourde)
+    SYNTH_DIST_LOGNORMAL        // exp(N(mu = a, sigma = b))
+} synth_dist_kind_t;
+
+typedef struct synth_dist {
+    synth_dist_kind_t kind;
+    double            a;
+    double            b;
+    double            max;      // troncature (0 = aucune)
+} synth_dist_t;
+
+typedef struct workload_synth_config {
+    uint64_t        seed;
+    long            count;        // processus à générer (0 = pas de limite)
+    int             horizon;      // plus d'arrivée après ce tick (0 = pas de limite)
+
+    /* Arrivées */
+    synth_arrival_t arrival;
+    double          rate;         // arrivées par tick (POISSON, ou rafales)
+    double          idle_rate;    // BURSTY : arrivées par tick hors rafale (>= 0)
+    double          mean_on;      // BURSTY : durée moyenne d'une rafale (ticks)
+    double          mean_off;     // BURSTY : durée moyenne d'un creux (ticks)
+
+    /* Processus */
+    synth_dist_t    cpu;          // ticks de CPU au total (arrondi, >= 1)
+    double          io_mix[IO_DEVICE_COUNT];  // part des processus IO-bound par
+                                              // périphérique, le reste est CPU-bound
+    int             io_phases;    // IO-bound : 1 à io_phases I/O (<= SYNTH_MAX_IO_PHASES), CPU réparti entre
+    synth_dist_t    io;           // durée d'une I/O (ticks, >= 1)
+    synth_dist_t    mem;          // mem_size (octets)
+    double          prio_mix[3];  // poids LOW / MEDIUM / HIGH
+} workload_synth_config_t;
+
+// Défauts : graine 42, 1000 processus, Poisson 0.2/tick, CPU Pareto(1.5, 2)
+// tronqué à 200, 35 % d'IO-bound (DISK / NETWORK / KEYBOARD), I/O
+// log-normales (~5 ticks), mémoire log-normale (~1 Mo, max 16 Mo).
+void workload_synth_default_config(workload_synth_config_t *cfg);
+
+/**
+ * Ouvre le générateur (configuration copiée). NULL (message sur stderr)
+ * si un paramètre est invalide.
+ */
+workload_source_t *workload_synth_open(const workload_synth_config_t *cfg);
+
+#endif // MINIOS_SYNTH_H
@@ -0,0 +1,101 @@
+#include "workload.h"
+#include "../scheduler/scheduler.h"
+#include "../scheduler/admission.h"
+#include "../process/program.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* IO -> SUBMIT + WAIT différé (cf. workload_set_async_io) */
+static bool async_io = false;
+
+void workload_set_async_io(bool on) {
+    async_io = on;
+}
+
+/* Programme de s, converti en I/O asynchrones si demandé */
+static int set_program(PCB *p, const workload_spec_t *s) {
+    if (!async_io || s->burst_count <= 0) {
+        return process_set_program(p, s->bursts, s->burst_count);
+    }
+    int      max  = 2 * s->burst_count;
+    burst_t *conv = malloc((size_t)max * sizeof(*conv));
+    if (!conv) return -1;
+    int n  = program_to_async(s->bursts, s->burst_count, conv, max);
+    int ok = process_set_program(p, conv, n);
+    free(conv);
+    return ok;
+}
+
+/* Lit la prochaine description si besoin. false si plus rien (ou erreur). */
+static bool fill(workload_source_t *src) {
+    if (src->has_ahead) return true;
+    if (src->exhausted) return false;
+
+    int r = src->next(src, &src->ahead);
+    if (r == 1) {
+        src->has_ahead = true;
+        return true;
+    }
+    if (r < 0) {
+        src->failed = true;
+        fprintf(stderr, "[Workload] source '%s' illisible, arret des arrivees\n", src->name);
+    }
+    src->exhausted = true;
+    return false;
+}
+
+/* Les terminés sortent de la simulation : total_processes suit, pour que
+ * scheduler_is_finished et l'admission restent cohérents. */
+static void reap(workload_source_t *src) {
+    PCB *p;
+    while ((p = pcb_queue_give(&global_scheduler.terminated_queue)) != NULL) {
+        global_scheduler.total_processes--;
+        process_destroy(p);
+        src->reaped++;
+    }
+}
+
+int workload_poll(workload_source_t *src, int now) {
+    int created = 0;
+
+    reap(src);
+
+    while (fill(src) && src->ahead.arrival <= now) {
+        const workload_spec_t *s = &src->ahead;
+        src->has_ahead = false;
+
+        PCB *p = process_create(s->priority, 1, s->arrival, s->mem_size);
+        if (!p) {
+            fprintf(stderr, "[Workload] creation impossible (arrivee %d), arret des arrivees\n",
+                    s->arrival);
+            src->exhausted = true;
+            src->failed    = true;
+            return -1;
+        }
+        src->created++;
+
+        // Sans programme, le processus garde un burst de 1 tick
+        int ok = set_program(p, s);
+        admission_submit(p);
+        if (ok != 0) {
+            fprintf(stderr, "[Workload] programme invalide pour P%d, arret des arrivees\n", p->pid);
+            src->exhausted = true;
+            src->failed    = true;
+            return -1;
+        }
+        created++;
+    }
+    return created;
+}
+
+bool workload_pending(workload_source_t *src) {
+    return fill(src);
+}
+
+void workload_close(workload_source_t *src) {
+    if (!src) return;
+
+    reap(src);
+    if (src->close) src->close(src);
+}
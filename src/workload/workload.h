@@ -0,0 +1,68 @@
+#ifndef MINIOS_WORKLOAD_H
+#define MINIOS_WORKLOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "../process/process.h"
+
+/*
+ * Source de charge : fournit des descriptions de processus (arrivée,
+ * priorité, mémoire, programme de rafales) par ordre d'arrivée croissant.
+ * Les PCB ne sont créés qu'à leur arrivée, par workload_poll, appelé à
+ * chaque tick de la boucle de simulation, et libérés dès leur
+ * terminaison : la mémoire reste proportionnelle aux processus vivants,
+ * pas à la taille de la charge. La source doit être seule à créer des
+ * processus pendant la simulation.
+ */
+
+typedef struct workload_spec {
+    int             arrival;
+    ProcessPriority priority;
+    size_t          mem_size;
+    const burst_t  *bursts;       // valide jusqu'au prochain appel de next
+    int             burst_count;
+} workload_spec_t;
+
+typedef struct workload_source workload_source_t;
+
+struct workload_source {
+    /* Fournis par la source */
+    const char *name;
+    /** 1 si out est rempli, 0 si la source est épuisée, -1 si erreur. */
+    int  (*next)(workload_source_t *src, workload_spec_t *out);
+    void (*close)(workload_source_t *src);   // libère ctx
+    void *ctx;
+
+    /* Gérés par workload.c */
+    workload_spec_t ahead;        // prochaine arrivée, déjà lue
+    bool            has_ahead;
+    bool            exhausted;
+    bool            failed;       // arrêtée sur une erreur (lecture, création)
+    long            created;      // PCB créés
+    long            reaped;       // PCB terminés et libérés
+};
+
+/**
+ * Libère les processus terminés, puis crée (process_create +
+ * process_set_program) et soumet à l'admission chaque processus arrivé à
+ * now. Retourne le nombre de créations, ou -1 si la source est illisible
+ * (message sur stderr, plus aucune arrivée ensuite).
+ */
+int workload_poll(workload_source_t *src, int now);
+
+/**
+ * Processus des charges en I/O asynchrones (défaut : non) : chaque IO des
+ * programmes devient un SUBMIT, attendu (WAIT) juste avant l'I/O suivante
+ * ou en fin de programme, pour que le calcul qui suit recouvre l'I/O
+ * (cf. program_to_async). Permet de comparer une même charge en modèle
+ * bloquant et asynchrone.
+ */
+void workload_set_async_io(bool on);
+
+/** true s'il reste des processus à créer. */
+bool workload_pending(workload_source_t *src);
+
+/** Ferme la source et libère les PCB terminés. */
+void workload_close(workload_source_t *src);
+
+#endif // MINIOS_WORKLOAD_H
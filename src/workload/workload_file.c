@@ -0,0 +1,372 @@
+#include "workload_file.h"
+#include "../io/io.h"
+#include "../sync/mutex.h"
+#include "../process/program.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define WF_LINE_MAX  1024
+#define WF_MAX_COLS  32
+
+typedef enum {
+    F_ARRIVAL = 0,
+    F_PRIORITY,
+    F_BURST,
+    F_MEM_SIZE,
+    F_IO_DEVICE,
+    F_IO_DURATION,
+    F_IO_START,
+    F_MUTEX,
+    F_PROGRAM,
+    F_COUNT
+} wf_field_t;
+
+static const char *const field_names[F_COUNT] = {
+    "arrival", "priority", "burst", "mem_size",
+    "io_device", "io_duration", "io_start", "mutex", "program"
+};
+
+typedef struct wf_ctx {
+    FILE   *file;
+    char    path[256];
+    long    line;
+    bool    jsonl;
+    int     cols[WF_MAX_COLS];   // colonne CSV -> wf_field_t (-1 = ignorée)
+    int     ncols;
+    int     last_arrival;
+    bool    warned_order;
+    char    buf[WF_LINE_MAX];
+    burst_t prog[PROGRAM_MAX_STEPS];
+    workload_source_t src;
+} wf_ctx_t;
+
+/* ===================================================================== */
+/* OUTILS                                                                */
+/* ===================================================================== */
+
+static bool same_word(const char *a, const char *b) {
+    while (*a && *b && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return *a == '\0' && *b == '\0';
+}
+
+static char *trim(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *e = s + strlen(s);
+    while (e > s && isspace((unsigned char)e[-1])) e--;
+    *e = '\0';
+    return s;
+}
+
+static int field_of(const char *name) {
+    for (int f = 0; f < F_COUNT; ++f) {
+        if (same_word(name, field_names[f])) return f;
+    }
+    return -1;
+}
+
+static int fail(wf_ctx_t *c, const char *msg, const char *value) {
+    if (value) {
+        fprintf(stderr, "workload: %s:%ld: %s '%s'\n", c->path, c->line, msg, value);
+    } else {
+        fprintf(stderr, "workload: %s:%ld: %s\n", c->path, c->line, msg);
+    }
+    return -1;
+}
+
+/* Valeur absente ou vide */
+static bool empty(const char *v) {
+    return v == NULL || *v == '\0';
+}
+
+static bool to_long(const char *v, long *out) {
+    char *end;
+    long  x = strtol(v, &end, 10);
+    if (end == v || *end != '\0') return false;
+    *out = x;
+    return true;
+}
+
+/* Ligne suivante non vide et hors commentaire, sans le '\n'. NULL en fin. */
+static char *read_line(wf_ctx_t *c, bool *too_long) {
+    *too_long = false;
+    while (fgets(c->buf, sizeof(c->buf), c->file)) {
+        c->line++;
+        size_t len = strlen(c->buf);
+        if (len == sizeof(c->buf) - 1 && c->buf[len - 1] != '\n' && !feof(c->file)) {
+            *too_long = true;
+            return NULL;
+        }
+        char *s = trim(c->buf);
+        if (*s == '\0' || *s == '#') continue;
+        return s;
+    }
+    return NULL;
+}
+
+/* ===================================================================== */
+/* DÉCOUPAGE DES LIGNES                                                  */
+/* ===================================================================== */
+
+/* Champs séparés par ',' ; un champ entre guillemets peut en contenir
+ * (programme : "CPU(2) IO(DISK,3)") */
+static int split_csv(wf_ctx_t *c, char *s, const char *val[F_COUNT]) {
+    for (int col = 0; s != NULL; ++col) {
+        char *field = s;
+        while (isspace((unsigned char)*field)) field++;
+
+        char *rest   = s;
+        bool  quoted = *field == '"';
+        if (quoted) {
+            char *close = strchr(++field, '"');
+            if (!close) return fail(c, "guillemet non ferme", NULL);
+            *close = '\0';
+            rest   = close + 1;
+        }
+        char *comma = strchr(rest, ',');
+        if (comma) *comma = '\0';
+
+        if (col >= c->ncols) return fail(c, "trop de colonnes", NULL);
+        if (c->cols[col] >= 0) val[c->cols[col]] = quoted ? field : trim(field);
+
+        s = comma ? comma + 1 : NULL;
+    }
+    return 0;
+}
+
+/* Chaîne JSON à partir de *pp (sur le '"'), terminée sur place */
+static char *json_string(char **pp) {
+    char *s = *pp + 1, *out = s, *p = s;
+    while (*p && *p != '"') {
+        if (*p == '\\' && p[1]) p++;
+        *out++ = *p++;
+    }
+    if (*p != '"') return NULL;
+    *pp = p + 1;
+    *out = '\0';
+    return s;
+}
+
+static char *skip_ws(char *p) {
+    while (isspace((unsigned char)*p)) p++;
+    return p;
+}
+
+/* Objet plat {"clé": valeur, ...} : chaînes, nombres, null */
+static int split_json(wf_ctx_t *c, char *p, const char *val[F_COUNT]) {
+    p = skip_ws(p);
+    if (*p++ != '{') return fail(c, "objet JSON attendu", NULL);
+
+    p = skip_ws(p);
+    if (*p == '}') return 0;
+
+    for (;;) {
+        if (*p != '"') return fail(c, "cle JSON attendue", NULL);
+        char *key = json_string(&p);
+        if (!key) return fail(c, "chaine JSON non terminee", NULL);
+
+        p = skip_ws(p);
+        if (*p++ != ':') return fail(c, "':' attendu apres", key);
+        p = skip_ws(p);
+
+        char *value;
+        if (*p == '"') {
+            value = json_string(&p);
+            if (!value) return fail(c, "chaine JSON non terminee", NULL);
+        } else if (*p == '{' || *p == '[') {
+            return fail(c, "valeur composee non supportee pour", key);
+        } else {
+            value = p;
+            while (*p && *p != ',' && *p != '}' && !isspace((unsigned char)*p)) p++;
+        }
+
+        char *end = skip_ws(p);
+        char  sep = *end;
+        *p = '\0';                       // termine un nombre / littéral
+        if (sep != ',' && sep != '}') return fail(c, "',' ou '}' attendu apres", key);
+
+        int f = field_of(key);
+        if (f >= 0) val[f] = (strcmp(value, "null") == 0) ? NULL : value;
+
+        p = skip_ws(end + 1);
+        if (sep == '}') break;
+    }
+    if (*p != '\0') return fail(c, "texte apres l'objet JSON", NULL);
+    return 0;
+}
+
+/* ===================================================================== */
+/* CONVERSION EN DESCRIPTION DE PROCESSUS                                */
+/* ===================================================================== */
+
+static int to_spec(wf_ctx_t *c, const char *val[F_COUNT], workload_spec_t *out) {
+    long arrival = 0, burst = 0, io_dur = 0, io_start = 0, mutex = -1;
+    long prio = PRIORITY_MEDIUM;
+    int  dev  = -1;
+    unsigned long long mem = 0;
+
+    if (!empty(val[F_ARRIVAL]) && (!to_long(val[F_ARRIVAL], &arrival) || arrival < 0))
+        return fail(c, "arrival invalide", val[F_ARRIVAL]);
+
+    bool programmed = !empty(val[F_PROGRAM]);
+    if (!programmed && (empty(val[F_BURST]) || !to_long(val[F_BURST], &burst) || burst <= 0))
+        return fail(c, "burst invalide", val[F_BURST] ? val[F_BURST] : "");
+
+    const char *v = val[F_PRIORITY];
+    if (!empty(v)) {
+        if      (same_word(v, "LOW"))    prio = PRIORITY_LOW;
+        else if (same_word(v, "MEDIUM")) prio = PRIORITY_MEDIUM;
+        else if (same_word(v, "HIGH"))   prio = PRIORITY_HIGH;
+        else if (!to_long(v, &prio) || prio < PRIORITY_LOW || prio > PRIORITY_HIGH)
+            return fail(c, "priority invalide", v);
+    }
+
+    v = val[F_MEM_SIZE];
+    if (!empty(v)) {
+        char *end;
+        mem = strtoull(v, &end, 10);
+        if (end == v || *end != '\0' || *v == '-') return fail(c, "mem_size invalide", v);
+    }
+
+    v = val[F_IO_DEVICE];
+    if (!empty(v) && !same_word(v, "none") && strcmp(v, "-1") != 0) {
+        long d;
+        dev = to_long(v, &d) ? (int)d : io_device_from_str(v);
+        if (dev < 0 || dev >= IO_DEVICE_COUNT) return fail(c, "io_device inconnu", v);
+
+        if (empty(val[F_IO_DURATION]) || !to_long(val[F_IO_DURATION], &io_dur) || io_dur <= 0)
+            return fail(c, "io_duration invalide", val[F_IO_DURATION] ? val[F_IO_DURATION] : "");
+        if (!empty(val[F_IO_START]) && (!to_long(val[F_IO_START], &io_start) || io_start < 0))
+            return fail(c, "io_start invalide", val[F_IO_START]);
+    }
+
+    v = val[F_MUTEX];
+    if (!empty(v) && (!to_long(v, &mutex) || (mutex != -1 && !mutex_shared((int)mutex))))
+        return fail(c, "mutex invalide", v);
+
+    /* Les arrivées doivent croître : lecture en flux, pas de tri possible */
+    if (arrival < c->last_arrival) {
+        if (!c->warned_order) {
+            fprintf(stderr, "workload: %s:%ld: arrivees non triees, ramenees a %d\n",
+                    c->path, c->line, c->last_arrival);
+            c->warned_order = true;
+        }
+        arrival = c->last_arrival;
+    }
+    c->last_arrival = (int)arrival;
+
+    /* Programme explicite, ou : [LOCK] CPU(io_start) IO CPU(reste) [UNLOCK] */
+    int n = 0;
+    if (programmed) {
+        const char *err;
+        n = program_parse(val[F_PROGRAM], c->prog, PROGRAM_MAX_STEPS, &err);
+        if (n < 0) return fail(c, err, val[F_PROGRAM]);
+        if (!empty(val[F_BURST]) || dev >= 0 || mutex >= 0)
+            return fail(c, "program exclut burst / io_* / mutex", NULL);
+    } else {
+        // Au plus 5 étapes : le tableau (PROGRAM_MAX_STEPS) suffit toujours
+        if (mutex >= 0) c->prog[n++] = (burst_t){ .kind = BURST_LOCK, .arg = (int)mutex };
+        if (dev >= 0) {
+            if (io_start > burst - 1) io_start = burst - 1;   // l'I/O précède la fin
+            c->prog[n++] = (burst_t){ .kind = BURST_CPU, .duration = (int)io_start };
+            c->prog[n++] = (burst_t){ .kind = BURST_IO, .arg = dev, .duration = (int)io_dur };
+            c->prog[n++] = (burst_t){ .kind = BURST_CPU, .duration = (int)(burst - io_start) };
+        } else {
+            c->prog[n++] = (burst_t){ .kind = BURST_CPU, .duration = (int)burst };
+        }
+        if (mutex >= 0) c->prog[n++] = (burst_t){ .kind = BURST_UNLOCK, .arg = (int)mutex };
+    }
+
+    out->arrival     = (int)arrival;
+    out->priority    = (ProcessPriority)prio;
+    out->mem_size    = (size_t)mem;
+    out->bursts      = c->prog;
+    out->burst_count = n;
+    return 0;
+}
+
+/* ===================================================================== */
+/* SOURCE                                                                */
+/* ===================================================================== */
+
+static int wf_next(workload_source_t *src, workload_spec_t *out) {
+    wf_ctx_t *c = src->ctx;
+    bool      too_long;
+
+    char *s = read_line(c, &too_long);
+    if (too_long) return fail(c, "ligne trop longue", NULL);
+    if (!s) return ferror(c->file) ? fail(c, "erreur de lecture", NULL) : 0;
+
+    const char *val[F_COUNT] = { 0 };
+    int r = c->jsonl ? split_json(c, s, val) : split_csv(c, s, val);
+    if (r != 0) return -1;
+
+    return to_spec(c, val, out) == 0 ? 1 : -1;
+}
+
+static void wf_close(workload_source_t *src) {
+    wf_ctx_t *c = src->ctx;
+    fclose(c->file);
+    free(c);
+}
+
+static int read_header(wf_ctx_t *c) {
+    bool  too_long;
+    char *s = read_line(c, &too_long);
+    if (!s) return fail(c, too_long ? "en-tete trop long" : "en-tete CSV manquant", NULL);
+
+    bool has_burst = false;   // burst ou program
+    for (c->ncols = 0; s != NULL; c->ncols++) {
+        char *comma = strchr(s, ',');
+        if (comma) *comma = '\0';
+        if (c->ncols >= WF_MAX_COLS) return fail(c, "trop de colonnes", NULL);
+
+        char *name = trim(s);
+        int   f    = field_of(name);
+        if (f < 0) {
+            fprintf(stderr, "workload: %s: colonne '%s' ignoree\n", c->path, name);
+        }
+        has_burst = has_burst || f == F_BURST || f == F_PROGRAM;
+        c->cols[c->ncols] = f;
+
+        s = comma ? comma + 1 : NULL;
+    }
+    if (!has_burst) return fail(c, "colonne burst (ou program) manquante", NULL);
+    return 0;
+}
+
+workload_source_t *workload_file_open(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+
+    wf_ctx_t *c = calloc(1, sizeof(*c));
+    if (!c) {
+        fclose(f);
+        return NULL;
+    }
+    c->file = f;
+    snprintf(c->path, sizeof(c->path), "%s", path);
+
+    const char *ext = strrchr(path, '.');
+    c->jsonl = ext && (same_word(ext, ".jsonl") || same_word(ext, ".json"));
+
+    if (!c->jsonl && read_header(c) != 0) {
+        fclose(f);
+        free(c);
+        return NULL;
+    }
+
+    c->src.name  = c->path;
+    c->src.next  = wf_next;
+    c->src.close = wf_close;
+    c->src.ctx   = c;
+    return &c->src;
+}
@@ -0,0 +1,47 @@
+#ifndef MINIOS_WORKLOAD_FILE_H
+#define MINIOS_WORKLOAD_FILE_H
+
+#include "workload.h"
+
+/*
+ * Fichier de charge, lu en flux (une ligne à la fois : la taille du
+ * fichier n'a pas d'importance). Un processus par ligne, par arrivée
+ * croissante ; lignes vides et commentaires '#' ignorés.
+ *
+ * CSV (défaut) : une ligne d'en-tête nomme les colonnes, dans un ordre
+ * quelconque (colonnes inconnues ignorées) ; un champ entre guillemets
+ * peut contenir des virgules :
+ *
+ *   arrival,priority,burst,mem_size,io_device,io_duration,io_start,mutex,program
+ *   0,HIGH,12,4096,DISK,3,4,,
+ *   1,LOW,,0,,,,,"CPU(2) IO(DISK,3) ALLOC(64K) CPU(4) FREE"
+ *
+ * JSON Lines (.jsonl / .json) : un objet plat par ligne, mêmes clés :
+ *
+ *   {"arrival":0,"priority":"HIGH","burst":12,"io_device":"DISK","io_duration":3}
+ *
+ * Champs (burst, ou program, est obligatoire) :
+ *   arrival      tick d'arrivée (0)
+ *   priority     0-2 ou LOW / MEDIUM / HIGH (MEDIUM)
+ *   burst        ticks de CPU (> 0)
+ *   mem_size     octets de la zone principale (0)
+ *   io_device    nom (DISK...) ou code io_device_t ; vide / none = pas d'I/O
+ *   io_duration  ticks d'I/O (> 0 si io_device)
+ *   io_start     ticks de CPU effectués avant l'I/O (0, au plus burst - 1) :
+ *                l'I/O suit la progression du processus, pas l'horloge
+ *                globale
+ *   mutex        n° de mutex partagé (mutex_shared) tenu pendant toute
+ *                l'exécution ; vide / -1 = aucun
+ *   program      programme complet (syntaxe de program.h), à la place de
+ *                burst / io_* / mutex : plusieurs phases CPU / I/O, mutex,
+ *                allocations
+ */
+
+/**
+ * Ouvre un fichier de charge. NULL (message sur stderr) si le fichier est
+ * absent ou son en-tête invalide ; une ligne invalide arrête la lecture
+ * (workload_poll rend -1).
+ */
+workload_source_t *workload_file_open(const char *path);
+
+#endif // MINIOS_WORKLOAD_FILE_H
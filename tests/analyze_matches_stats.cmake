@@ -0,0 +1,67 @@
+# Le résumé de minios_trace_analyze doit retrouver les compteurs du
+# simulateur (--stats) : changements de contexte, turnaround et réponse
+# moyens, processus terminés.
+#
+#   cmake -DMINIOS=... -DANALYZE=... -DWORKLOAD=... -DOUT=... -P analyze_matches_stats.cmake
+
+file(MAKE_DIRECTORY ${OUT})
+
+# Préemption au tick de l'élection (priority), quantum et plusieurs CPU
+# (prr), pression mémoire (heap réduit : créations en échec, rejets)
+set(runs
+        "priority --workload ${WORKLOAD}"
+        "prr --workload ${WORKLOAD} --policy prr --cpus 2"
+        "rr --synth 1 --count 300 --policy rr --cpus 3"
+        "heap --synth 5 --count 300 --heap 2M"
+        "rejects --synth 7 --count 500 --heap 4M --policy prr")
+
+foreach (run ${runs})
+    separate_arguments(run UNIX_COMMAND "${run}")
+    list(GET run 0 name)
+    list(REMOVE_AT run 0)
+    file(REMOVE ${OUT}/${name}.stats.csv)          # --stats ajoute au fichier
+
+    execute_process(
+            COMMAND ${MINIOS} ${run} --trace ${OUT}/${name}.csv
+                    --stats ${OUT}/${name}.stats.csv --quiet
+            RESULT_VARIABLE rc OUTPUT_QUIET)
+    if (NOT rc EQUAL 0)
+        message(FATAL_ERROR "${name} : simulation, code ${rc}")
+    endif ()
+    execute_process(
+            COMMAND ${ANALYZE} ${OUT}/${name}.csv -o ${OUT}/${name}.analyze
+            RESULT_VARIABLE rc OUTPUT_VARIABLE summary)
+    if (NOT rc EQUAL 0)
+        message(FATAL_ERROR "${name} : analyse, code ${rc}")
+    endif ()
+
+    # finished, context_switches, avg_turnaround, avg_response du bilan
+    file(STRINGS ${OUT}/${name}.stats.csv lines)
+    list(GET lines 1 row)
+    string(REPLACE "," ";" row "${row}")
+    list(GET row 7 finished)
+    list(GET row 8 switches)
+    list(GET row 10 turnaround)
+    list(GET row 11 response)
+
+    string(REGEX MATCH "Processus *: [0-9]+ \\(([0-9]+) " _ "${summary}")
+    set(a_finished ${CMAKE_MATCH_1})
+    string(REGEX MATCH "contexte *: ([0-9]+)" _ "${summary}")
+    set(a_switches ${CMAKE_MATCH_1})
+    string(REGEX MATCH "Turnaround moyen *: ([0-9.]+)" _ "${summary}")
+    set(a_turnaround ${CMAKE_MATCH_1})
+    string(REGEX MATCH "ponse moyenne *: ([0-9.]+)" _ "${summary}")
+    set(a_response ${CMAKE_MATCH_1})
+
+    # Mêmes processus pour les deux moyennes : la réponse ne peut pas
+    # dépasser le turnaround
+    if (response GREATER turnaround)
+        message(FATAL_ERROR "${name} : avg_response ${response} > avg_turnaround ${turnaround}")
+    endif ()
+
+    foreach (v finished switches turnaround response)
+        if (NOT "${${v}}" STREQUAL "${a_${v}}")
+            message(FATAL_ERROR "${name} : ${v} = ${a_${v}} (analyse) au lieu de ${${v}} (--stats)")
+        endif ()
+    endforeach ()
+endforeach ()
@@ -0,0 +1,34 @@
+# Enregistre la trace d'une charge puis la rejoue : le rejeu doit aller au
+# bout (code 0) et recréer autant de processus.
+#
+#   cmake -DMINIOS=... -DWORKLOAD=... -DOUT=... -P replay_roundtrip.cmake
+
+file(MAKE_DIRECTORY ${OUT})
+file(REMOVE ${OUT}/recorded.stats.csv ${OUT}/replayed.stats.csv)   # --stats ajoute au fichier
+
+execute_process(
+        COMMAND ${MINIOS} --workload ${WORKLOAD} --trace ${OUT}/recorded.csv
+                --stats ${OUT}/recorded.stats.csv --quiet --no-viz
+        RESULT_VARIABLE rc OUTPUT_QUIET)
+if (NOT rc EQUAL 0)
+    message(FATAL_ERROR "enregistrement : code ${rc}")
+endif ()
+
+execute_process(
+        COMMAND ${MINIOS} --replay ${OUT}/recorded.csv --trace ${OUT}/replayed.csv
+                --stats ${OUT}/replayed.stats.csv --quiet --no-viz
+        RESULT_VARIABLE rc OUTPUT_QUIET ERROR_VARIABLE err)
+if (NOT rc EQUAL 0)
+    message(FATAL_ERROR "rejeu : code ${rc}\n${err}")
+endif ()
+
+# Colonne processes (7e) des deux bilans
+foreach (run recorded replayed)
+    file(STRINGS ${OUT}/${run}.stats.csv lines)
+    list(GET lines 1 row)
+    string(REPLACE "," ";" row "${row}")
+    list(GET row 6 ${run}_processes)
+endforeach ()
+if (NOT recorded_processes EQUAL replayed_processes)
+    message(FATAL_ERROR "rejeu : ${replayed_processes} processus au lieu de ${recorded_processes}")
+endif ()
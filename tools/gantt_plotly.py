@@ -3,13 +3,19 @@ import numpy as np
 import plotly.graph_objects as go
 from plotly.subplots import make_subplots
 import sys  # <--- Ajouté pour récupérer l'argument du C
+import os
 
 # ==========================================================
 # 1. CHARGEMENT ET PRÉPARATION
 # ==========================================================
 def load_trace(csv_file):
     try:
-        df = pd.read_csv(csv_file)
+        if csv_file.endswith(".csv"):
+            df = pd.read_csv(csv_file)
+        else:
+            # .mtrace / .ctrace : lecture incrémentale, sans passer par un CSV
+            from parse_trace import load_dataframe
+            df = load_dataframe(csv_file)
     except FileNotFoundError:
         print(f"Erreur : Le fichier {csv_file} est introuvable.")
         sys.exit(1)
@@ -126,26 +132,73 @@ def compute_detailed_stats(df_intervals):
     return pd.DataFrame(stats).T.sort_index(), total_ctx_switches
 
 # ==========================================================
-# 3. VISUALISATION (v17 - Légende Compacte & Rapprochée)
+# 2 bis. RÉSULTATS DE minios_trace_analyze (si disponibles)
 # ==========================================================
-def plot_minios_dashboard(csv_file):
-    print(f"Génération du graphique pour : {csv_file} ...")
-    raw_df = load_trace(csv_file)
-
-    # Sécurisation si le DF est vide après chargement
-    if raw_df.empty:
-        print("Aucune donnée à afficher.")
-        return
+STATS_LABELS = {"execution": "Exécution", "attente": "Attente", "blocage": "Blocage",
+                "reponse": "T. Réponse", "turnaround": "Turnaround"}
 
-    df_intervals = process_intervals(raw_df)
+def load_analysis(trace_file):
+    """Intervalles / stats / mémoire pré-calculés par minios_trace_analyze.
 
-    if df_intervals.empty:
-        print("Aucun intervalle de temps valide trouvé.")
-        return
+    Utilisés seulement s'ils sont plus récents que la trace ; sinon None et
+    le calcul se fait ici avec pandas.
+    """
+    prefix = os.path.splitext(trace_file)[0]
+    paths = [f"{prefix}.{kind}.csv" for kind in ("intervals", "stats", "memory")]
+    try:
+        if any(os.path.getmtime(p) < os.path.getmtime(trace_file) for p in paths):
+            return None
+    except OSError:
+        return None
+
+    df_intervals = pd.read_csv(paths[0], keep_default_na=False)
+    stats = pd.read_csv(paths[1]).set_index("pid").sort_index()  # ordre des terminaisons
+    total_switches = int(stats["switches"].sum())
+    stats_df = stats.rename(columns=STATS_LABELS)[list(STATS_LABELS.values())]
+    mem = pd.read_csv(paths[2])
+    print(f"Analyse native utilisée : {prefix}.{{intervals,stats,memory}}.csv")
+    return df_intervals, stats_df, total_switches, mem
+
+def memory_curve_from_points(mem, max_time):
+    """Courbe de compute_memory_curve à partir des points (time, bytes)."""
+    timeline_x = np.arange(int(max_time) + 2)
+    timeline_y = np.zeros(len(timeline_x))
+    for t, b in zip(mem["time"], mem["bytes"]):
+        if t < len(timeline_y):
+            timeline_y[int(t):] = b
+    return timeline_x, timeline_y
 
-    max_time = df_intervals['end'].max()
-    stats_df, total_switches = compute_detailed_stats(df_intervals)
-    mem_x, mem_y = compute_memory_curve(raw_df, max_time)
+# ==========================================================
+# 3. VISUALISATION (v17 - Légende Compacte & Rapprochée)
+# ==========================================================
+def plot_minios_dashboard(csv_file):
+    print(f"Génération du graphique pour : {csv_file} ...")
+    analysis = load_analysis(csv_file)
+
+    if analysis is not None:
+        df_intervals, stats_df, total_switches, mem = analysis
+        if df_intervals.empty:
+            print("Aucun intervalle de temps valide trouvé.")
+            return
+        max_time = df_intervals['end'].max()
+        mem_x, mem_y = memory_curve_from_points(mem, max_time)
+    else:
+        raw_df = load_trace(csv_file)
+
+        # Sécurisation si le DF est vide après chargement
+        if raw_df.empty:
+            print("Aucune donnée à afficher.")
+            return
+
+        df_intervals = process_intervals(raw_df)
+
+        if df_intervals.empty:
+            print("Aucun intervalle de temps valide trouvé.")
+            return
+
+        max_time = df_intervals['end'].max()
+        stats_df, total_switches = compute_detailed_stats(df_intervals)
+        mem_x, mem_y = compute_memory_curve(raw_df, max_time)
 
     sorted_pids = sorted(df_intervals['pid'].unique())
     y_labels_gantt = [f"PID {p}" for p in sorted_pids]
@@ -0,0 +1,218 @@
+"""
+Lecture des traces miniOS, quel que soit le format :
+  - .csv    : time,pid,event,state,reason,cpu,queue
+  - .mtrace : enregistrements fixes de 24 octets (format binaire v2)
+  - .ctrace : blocs delta/varint, zlib en option (format compact v1)
+
+La lecture est incrémentale : iter_events() ne charge qu'un bloc à la fois,
+ce qui permet de parcourir des traces plus grosses que la mémoire.
+Voir src/trace/trace_format.h pour la description des formats.
+
+Usage :
+    python3 parse_trace.py trace.ctrace [trace.csv]   # conversion vers CSV
+"""
+
+import csv
+import struct
+import sys
+import zlib
+
+COLUMNS = ["time", "pid", "event", "state", "reason", "cpu", "queue"]
+
+BIN_MAGIC = b"MTRC"
+CZ_MAGIC = b"MTRZ"
+ENDIAN_TAG = 0x0102
+
+RS_VALUE = 1            # reason = payload numérique (trace_event_types.h)
+CZ_FLAG_ZLIB = 0x0001
+CZ_BLOCK_MAGIC = 0x4B4C424D
+CZ_TUPLE_MAX = 255
+
+HEADER = struct.Struct("<4sHHHHI")           # 16 octets
+RECORD = struct.Struct("<iihBBBBHq")          # trace_rec_t, 24 octets
+BLOCK = struct.Struct("<IIIIii")              # en-tête de bloc, 24 octets
+
+
+# ==========================================================
+# OUTILS
+# ==========================================================
+def _read_table(f, size):
+    """Table des libellés -> [event, state, reason, queue] : {code: texte}."""
+    data = f.read(size)
+    if len(data) != size:
+        raise ValueError("table des libellés tronquée")
+    names = [{}, {}, {}, {}]
+    pos = 0
+    while pos + 3 <= size:
+        dom, code, length = data[pos], data[pos + 1], data[pos + 2]
+        pos += 3
+        names[dom][code] = data[pos:pos + length].decode("utf-8", "replace")
+        pos += length
+    return names
+
+
+def _varint(buf, pos):
+    value, shift = 0, 0
+    while True:
+        c = buf[pos]
+        pos += 1
+        value |= (c & 0x7F) << shift
+        if not c & 0x80:
+            return value, pos
+        shift += 7
+
+
+def _unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def _label(names, dom, code):
+    return names[dom].get(code, "")
+
+
+def _row(names, time, pid, event, state, reason, cpu, queue, arg):
+    return (time, pid,
+            _label(names, 0, event),
+            _label(names, 1, state),
+            str(arg) if reason == RS_VALUE else _label(names, 2, reason),
+            cpu,
+            _label(names, 3, queue))
+
+
+# ==========================================================
+# FORMATS
+# ==========================================================
+def _iter_csv(path):
+    with open(path, newline="") as f:
+        reader = csv.reader(f)
+        next(reader, None)                    # en-tête
+        for r in reader:
+            if len(r) < 7:
+                continue
+            yield (int(r[0]), int(r[1]), r[2], r[3], r[4], int(r[5]), r[6])
+
+
+def _iter_mtrace(f, header, start_time):
+    _, version, _, record_size, _, table_bytes = header
+    if version != 2 or record_size != RECORD.size:
+        raise ValueError(f"trace binaire v{version} non supportée")
+    names = _read_table(f, table_bytes)
+
+    chunk = RECORD.size * 4096
+    while True:
+        data = f.read(chunk)
+        if not data:
+            return
+        for rec in RECORD.iter_unpack(data[:len(data) - len(data) % RECORD.size]):
+            time, pid, cpu, ev, st, rs, q, _, arg = rec
+            if time >= start_time:
+                yield _row(names, time, pid, ev, st, rs, cpu, q, arg)
+
+
+def _iter_ctrace(f, header, start_time):
+    _, version, _, _, flags, table_bytes = header
+    if version != 1:
+        raise ValueError(f"trace compacte v{version} non supportée")
+    names = _read_table(f, table_bytes)
+
+    while True:
+        raw_header = f.read(BLOCK.size)
+        if len(raw_header) < BLOCK.size:
+            return
+        magic, stored, raw_bytes, count, first_time, last_time = BLOCK.unpack(raw_header)
+        if magic != CZ_BLOCK_MAGIC:
+            raise ValueError("bloc corrompu")
+
+        # Point de synchronisation : bloc entièrement avant start_time
+        if last_time < start_time:
+            f.seek(stored, 1)
+            continue
+
+        payload = f.read(stored)
+        if flags & CZ_FLAG_ZLIB:
+            payload = zlib.decompress(payload)
+
+        tuples = []
+        pos, time = 0, first_time
+        for _ in range(count):
+            idx, pos = _varint(payload, pos)
+            if idx < len(tuples):
+                tup = tuples[idx]
+            else:
+                ev, st, rs, q = payload[pos:pos + 4]
+                cpu, pos = _varint(payload, pos + 4)
+                tup = (ev, st, rs, q, _unzigzag(cpu), payload[pos])
+                pos += 1
+                if len(tuples) < CZ_TUPLE_MAX:
+                    tuples.append(tup)
+
+            dt, pos = _varint(payload, pos)
+            time += _unzigzag(dt)
+            pid, pos = _varint(payload, pos)
+            arg = 0
+            if tup[5]:
+                arg, pos = _varint(payload, pos)
+                arg = _unzigzag(arg)
+
+            if time >= start_time:
+                ev, st, rs, q, cpu, _ = tup
+                yield _row(names, time, _unzigzag(pid), ev, st, rs, cpu, q, arg)
+
+
+# ==========================================================
+# API
+# ==========================================================
+def iter_events(path, start_time=None):
+    """Itère sur les événements (tuples dans l'ordre de COLUMNS).
+
+    start_time : ignore les événements antérieurs ; pour .ctrace, les blocs
+    entièrement antérieurs ne sont même pas lus.
+    """
+    lo = start_time if start_time is not None else -(1 << 31)
+
+    with open(path, "rb") as f:
+        magic = f.read(4)
+
+    if magic not in (BIN_MAGIC, CZ_MAGIC):
+        for ev in _iter_csv(path):
+            if ev[0] >= lo:
+                yield ev
+        return
+
+    with open(path, "rb") as f:
+        header = HEADER.unpack(f.read(HEADER.size))
+        if header[2] != ENDIAN_TAG:
+            raise ValueError("trace écrite sur un hôte d'endianness différente")
+        if magic == BIN_MAGIC:
+            yield from _iter_mtrace(f, header, lo)
+        else:
+            yield from _iter_ctrace(f, header, lo)
+
+
+def load_dataframe(path, start_time=None):
+    """Trace complète dans un DataFrame pandas (mêmes colonnes que le CSV)."""
+    import pandas as pd
+    return pd.DataFrame.from_records(iter_events(path, start_time), columns=COLUMNS)
+
+
+def to_csv(path, out):
+    writer = csv.writer(out, lineterminator="\n")
+    writer.writerow(COLUMNS)
+    n = 0
+    for ev in iter_events(path):
+        writer.writerow(ev)
+        n += 1
+    return n
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print(__doc__.strip().splitlines()[-1].strip())
+        sys.exit(1)
+
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], "w", newline="") as out:
+            n = to_csv(sys.argv[1], out)
+    else:
+        n = to_csv(sys.argv[1], sys.stdout)
+    print(f"{n} evenements", file=sys.stderr)
@@ -0,0 +1,39 @@
+/*
+ * Conversion d'une trace miniOS (.mtrace / .ctrace / .csv) vers le JSON
+ * Chrome Trace Event : à ouvrir dans ui.perfetto.dev ou chrome://tracing
+ * (une piste par CPU et par processus, flèches de réveil).
+ *
+ * Usage :
+ *   minios_trace2chrome trace.mtrace|trace.ctrace|trace.csv [trace.json]
+ *
+ * Sans second argument, le JSON part sur la sortie standard. La simulation
+ * peut aussi écrire ce format directement : trace_init("trace.json").
+ */
+
+#include <stdio.h>
+
+#include "../src/trace/trace_reader.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Usage : %s trace.mtrace|trace.ctrace|trace.csv [trace.json]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+
+    long n = trace_convert_to_chrome(argv[1], out);
+
+    if (out != stdout) fclose(out);
+    if (n < 0) return 2;
+
+    fprintf(stderr, "%ld evenements convertis\n", n);
+    return 0;
+}
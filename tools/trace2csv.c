@@ -0,0 +1,37 @@
+/*
+ * Conversion d'une trace binaire miniOS (.mtrace / .ctrace) vers le CSV habituel,
+ * pour les scripts Python (gantt_plotly.py, stats.py...).
+ *
+ * Usage :
+ *   minios_trace2csv trace.mtrace|trace.ctrace [trace.csv]
+ *
+ * Sans second argument, le CSV part sur la sortie standard.
+ */
+
+#include <stdio.h>
+
+#include "../src/trace/trace_reader.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Usage : %s trace.mtrace|trace.ctrace [trace.csv]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+
+    long n = trace_convert_to_csv(argv[1], out);
+
+    if (out != stdout) fclose(out);
+    if (n < 0) return 2;
+
+    fprintf(stderr, "%ld evenements convertis\n", n);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Analyse d'une trace miniOS (.csv / .mtrace / .ctrace) en un seul passage,
+ * en mémoire proportionnelle au nombre de processus vivants à la fois :
+ *  - <prefixe>.intervals.csv : pid,state,start,end,duration,reason (Gantt)
+ *  - <prefixe>.stats.csv     : cumuls par processus
+ *  - <prefixe>.memory.csv    : time,bytes du heap simulé
+ *  - résumé sur la sortie standard
+ *
+ * gantt_plotly.py relit ces fichiers s'ils sont plus récents que la trace,
+ * et n'a plus qu'à dessiner.
+ *
+ * Usage :
+ *   minios_trace_analyze trace.csv|trace.mtrace|trace.ctrace [-o prefixe]
+ *
+ * Préfixe par défaut : le chemin de la trace sans son extension.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/trace/trace_reader.h"
+#include "../src/trace/trace_analysis.h"
+
+static FILE *open_output(const char *prefix, const char *suffix) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s.%s.csv", prefix, suffix);
+    FILE *f = fopen(path, "w");
+    if (!f) perror(path);
+    return f;
+}
+
+int main(int argc, char **argv) {
+    const char *trace  = NULL;
+    const char *prefix = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            prefix = argv[++i];
+        } else if (!trace) {
+            trace = argv[i];
+        } else {
+            trace = NULL;
+            break;
+        }
+    }
+    if (!trace) {
+        fprintf(stderr, "Usage : %s trace.csv|trace.mtrace|trace.ctrace [-o prefixe]\n", argv[0]);
+        return 1;
+    }
+
+    char base[1024];
+    if (!prefix) {
+        snprintf(base, sizeof(base), "%s", trace);
+        char *dot   = strrchr(base, '.');
+        char *slash = strrchr(base, '/');
+        if (dot && (!slash || dot > slash)) *dot = '\0';
+        prefix = base;
+    }
+
+    trace_reader_t *r = trace_reader_open(trace);
+    if (!r) return 2;
+
+    FILE *intervals = open_output(prefix, "intervals");
+    FILE *memory    = open_output(prefix, "memory");
+    FILE *stats     = open_output(prefix, "stats");
+    trace_analyzer_t *a = (intervals && memory && stats)
+                        ? trace_analyzer_create(intervals, memory, stats) : NULL;
+    if (!a) {
+        if (intervals) fclose(intervals);
+        if (memory)    fclose(memory);
+        if (stats)     fclose(stats);
+        trace_reader_close(r);
+        return 2;
+    }
+
+    trace_entry_t e;
+    int rc;
+    while ((rc = trace_reader_next(r, &e)) == 1) {
+        trace_analyzer_put(a, &e.rec);
+    }
+    trace_reader_close(r);
+
+    trace_summary_t s;
+    trace_analyzer_finish(a, &s);
+    trace_analyzer_free(a);
+    fclose(intervals);
+    fclose(memory);
+    fclose(stats);
+
+    if (rc < 0) {
+        fprintf(stderr, "%s : trace tronquée après %ld événements\n", trace, s.events);
+        return 2;
+    }
+
+    printf("=== ANALYSE %s ===\n", trace);
+    printf("Événements          : %ld (%ld intervalles)\n", s.events, s.intervals);
+    printf("Processus           : %d (%d terminés, %d OOM kills)\n",
+           s.processes, s.terminated, s.oom_kills);
+    printf("Durée totale        : %d ticks, %d CPU\n", s.makespan, s.cpus);
+    printf("Utilisation CPU     : %.1f %%\n", 100.0 * s.cpu_util);
+    printf("Changements contexte: %ld\n", s.switches);
+    printf("Turnaround moyen    : %.2f\n", s.avg_turnaround);
+    printf("Réponse moyenne     : %.2f\n", s.avg_response);
+    printf("Attente READY moy.  : %.2f\n", s.avg_ready);
+    printf("Pic mémoire         : %lld octets\n", (long long)s.heap_peak);
+    printf("Sorties             : %s.{intervals,stats,memory}.csv\n", prefix);
+    return 0;
+}